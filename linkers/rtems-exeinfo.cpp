@@ -30,22 +30,31 @@
 #include "config.h"
 #endif
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 
 #include <cxxabi.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
 #include <getopt.h>
 
+#if HAVE_PTHREAD_CREATE
+#include <pthread.h>
+#endif
+
 #include <rld.h>
 #include <rld-buffer.h>
 #include <rld-files.h>
 #include <rld-process.h>
 #include <rld-rtems.h>
+#include <rld-symbolizer.h>
+#include <rld-symindex.h>
 
 #ifndef HAVE_KILL
 #define kill(p,s) raise(s)
@@ -368,6 +377,733 @@ namespace rld
 
       std::cout << std::endl;
     }
+
+    /**
+     * Symbolize the addresses read from stdin, one per line, writing the
+     * address and the symbol plus offset to stdout. The ELF symbol tables are
+     * read directly so the symbols are not loaded into a symbols table.
+     */
+    void
+    symbolize (const std::string& exe_name)
+    {
+      files::object exe (exe_name);
+
+      exe.open ();
+      exe.begin ();
+
+      if (!exe.valid ())
+        throw rld::error ("Not valid: " + exe.name ().full (),
+                          "exeinfo::symbolize");
+
+      symbolizer::symbolizer syms;
+
+      syms.load (exe.elf ());
+
+      if (rld::verbose () >= RLD_VERBOSE_DETAILS)
+        syms.output (std::cout);
+
+      /*
+       * Use stdio with large buffers, the iostreams are too slow. Flush each
+       * line if the input is a terminal.
+       */
+      static char in_buf[64 * 1024];
+      static char out_buf[64 * 1024];
+
+      ::setvbuf (stdin, in_buf, _IOFBF, sizeof (in_buf));
+      ::setvbuf (stdout, out_buf, _IOFBF, sizeof (out_buf));
+
+      const bool interactive = ::isatty (::fileno (stdin));
+
+      char                  line[256];
+      symbolizer::location  loc;
+
+      while (::fgets (line, sizeof (line), stdin))
+      {
+        char*              end = 0;
+        unsigned long long addr = ::strtoull (line, &end, 16);
+
+        if (end == line)
+        {
+          size_t len = ::strlen (line);
+          while ((len > 0) && ((line[len - 1] == '\n') || (line[len - 1] == '\r')))
+            line[--len] = '\0';
+          ::printf ("%s ??\n", line);
+        }
+        else if (syms.lookup (addr, loc))
+        {
+          if (loc.offset)
+            ::printf ("0x%08llx %s+0x%llx\n",
+                      addr, loc.name, (unsigned long long) loc.offset);
+          else
+            ::printf ("0x%08llx %s\n", addr, loc.name);
+        }
+        else
+        {
+          ::printf ("0x%08llx ??\n", addr);
+        }
+
+        if (interactive)
+          ::fflush (stdout);
+      }
+
+      ::fflush (stdout);
+
+      exe.end ();
+      exe.close ();
+    }
+
+    /**
+     * A named size in an image being compared. The items are held in a hash
+     * table keyed by the name.
+     */
+    struct diff_item
+    {
+      uint32_t name;    //< The offset of the name in the names.
+      uint32_t hash;    //< The hash of the name.
+      uint32_t next;    //< The next item in the hash chain.
+      uint64_t size;    //< The size.
+    };
+
+    /**
+     * A hash table of the sizes of the sections, object files or symbols in
+     * an image. Adding a name more than once adds the sizes.
+     */
+    class diff_table
+    {
+    public:
+      /**
+       * The end of a hash chain.
+       */
+      static const uint32_t end = 0xffffffff;
+
+      diff_table ();
+
+      /**
+       * Add the size to the named item.
+       */
+      void add (const std::string& name, uint64_t size);
+
+      /**
+       * Find an item. Returns 0 if not found.
+       */
+      const diff_item* find (const char* name, uint32_t hash) const;
+
+      /**
+       * The name of an item.
+       */
+      const char* name (const diff_item& item) const;
+
+      /**
+       * The total of the sizes.
+       */
+      uint64_t total () const;
+
+      typedef std::vector < diff_item > items;
+
+      items items_;             //< The items in the order added.
+
+    private:
+
+      /**
+       * Resize the buckets and rehash the items.
+       */
+      void rehash (size_t count);
+
+      std::vector < char >     names;     //< The names.
+      std::vector < uint32_t > buckets;   //< The hash buckets.
+    };
+
+    const uint32_t diff_table::end;
+
+    diff_table::diff_table ()
+    {
+      rehash (1024);
+    }
+
+    void
+    diff_table::rehash (size_t count)
+    {
+      buckets.assign (count, end);
+      for (uint32_t i = 0; i < items_.size (); ++i)
+      {
+        uint32_t b = items_[i].hash % buckets.size ();
+        items_[i].next = buckets[b];
+        buckets[b] = i;
+      }
+    }
+
+    void
+    diff_table::add (const std::string& name_, uint64_t size)
+    {
+      uint32_t h = symindex::hash (name_.c_str ());
+      diff_item* item = const_cast < diff_item* > (find (name_.c_str (), h));
+
+      if (item)
+      {
+        item->size += size;
+        return;
+      }
+
+      if (items_.size () >= buckets.size ())
+        rehash (buckets.size () * 2);
+
+      diff_item ni;
+      uint32_t  b = h % buckets.size ();
+
+      ni.name = names.size ();
+      ni.hash = h;
+      ni.next = buckets[b];
+      ni.size = size;
+
+      names.insert (names.end (), name_.begin (), name_.end ());
+      names.push_back ('\0');
+
+      buckets[b] = items_.size ();
+      items_.push_back (ni);
+    }
+
+    const diff_item*
+    diff_table::find (const char* name_, uint32_t hash) const
+    {
+      uint32_t i = buckets[hash % buckets.size ()];
+      while (i != end)
+      {
+        const diff_item& item = items_[i];
+        if ((item.hash == hash) && (::strcmp (&names[item.name], name_) == 0))
+          return &item;
+        i = item.next;
+      }
+      return 0;
+    }
+
+    const char*
+    diff_table::name (const diff_item& item) const
+    {
+      return &names[item.name];
+    }
+
+    uint64_t
+    diff_table::total () const
+    {
+      uint64_t t = 0;
+      for (items::const_iterator ii = items_.begin (); ii != items_.end (); ++ii)
+        t += (*ii).size;
+      return t;
+    }
+
+    /**
+     * An image being compared.
+     */
+    struct diff_image
+    {
+      std::string name;         //< The executable's file name.
+      std::string map_name;     //< The linker map file's name, empty if none.
+      diff_table  sections;     //< The allocated sections.
+      diff_table  objects;      //< The object files from the map.
+      diff_table  symbols;      //< The function and object symbols.
+      std::string error;        //< The error if the load failed.
+
+      diff_image (const std::string& name);
+
+      /**
+       * Load the image. Errors are held so the load can run in a thread.
+       */
+      void load ();
+
+    private:
+
+      void load_elf ();
+      void load_map (const strings& alloced);
+    };
+
+    /**
+     * A delta between the two images.
+     */
+    struct diff_delta
+    {
+      const char* name;
+      uint64_t    old_size;
+      uint64_t    new_size;
+
+      int64_t delta () const {
+        return (int64_t) new_size - (int64_t) old_size;
+      }
+    };
+
+    typedef std::vector < diff_delta > diff_deltas;
+
+    /**
+     * Order the deltas by the magnitude of the change, largest first.
+     */
+    static bool
+    diff_delta_compare (const diff_delta& lhs, const diff_delta& rhs)
+    {
+      int64_t l = lhs.delta () < 0 ? -lhs.delta () : lhs.delta ();
+      int64_t r = rhs.delta () < 0 ? -rhs.delta () : rhs.delta ();
+      if (l != r)
+        return l > r;
+      return ::strcmp (lhs.name, rhs.name) < 0;
+    }
+
+#if HAVE_PTHREAD_CREATE
+    /**
+     * The libelf handles are independent but rld's ELF checks record the
+     * first file's type so the files are opened and closed with the lock
+     * held.
+     */
+    static pthread_mutex_t diff_elf_lock = PTHREAD_MUTEX_INITIALIZER;
+    #define DIFF_ELF_LOCK()   ::pthread_mutex_lock (&diff_elf_lock)
+    #define DIFF_ELF_UNLOCK() ::pthread_mutex_unlock (&diff_elf_lock)
+#else
+    #define DIFF_ELF_LOCK()
+    #define DIFF_ELF_UNLOCK()
+#endif
+
+    diff_image::diff_image (const std::string& name)
+      : name (name)
+    {
+      /*
+       * Use the linker map file if there is one.
+       */
+      std::string base = name;
+      std::string ext = path::extension (name);
+      if (!ext.empty ())
+        base = name.substr (0, name.size () - ext.size ());
+      if (path::check_file (name + ".map"))
+        map_name = name + ".map";
+      else if (path::check_file (base + ".map"))
+        map_name = base + ".map";
+    }
+
+    void
+    diff_image::load ()
+    {
+      try
+      {
+        load_elf ();
+      }
+      catch (const rld::error& re)
+      {
+        error = re.where + ": " + re.what;
+      }
+      catch (...)
+      {
+        error = "exeinfo:diff: " + name + ": load failed";
+      }
+    }
+
+    void
+    diff_image::load_elf ()
+    {
+      files::object exe (name);
+      strings       alloced;
+
+      DIFF_ELF_LOCK ();
+      try
+      {
+        exe.open ();
+        exe.begin ();
+      }
+      catch (...)
+      {
+        DIFF_ELF_UNLOCK ();
+        throw;
+      }
+      DIFF_ELF_UNLOCK ();
+
+      try
+      {
+        if (!exe.valid ())
+          throw rld::error ("Not valid: " + exe.name ().full (),
+                            "exeinfo:diff");
+
+        elf::file& elf = exe.elf ();
+
+        /*
+         * The allocated sections.
+         */
+        elf::sections secs;
+        elf.get_sections (secs, 0);
+
+        for (elf::sections::iterator si = secs.begin ();
+             si != secs.end ();
+             ++si)
+        {
+          elf::section& sec = *(*si);
+          if ((sec.flags () & SHF_ALLOC) != 0)
+          {
+            sections.add (sec.name (), sec.size ());
+            alloced.push_back (sec.name ());
+          }
+        }
+
+        /*
+         * The symbols are read from the symbol table directly. Local symbols
+         * are joined with the file name from the preceding file symbol.
+         */
+        elf::sections symbol_secs;
+        elf.get_sections (symbol_secs, SHT_SYMTAB);
+
+        for (elf::sections::iterator si = symbol_secs.begin ();
+             si != symbol_secs.end ();
+             ++si)
+        {
+          elf::section& sec = *(*si);
+          int           syms = sec.entries ();
+          std::string   file;
+
+          for (int s = 0; s < syms; ++s)
+          {
+            elf::elf_sym esym;
+
+            if (!::gelf_getsym (sec.data (), s, &esym))
+              throw rld::error (::elf_errmsg (-1),
+                                "exeinfo:diff:gelf_getsym: " + name);
+
+            int stype = GELF_ST_TYPE (esym.st_info);
+
+            if ((stype != STT_FILE) && (stype != STT_FUNC) && (stype != STT_OBJECT))
+              continue;
+
+            const char* sname = ::elf_strptr (elf.get_elf (),
+                                              sec.link (),
+                                              esym.st_name);
+            if (!sname || (*sname == '\0'))
+              continue;
+
+            if (stype == STT_FILE)
+            {
+              file = sname;
+              continue;
+            }
+
+            if ((esym.st_shndx == SHN_UNDEF) || (esym.st_shndx == SHN_COMMON))
+              continue;
+
+            if (GELF_ST_BIND (esym.st_info) == STB_LOCAL)
+              symbols.add (file + ':' + sname, esym.st_size);
+            else
+              symbols.add (sname, esym.st_size);
+          }
+        }
+      }
+      catch (...)
+      {
+        DIFF_ELF_LOCK ();
+        exe.end ();
+        exe.close ();
+        DIFF_ELF_UNLOCK ();
+        throw;
+      }
+
+      DIFF_ELF_LOCK ();
+      exe.end ();
+      exe.close ();
+      DIFF_ELF_UNLOCK ();
+
+      if (!map_name.empty ())
+        load_map (alloced);
+    }
+
+    /**
+     * Load the object file sizes from a GNU linker map file. The input
+     * sections of the allocated output sections are summed by object
+     * file. The name can be on a line by itself if it is long.
+     */
+    void
+    diff_image::load_map (const strings& alloced)
+    {
+      std::ifstream in (map_name.c_str ());
+
+      if (!in.is_open ())
+        throw rld::error ("Cannot open: " + map_name, "exeinfo:diff");
+
+      std::string line;
+      bool        memory_map = false;
+      bool        output_alloced = false;
+      bool        pending = false;
+
+      while (std::getline (in, line))
+      {
+        if (!memory_map)
+        {
+          memory_map = rld::starts_with (line, "Linker script and memory map");
+          continue;
+        }
+
+        if (line.empty ())
+          continue;
+
+        /*
+         * An output section starts in the first column.
+         */
+        if (line[0] != ' ')
+        {
+          strings fields;
+          split (fields, line, ' ');
+          output_alloced =
+            !fields.empty () &&
+            (std::find (alloced.begin (), alloced.end (), fields[0]) != alloced.end ());
+          pending = false;
+          continue;
+        }
+
+        if (!output_alloced)
+          continue;
+
+        strings fields;
+        split (fields, line, ' ');
+
+        if (fields.empty ())
+          continue;
+
+        /*
+         * An input section is " .name address size file" or " COMMON ...". If
+         * the name is long the rest is on the next line.
+         */
+        if ((fields[0][0] == '.') || (fields[0] == "COMMON"))
+        {
+          if (fields.size () == 1)
+          {
+            pending = true;
+            continue;
+          }
+          fields.erase (fields.begin ());
+        }
+        else if (!pending)
+        {
+          continue;
+        }
+
+        pending = false;
+
+        if ((fields.size () != 3) ||
+            !rld::starts_with (fields[0], "0x") ||
+            !rld::starts_with (fields[1], "0x"))
+          continue;
+
+        uint64_t size = ::strtoull (fields[1].c_str (), 0, 16);
+
+        if (size == 0)
+          continue;
+
+        /*
+         * Use the base name so builds in different paths match.
+         */
+        objects.add (path::basename (fields[2]), size);
+      }
+    }
+
+#if HAVE_PTHREAD_CREATE
+    /**
+     * The images loaded by the threads.
+     */
+    struct diff_loader
+    {
+      std::vector < diff_image* >& images;
+      size_t                       next;
+      pthread_mutex_t              lock;
+
+      diff_loader (std::vector < diff_image* >& images)
+        : images (images),
+          next (0) {
+        ::pthread_mutex_init (&lock, 0);
+      }
+
+      ~diff_loader () {
+        ::pthread_mutex_destroy (&lock);
+      }
+    };
+
+    static void*
+    diff_load_worker (void* arg)
+    {
+      diff_loader& loader = *static_cast < diff_loader* > (arg);
+
+      while (true)
+      {
+        ::pthread_mutex_lock (&loader.lock);
+        size_t i = loader.next++;
+        ::pthread_mutex_unlock (&loader.lock);
+
+        if (i >= loader.images.size ())
+          break;
+
+        loader.images[i]->load ();
+      }
+
+      return 0;
+    }
+#endif
+
+    /**
+     * Load the images, concurrently if threads are supported.
+     */
+    static void
+    diff_load (std::vector < diff_image* >& images)
+    {
+#if HAVE_PTHREAD_CREATE
+      long cpus = ::sysconf (_SC_NPROCESSORS_ONLN);
+      if (cpus < 1)
+        cpus = 1;
+
+      size_t threads = std::min ((size_t) cpus, images.size ());
+
+      if (threads > 1)
+      {
+        diff_loader              loader (images);
+        std::vector < pthread_t > workers;
+
+        for (size_t t = 0; t < threads; ++t)
+        {
+          pthread_t worker;
+          if (::pthread_create (&worker, 0, diff_load_worker, &loader) != 0)
+            break;
+          workers.push_back (worker);
+        }
+
+        /*
+         * The main thread also loads so loading completes if no threads
+         * could be created.
+         */
+        diff_load_worker (&loader);
+
+        for (size_t w = 0; w < workers.size (); ++w)
+          ::pthread_join (workers[w], 0);
+
+        return;
+      }
+#endif
+
+      for (size_t i = 0; i < images.size (); ++i)
+        images[i]->load ();
+    }
+
+    /**
+     * Join the tables by name and output the changes sorted by magnitude.
+     */
+    static void
+    diff_output (const char*       label,
+                 const diff_table& old_table,
+                 const diff_table& new_table,
+                 bool              all)
+    {
+      diff_deltas deltas;
+      size_t      changed = 0;
+      size_t      added = 0;
+      size_t      removed = 0;
+
+      for (diff_table::items::const_iterator ii = old_table.items_.begin ();
+           ii != old_table.items_.end ();
+           ++ii)
+      {
+        const diff_item& oitem = *ii;
+        const char*      name = old_table.name (oitem);
+        const diff_item* nitem = new_table.find (name, oitem.hash);
+        diff_delta       delta = { name, oitem.size, nitem ? nitem->size : 0 };
+
+        if (!nitem)
+          ++removed;
+        else if (delta.delta () != 0)
+          ++changed;
+
+        if (all || (delta.delta () != 0) || !nitem)
+          deltas.push_back (delta);
+      }
+
+      for (diff_table::items::const_iterator ii = new_table.items_.begin ();
+           ii != new_table.items_.end ();
+           ++ii)
+      {
+        const diff_item& nitem = *ii;
+        const char*      name = new_table.name (nitem);
+
+        if (!old_table.find (name, nitem.hash))
+        {
+          diff_delta delta = { name, 0, nitem.size };
+          deltas.push_back (delta);
+          ++added;
+        }
+      }
+
+      std::stable_sort (deltas.begin (), deltas.end (), diff_delta_compare);
+
+      uint64_t old_total = old_table.total ();
+      uint64_t new_total = new_table.total ();
+
+      std::cout << label << ": changed: " << changed
+                << " added: " << added
+                << " removed: " << removed
+                << " total: " << old_total << " -> " << new_total
+                << " (" << std::showpos
+                << (int64_t) new_total - (int64_t) old_total
+                << std::noshowpos << ')' << std::endl;
+
+      for (diff_deltas::const_iterator di = deltas.begin ();
+           di != deltas.end ();
+           ++di)
+      {
+        const diff_delta& delta = *di;
+        std::cout << "  " << std::setw (9) << std::showpos << delta.delta ()
+                  << std::noshowpos
+                  << ' ' << std::setw (9) << delta.old_size
+                  << ' ' << std::setw (9) << delta.new_size
+                  << ' ' << delta.name << std::endl;
+      }
+
+      std::cout << std::endl;
+    }
+
+    /**
+     * Compare pairs of executables, the old then the new, outputting the
+     * section, object file and symbol size changes.
+     */
+    void
+    diff (const strings& exe_names, bool all)
+    {
+      std::vector < diff_image* > images;
+
+      try
+      {
+        for (strings::const_iterator ei = exe_names.begin ();
+             ei != exe_names.end ();
+             ++ei)
+          images.push_back (new diff_image (*ei));
+
+        diff_load (images);
+
+        for (size_t i = 0; i < images.size (); i += 2)
+        {
+          diff_image& old_image = *images[i];
+          diff_image& new_image = *images[i + 1];
+
+          if (!old_image.error.empty ())
+            throw rld::error (old_image.error, "exeinfo:diff");
+          if (!new_image.error.empty ())
+            throw rld::error (new_image.error, "exeinfo:diff");
+
+          std::cout << "Diff: " << old_image.name
+                    << " -> " << new_image.name << std::endl
+                    << "      delta       old       new name" << std::endl;
+
+          diff_output ("Sections", old_image.sections, new_image.sections, all);
+
+          if (!old_image.map_name.empty () && !new_image.map_name.empty ())
+            diff_output ("Objects", old_image.objects, new_image.objects, all);
+
+          diff_output ("Symbols", old_image.symbols, new_image.symbols, all);
+        }
+      }
+      catch (...)
+      {
+        for (size_t i = 0; i < images.size (); ++i)
+          delete images[i];
+        throw;
+      }
+
+      for (size_t i = 0; i < images.size (); ++i)
+        delete images[i];
+    }
   }
 }
 
@@ -384,6 +1120,8 @@ static struct option rld_opts[] = {
   { "sections",    no_argument,            NULL,           'S' },
   { "init",        no_argument,            NULL,           'I' },
   { "fini",        no_argument,            NULL,           'F' },
+  { "symbolize",   no_argument,            NULL,           'Y' },
+  { "diff",        no_argument,            NULL,           'D' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -391,6 +1129,7 @@ void
 usage (int exit_code)
 {
   std::cout << "rtems-exeinfo [options] objects" << std::endl
+            << "rtems-exeinfo -D [options] old new [old new ...]" << std::endl
             << "Options and arguments:" << std::endl
             << " -h        : help (also --help)" << std::endl
             << " -V        : print linker version number and exit (also --version)" << std::endl
@@ -400,7 +1139,12 @@ usage (int exit_code)
             << " -a        : all output excluding the map (also --all)" << std::endl
             << " -S        : show all section (also --sections)" << std::endl
             << " -I        : show init section tables (also --init)" << std::endl
-            << " -F        : show fini section tables (also --fini)" << std::endl;
+            << " -F        : show fini section tables (also --fini)" << std::endl
+            << " -Y        : symbolize hex addresses read from stdin, one per line, to" << std::endl
+            << "             symbol+offset on stdout (also --symbolize)" << std::endl
+            << " -D        : show the section, object file and symbol size changes" << std::endl
+            << "             between pairs of executables, object file sizes need" << std::endl
+            << "             linker map files, -a shows unchanged sizes (also --diff)" << std::endl;
   ::exit (exit_code);
 }
 
@@ -453,12 +1197,14 @@ main (int argc, char* argv[])
     bool        sections = false;
     bool        init = false;
     bool        fini = false;
+    bool        symbolize = false;
+    bool        diff = false;
 
     rld::set_cmdline (argc, argv);
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvVMaSIF", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvVMaSIFYD", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -495,6 +1241,14 @@ main (int argc, char* argv[])
           sections = true;
           break;
 
+        case 'Y':
+          symbolize = true;
+          break;
+
+        case 'D':
+          diff = true;
+          break;
+
         case '?':
           usage (3);
           break;
@@ -513,8 +1267,14 @@ main (int argc, char* argv[])
     argc -= optind;
     argv += optind;
 
-    std::cout << "RTEMS Executable Info " << rld::version () << std::endl;
-    std::cout << " " << rld::get_cmdline () << std::endl;
+    /*
+     * Symbolizing only outputs the symbols.
+     */
+    if (!symbolize)
+    {
+      std::cout << "RTEMS Executable Info " << rld::version () << std::endl;
+      std::cout << " " << rld::get_cmdline () << std::endl;
+    }
 
     /*
      * All means all types of output.
@@ -531,6 +1291,18 @@ main (int argc, char* argv[])
      */
     if (argc == 0)
       throw rld::error ("no executable", "options");
+
+    if (diff)
+    {
+      if ((argc % 2) != 0)
+        throw rld::error ("diff needs pairs of executables", "options");
+      rld::strings exe_names;
+      while (argc--)
+        exe_names.push_back (*argv++);
+      rld::exeinfo::diff (exe_names, all);
+      return 0;
+    }
+
     if (argc > 1)
       throw rld::error ("only a single executable", "options");
 
@@ -539,6 +1311,12 @@ main (int argc, char* argv[])
      */
     exe_name = *argv;
 
+    if (symbolize)
+    {
+      rld::exeinfo::symbolize (exe_name);
+      return 0;
+    }
+
     if (rld::verbose ())
       std::cout << "exe-image: " << exe_name << std::endl;
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker partial link test data object.
+ *
+ * The data, bss and read-only data of this object follow the main object's
+ * in the merged sections. The REL relocations against these section symbols
+ * need a local anchor symbol at the section's offset in the merged section.
+ * The common 'reloc_common' is the larger common.
+ */
+
+int reloc_common[8];
+
+static int table[4] = { 1, 2, 3, 4 };
+static int scratch[16];
+
+int
+reloc_data_get (int i)
+{
+  const char* name = "reloc-data";
+  scratch[i] = table[i];
+  return scratch[i] + name[i] + reloc_common[7];
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker partial link test main object.
+ *
+ * The partial link test links these objects with 'rtems-ld -O reloc' and
+ * with 'ld -r' and compares the global symbols and the relocation counts of
+ * each section. The common 'reloc_common' is smaller than the one in
+ * reloc-data.c so the larger common is kept. The static data references are
+ * relocations against the section symbols.
+ */
+
+int reloc_common[2];
+
+static int counter;
+static const char* greeting = "hello";
+
+extern int reloc_data_get (int);
+extern int reloc_inline_1 (int);
+extern int reloc_inline_2 (int);
+
+int
+main (void)
+{
+  counter += reloc_data_get (1);
+  return counter + greeting[0] + reloc_common[1] +
+    reloc_inline_1 (2) + reloc_inline_2 (3);
+}
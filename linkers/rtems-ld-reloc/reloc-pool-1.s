@@ -0,0 +1,13 @@
+/*
+ * RTEMS Linker partial link test NOBITS pool.
+ *
+ * The first '.pool' section is NOBITS. The second in reloc-pool-2.s has
+ * data so the merged section is promoted to PROGBITS.
+ */
+	.section .pool,"aw",@nobits
+	.globl	reloc_pool_head
+	.type	reloc_pool_head, @object
+	.size	reloc_pool_head, 16
+reloc_pool_head:
+	.zero	16
+	.section .note.GNU-stack,"",@progbits
@@ -0,0 +1,17 @@
+/*
+ * RTEMS Linker partial link test PROGBITS pool.
+ *
+ * The '.pool' section has data and relocations and follows the NOBITS
+ * '.pool' section of reloc-pool-1.s.
+ */
+	.section .pool,"aw",@progbits
+	.align	4
+	.globl	reloc_pool_tail
+	.type	reloc_pool_tail, @object
+	.size	reloc_pool_tail, 16
+reloc_pool_tail:
+	.long	reloc_pool_head
+	.long	reloc_pool_tail
+	.long	5
+	.long	6
+	.section .note.GNU-stack,"",@progbits
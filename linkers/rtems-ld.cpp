@@ -71,6 +71,13 @@ static struct option rld_opts[] = {
   { "exec-prefix", required_argument,      NULL,           'E' },
   { "cflags",      required_argument,      NULL,           'c' },
   { "rap-strip",   no_argument,            NULL,           'S' },
+  { "rap-pack",    no_argument,            NULL,           'K' },
+  { "rap-front-code", no_argument,         NULL,           'F' },
+  { "function-order", required_argument,   NULL,           'f' },
+  { "rap-xip",     required_argument,      NULL,           'X' },
+  { "rap-checksum", no_argument,           NULL,           'k' },
+  { "strip-debug", no_argument,            NULL,           'D' },
+  { "debug-dir",   required_argument,      NULL,           'G' },
   { "rpath",       required_argument,      NULL,           'R' },
   { "runtime-lib", required_argument,      NULL,           'P' },
   { "one-file",    no_argument,            NULL,           's' },
@@ -116,6 +123,22 @@ usage (int exit_code)
             << " -E prefix : the RTEMS tool prefix (also --exec-prefix)" << std::endl
             << " -c cflags : C compiler flags (also --cflags)" << std::endl
             << " -S        : do not include file details (also --rap-strip)" << std::endl
+            << " -K        : pack the sections by alignment to reduce the padding" << std::endl
+            << "             (also --rap-pack)" << std::endl
+            << " -F        : front code the RAP string table, the RAP version is 3" << std::endl
+            << "             (also --rap-front-code)" << std::endl
+            << " -f file   : order the RAP text by the function weights in the file" << std::endl
+            << "             (also --function-order)" << std::endl
+            << " -X align  : execute in place RAP layout, the text and const sections" << std::endl
+            << "             are not compressed and are aligned to align in the file," << std::endl
+            << "             the RAP version is 4 (also --rap-xip)" << std::endl
+            << " -k        : checksum the RAP image and each compressed block with" << std::endl
+            << "             CRC32C (also --rap-checksum)" << std::endl
+            << " -D        : strip the debug sections from the ELF application objects" << std::endl
+            << "             into debug objects (also --strip-debug)" << std::endl
+            << " -G dir    : strip the debug sections into debug objects in dir, the" << std::endl
+            << "             default is the output with '.debug' appended, the objects" << std::endl
+            << "             are found by build-id (also --debug-dir)" << std::endl
             << " -R        : include file paths (also --rpath)" << std::endl
             << " -P        : place objects from archives (also --runtime-lib)" << std::endl
             << " -s        : Include archive elf object files (also --one-file)" << std::endl
@@ -126,7 +149,9 @@ usage (int exit_code)
             << " rap     - RTEMS application (LZ77, single image)" << std::endl
             << " elf     - ELF application (script, ELF files)" << std::endl
             << " script  - Script format (list of object files)" << std::endl
-            << " archive - Archive format (collection of ELF files)" << std::endl;
+            << " archive - Archive format (collection of ELF files)" << std::endl
+            << " thin    - GNU thin archive format (paths of ELF files)" << std::endl
+            << " reloc   - Relocatable ELF object (partial link, like ld -r)" << std::endl;
   ::exit (exit_code);
 }
 
@@ -204,7 +229,7 @@ main (int argc, char* argv[])
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvwVMnsSb:E:o:O:L:l:c:e:d:u:C:W:R:P:r:B:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvwVMnsSKFDkf:X:G:b:E:o:O:L:l:c:e:d:u:C:W:R:P:r:B:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -305,6 +330,38 @@ main (int argc, char* argv[])
           rld::rap::add_obj_details = false;
           break;
 
+        case 'f':
+          rld::rap::function_order = optarg;
+          break;
+
+        case 'K':
+          rld::rap::pack_sections = true;
+          break;
+
+        case 'F':
+          rld::rap::front_code_strings = true;
+          break;
+
+        case 'k':
+          rld::rap::checksum = true;
+          break;
+
+        case 'X':
+          rld::rap::xip_alignment = ::strtoul (optarg, 0, 0);
+          if ((rld::rap::xip_alignment == 0) ||
+              ((rld::rap::xip_alignment & (rld::rap::xip_alignment - 1)) != 0))
+            throw rld::error ("XIP alignment not a power of 2", "options");
+          break;
+
+        case 'D':
+          rld::outputter::strip_debug = true;
+          break;
+
+        case 'G':
+          rld::outputter::strip_debug = true;
+          rld::outputter::debug_dir = optarg;
+          break;
+
         case 'R':
           rld::rap::rpath += optarg;
           rld::rap::rpath += '\0';
@@ -358,9 +415,24 @@ main (int argc, char* argv[])
     if ((output_type != "rap") &&
         (output_type != "elf") &&
         (output_type != "script") &&
-        (output_type != "archive"))
+        (output_type != "archive") &&
+        (output_type != "thin") &&
+        (output_type != "reloc"))
       throw rld::error ("invalid output format", "options");
 
+    /*
+     * Only the ELF application holds the debug sections. A RAP image only
+     * holds the sections the target loads.
+     */
+    if (rld::outputter::strip_debug && (output_type != "elf"))
+      throw rld::error ("debug stripping needs the elf output format", "options");
+
+    /*
+     * The XIP layout is a RAP layout.
+     */
+    if ((rld::rap::xip_alignment != 0) && (output_type != "rap"))
+      throw rld::error ("XIP layout needs the rap output format", "options");
+
     /*
      * Load the arch/bsp value if provided.
      */
@@ -499,6 +571,11 @@ main (int argc, char* argv[])
           rld::outputter::script (output, entry, exit, dependents, cache);
         else if (output_type == "archive")
           rld::outputter::archive (output, entry, exit, dependents, cache);
+        else if (output_type == "thin")
+          rld::outputter::archive (output, entry, exit, dependents, cache,
+                                   true);
+        else if (output_type == "reloc")
+          rld::outputter::relocatable (output, dependents, cache);
         else if (output_type == "elf")
           rld::outputter::elf_application (output, entry, exit,
                                            dependents, cache);
@@ -66,6 +66,7 @@ static struct option rld_opts[] = {
   { "march",       required_argument,      NULL,           'a' },
   { "mcpu",        required_argument,      NULL,           'c' },
   { "rap-strip",   no_argument,            NULL,           'S' },
+  { "rap-pack",    no_argument,            NULL,           'K' },
   { "rpath",       required_argument,      NULL,           'R' },
   { "add-rap",     required_argument,      NULL,           'A' },
   { "replace-rap", required_argument,      NULL,           'r' },
@@ -102,6 +103,8 @@ usage (int exit_code)
             << " -E prefix : the RTEMS tool prefix (also --exec-prefix)" << std::endl
             << " -c cflags : C compiler flags (also --cflags)" << std::endl
             << " -S        : do not include file details (also --rap-strip)" << std::endl
+            << " -K        : pack the sections by alignment to reduce the padding" << std::endl
+            << "             (also --rap-pack)" << std::endl
             << " -R        : include file paths (also --rpath)" << std::endl
             << " -A        : Add rap files (also --Add-rap)" << std::endl
             << " -r        : replace rap files (also --replace-rap)" << std::endl
@@ -176,7 +179,7 @@ main (int argc, char* argv[])
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hVvnSa:p:L:l:o:C:E:c:R:W:A:r:d:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hVvnSKa:p:L:l:o:C:E:c:R:W:A:r:d:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -261,6 +264,10 @@ main (int argc, char* argv[])
           rld::rap::add_obj_details = false;
           break;
 
+        case 'K':
+          rld::rap::pack_sections = true;
+          break;
+
         case 'R':
           rld::rap::rpath += optarg;
           rld::rap::rpath += '\0';
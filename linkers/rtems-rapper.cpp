@@ -29,18 +29,21 @@
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <vector>
 
 #include <cxxabi.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <getopt.h>
 
 #include <rld.h>
 #include <rld-compression.h>
+#include <rld-crc.h>
 #include <rld-files.h>
 #include <rld-process.h>
 #include <rld-rap.h>
@@ -80,6 +83,7 @@ namespace rap
     uint32_t    addend;
     std::string symname;
     off_t       rap_off;
+    bool        resolved; //< In the XIP resolved relocations.
 
     relocation ();
 
@@ -110,6 +114,7 @@ namespace rap
     uint32_t    alignment;
     uint8_t*    data;
     uint32_t    relocs_size;
+    uint32_t    relocs_resolved; //< The XIP resolved relocations.
     relocations relocs;
     bool        rela;
     off_t       rap_off;
@@ -118,7 +123,7 @@ namespace rap
     ~section ();
 
     void load_data (rld::compress::compressor& comp);
-    void load_relocs (rld::compress::compressor& comp);
+    void load_relocs (rld::compress::compressor& comp, bool xip);
   };
 
   /**
@@ -176,6 +181,12 @@ namespace rap
     std::string rhdr_compression;
     uint32_t    rhdr_checksum;
 
+    off_t       xip_rap_off;
+    uint32_t    xip_align;
+    uint32_t    xip_flags;
+    uint32_t    xip_text_off;
+    uint32_t    xip_const_off;
+
     off_t       machine_rap_off;
     uint32_t    machinetype;
     uint32_t    datatype;
@@ -190,6 +201,7 @@ namespace rap
     off_t       strtab_rap_off;
     uint32_t    strtab_size;
     uint8_t*    strtab;
+    rld::rap::string_table strings;
 
     off_t       symtab_rap_off;
     uint32_t    symtab_size;
@@ -234,6 +246,39 @@ namespace rap
      */
     void expand ();
 
+    /**
+     * Is the string table front coded ?
+     */
+    bool front_coded () const;
+
+    /**
+     * Is the image an execute in place (XIP) layout ?
+     */
+    bool xip () const;
+
+    /**
+     * Is the image compressed ?
+     */
+    bool compressed () const;
+
+    /**
+     * Is the image checksummed ?
+     */
+    bool checksummed () const;
+
+    /**
+     * Verify the checksums of the image without decompressing it. The
+     * errors are reported.
+     *
+     * @return int The number of errors.
+     */
+    int verify ();
+
+    /**
+     * Skip the padding to the XIP file offset of a section.
+     */
+    void skip_xip_padding (rld::compress::compressor& comp, uint32_t offset);
+
     /**
      * Load details.
      */
@@ -284,7 +329,8 @@ namespace rap
     : info (0),
       offset (0),
       addend (0),
-      rap_off (0)
+      rap_off (0),
+      resolved (false)
   {
   }
 
@@ -304,6 +350,7 @@ namespace rap
       alignment (0),
       data (0),
       relocs_size (0),
+      relocs_resolved (0),
       relocs (0),
       rela (false),
       rap_off (0)
@@ -329,7 +376,7 @@ namespace rap
   }
 
   void
-  section::load_relocs (rld::compress::compressor& comp)
+  section::load_relocs (rld::compress::compressor& comp, bool xip)
   {
     uint32_t header;
     comp >> header;
@@ -337,6 +384,13 @@ namespace rap
     rela = header & RAP_RELOC_RELA ? true : false;
     relocs_size = header & ~RAP_RELOC_RELA;
 
+    /*
+     * An XIP image holds the number of relocations resolved at install time
+     * and they are the first relocations.
+     */
+    if (xip)
+      comp >> relocs_resolved;
+
     if (relocs_size)
     {
       for (uint32_t r = 0; r < relocs_size; ++r)
@@ -344,6 +398,7 @@ namespace rap
         relocation reloc;
 
         reloc.rap_off = comp.offset ();
+        reloc.resolved = r < relocs_resolved;
 
         comp >> reloc.info
              >> reloc.offset;
@@ -375,6 +430,11 @@ namespace rap
       rhdr_length (0),
       rhdr_version (0),
       rhdr_checksum (0),
+      xip_rap_off (0),
+      xip_align (0),
+      xip_flags (0),
+      xip_text_off (0),
+      xip_const_off (0),
       machine_rap_off (0),
       machinetype (0),
       datatype (0),
@@ -468,6 +528,14 @@ namespace rap
       rhdr_compression = "LZ77";
       eptr = sptr + 4;
     }
+    else if ((sptr[0] == 'L') &&
+             (sptr[1] == 'Z') &&
+             (sptr[2] == '7') &&
+             (sptr[3] == 'C'))
+    {
+      rhdr_compression = "LZ7C";
+      eptr = sptr + 4;
+    }
     else
       throw rld::error ("Cannot parse RAP header", "open: " + name);
 
@@ -544,7 +612,9 @@ namespace rap
   {
     image.seek (rhdr_len);
 
-    rld::compress::compressor comp (image, rap_comp_buffer, false);
+    rld::compress::compressor comp (image, rap_comp_buffer, false,
+                                    compressed (),
+                                    rhdr_compression == "LZ7C");
 
     /*
      * uint32_t: machinetype
@@ -598,12 +668,33 @@ namespace rap
       comp >> secs[s].size
            >> secs[s].alignment;
 
+    /*
+     * uint32_t: xip_alignment
+     * uint32_t: xip_flags
+     * uint32_t: text_offset
+     * uint32_t: const_offset
+     */
+    if (xip ())
+    {
+      xip_rap_off = comp.offset ();
+      comp >> xip_align
+           >> xip_flags
+           >> xip_text_off
+           >> xip_const_off;
+    }
+
     /*
      * Load sections.
      */
     for (int s = 0; s < rld::rap::rap_secs; ++s)
+    {
+      if (xip () && (s == rld::rap::rap_text))
+        skip_xip_padding (comp, xip_text_off);
+      if (xip () && (s == rld::rap::rap_const))
+        skip_xip_padding (comp, xip_const_off);
       if (s != rld::rap::rap_bss)
         secs[s].load_data (comp);
+    }
 
     /*
      * Load the string table.
@@ -614,6 +705,7 @@ namespace rap
       strtab = new uint8_t[strtab_size];
       if (comp.read (strtab, strtab_size) != strtab_size)
         throw rld::error ("Reading string table failed", "rapper");
+      strings.load (strtab, strtab_size, front_coded ());
     }
 
     /*
@@ -632,7 +724,24 @@ namespace rap
      */
     relocs_rap_off = comp.offset ();
     for (int s = 0; s < rld::rap::rap_secs; ++s)
-      secs[s].load_relocs (comp);
+      secs[s].load_relocs (comp, xip ());
+  }
+
+  void
+  file::skip_xip_padding (rld::compress::compressor& comp, uint32_t offset)
+  {
+    uint32_t at = rhdr_len + comp.offset ();
+
+    if (at > offset)
+      throw rld::error ("XIP section offset passed", "rapper");
+
+    while (at < offset)
+    {
+      uint8_t pad;
+      if (comp.read (&pad, 1) != 1)
+        throw rld::error ("Reading XIP padding failed", "rapper");
+      ++at;
+    }
   }
 
   void
@@ -645,7 +754,9 @@ namespace rap
 
     image.seek (rhdr_len);
 
-    rld::compress::compressor comp (image, rap_comp_buffer, false);
+    rld::compress::compressor comp (image, rap_comp_buffer, false,
+                                    compressed (),
+                                    rhdr_compression == "LZ7C");
     rld::files::image         out (name);
 
     out.open (true);
@@ -658,6 +769,131 @@ namespace rap
     out.close ();
   }
 
+  bool
+  file::front_coded () const
+  {
+    if (xip ())
+      return (xip_flags & RAP_XIP_FRONT_CODED) != 0;
+    return rhdr_version == RAP_VERSION_FRONT_CODED;
+  }
+
+  bool
+  file::xip () const
+  {
+    return rhdr_version == RAP_VERSION_XIP;
+  }
+
+  bool
+  file::compressed () const
+  {
+    return (rhdr_compression == "LZ77") || (rhdr_compression == "LZ7C");
+  }
+
+  bool
+  file::checksummed () const
+  {
+    return (rhdr_compression == "LZ7C") || (rhdr_checksum != 0);
+  }
+
+  int
+  file::verify ()
+  {
+    int errors = 0;
+
+    if (rhdr_length != image.size ())
+    {
+      std::cout << "  error: header length does not match file size: header="
+                << rhdr_length
+                << " file-size=" << image.size ()
+                << std::endl;
+      ++errors;
+    }
+
+    if (!checksummed ())
+    {
+      std::cout << "  error: image has no checksum" << std::endl;
+      return ++errors;
+    }
+
+    std::vector < uint8_t > data (image.size () - rhdr_len);
+
+    if (!data.empty () &&
+        !image.seek_read (rhdr_len, &data[0], data.size ()))
+      throw rld::error ("Reading image failed", "verify: " + name ());
+
+    const uint32_t crc =
+      data.empty () ? 0 : rld::crc::crc32c (0, &data[0], data.size ());
+
+    std::cout << "        checksum: " << std::hex << std::setfill ('0')
+              << std::setw (8) << rhdr_checksum;
+    if (crc != rhdr_checksum)
+      std::cout << " (image: " << std::setw (8) << crc << ')';
+    std::cout << std::dec << std::setfill (' ') << std::endl;
+
+    if (crc != rhdr_checksum)
+    {
+      std::cout << "  error: image checksum does not match" << std::endl;
+      ++errors;
+    }
+
+    /*
+     * Walk the compressed blocks checking the CRC32C that follows each block.
+     * A bad block is found without decompressing the image.
+     */
+    if (rhdr_compression == "LZ7C")
+    {
+      size_t   offset = 0;
+      uint32_t blocks = 0;
+      uint32_t failed = 0;
+
+      while (offset < data.size ())
+      {
+        if ((offset + 2) > data.size ())
+        {
+          std::cout << "  error: block " << blocks
+                    << ": truncated header at " << rhdr_len + offset
+                    << std::endl;
+          ++failed;
+          break;
+        }
+
+        const uint32_t block_size = get_value < uint16_t > (&data[offset]);
+
+        if ((block_size == 0) ||
+            ((offset + 2 + block_size + 4) > data.size ()))
+        {
+          std::cout << "  error: block " << blocks
+                    << ": invalid size " << block_size
+                    << " at " << rhdr_len + offset << std::endl;
+          ++failed;
+          break;
+        }
+
+        const uint32_t block_crc =
+          rld::crc::crc32c (0, &data[offset], 2 + block_size);
+
+        if (block_crc !=
+            get_value < uint32_t > (&data[offset + 2 + block_size]))
+        {
+          std::cout << "  error: block " << blocks
+                    << ": checksum does not match at " << rhdr_len + offset
+                    << std::endl;
+          ++failed;
+        }
+
+        offset += 2 + block_size + 4;
+        ++blocks;
+      }
+
+      std::cout << "          blocks: " << blocks
+                << ", failed: " << failed << std::endl;
+
+      errors += failed;
+    }
+
+    return errors;
+  }
+
   const std::string
   file::name () const
   {
@@ -690,16 +926,10 @@ namespace rap
     if (strtab_size == 0)
       throw rld::error ("No string table", "string: " + name);
 
-    uint32_t offset = 0;
-    int count = 0;
-    while (offset < strtab_size)
-    {
-      if (count++ == index)
-        return (const char*) &strtab[offset];
-      offset = ::strlen ((const char*) &strtab[offset]) + 1;
-    }
+    if ((index < 0) || ((size_t) index >= strings.size ()))
+      throw rld::error ("Invalid string index", "string: " + name);
 
-    throw rld::error ("Invalid string index", "string: " + name);
+    return strings.string (index);
   }
 }
 
@@ -784,6 +1014,14 @@ rap_show (rld::path::paths& raps,
           std::cout << " -";
         std::cout << std::endl;
       }
+      if (r.xip ())
+        std::cout << std::setw (16) << "xip" << ": "
+                  << std::setw (6) << 4 * sizeof (uint32_t)
+                  << std::setw (7) << r.xip_align
+                  << std::hex << std::setfill ('0')
+                  << " 0x" << std::setw (8) << r.xip_rap_off
+                  << std::setfill (' ') << std::dec
+                  << " (" << r.xip_rap_off << ')' << std::endl;
       std::cout << std::setw (16) << "strtab" << ": "
                 << std::setw (6) << r.strtab_size
                 << std::setw (7) << '-'
@@ -870,19 +1108,17 @@ rap_show (rld::path::paths& raps,
                 << std::setfill (' ') << std::dec
                 << " (" << r.strtab_rap_off << ')'
                 << " size: " << r.strtab_size
+                << (r.front_coded () ? " front coded" : "")
                 << std::endl;
       if (r.strtab_size)
       {
-        uint32_t offset = 0;
-        int count = 0;
-        while (offset < r.strtab_size)
+        for (size_t s = 0; s < r.strings.size (); ++s)
         {
-          std::cout << std::setw (16) << count++
+          std::cout << std::setw (16) << s
                     << std::hex << std::setfill ('0')
-                    << " (0x" << std::setw (6) << offset << "): "
+                    << " (0x" << std::setw (6) << r.strings.reference (s) << "): "
                     << std::dec << std::setfill (' ')
-                    << (char*) &r.strtab[offset] << std::endl;
-          offset += ::strlen ((char*) &r.strtab[offset]) + 1;
+                    << r.strings.string (s) << std::endl;
         }
       }
       else
@@ -918,7 +1154,7 @@ rap_show (rld::path::paths& raps,
                     << " " << std::setw (8) << rld::rap::section_name (data >> 16)
                     << std::hex << std::setfill ('0')
                     << " 0x" << std::setw(8) << value
-                    << " " << &r.strtab[name]
+                    << " " << (r.strings.get (name) ? r.strings.get (name) : "?")
                     << std::dec << std::setfill (' ')
                     << std::endl;
         }
@@ -1050,6 +1286,287 @@ rap_overlay (rld::path::paths& raps, bool warnings)
   }
 }
 
+/**
+ * Time loading a string table. Returns the nanoseconds for each load.
+ */
+static double
+strings_decode_time (const std::string& table, bool front_coded)
+{
+  rld::rap::string_table strings;
+  const clock_t          start = ::clock ();
+  clock_t                end;
+  unsigned long          loads = 0;
+
+  do
+  {
+    strings.load ((const uint8_t*) table.data (), table.size (), front_coded);
+    ++loads;
+    end = ::clock ();
+  } while ((end - start) < (CLOCKS_PER_SEC / 5));
+
+  return ((double) (end - start) * 1000000000.0) / (CLOCKS_PER_SEC * (double) loads);
+}
+
+void
+rap_strings_compare (rld::path::paths& raps, bool warnings)
+{
+  std::cout << "String tables .... " << std::endl;
+  for (rld::path::paths::iterator pi = raps.begin();
+       pi != raps.end();
+       ++pi)
+  {
+    rap::file r (*pi, warnings);
+
+    r.load ();
+
+    /*
+     * The plain table is the table in the file if it is plain. The strings
+     * are sorted with no duplicates for front coding.
+     */
+    std::set < std::string > unique;
+    std::string              plain;
+    std::string              coded;
+
+    for (size_t s = 0; s < r.strings.size (); ++s)
+      if (*r.strings.string (s) != '\0')
+        unique.insert (r.strings.string (s));
+
+    rld::strings sorted (unique.begin (), unique.end ());
+
+    if (r.front_coded ())
+    {
+      plain += '\0';
+      for (rld::strings::const_iterator si = sorted.begin ();
+           si != sorted.end ();
+           ++si)
+      {
+        plain += *si;
+        plain += '\0';
+      }
+      coded.assign ((const char*) r.strtab, r.strtab_size);
+    }
+    else
+    {
+      plain.assign ((const char*) r.strtab, r.strtab_size);
+      rld::rap::front_code (sorted, coded);
+    }
+
+    const double plain_time = strings_decode_time (plain, false);
+    const double coded_time = strings_decode_time (coded, true);
+
+    std::cout << ' ' << r.name () << ':' << std::endl
+              << "          strings: " << sorted.size ()
+              << (r.front_coded () ? " (front coded)" : " (plain)") << std::endl
+              << "       plain size: " << plain.size () << std::endl
+              << " front coded size: " << coded.size ();
+    if (!plain.empty ())
+      std::cout << " (" << (coded.size () * 100) / plain.size () << "%)";
+    std::cout << std::endl
+              << std::fixed << std::setprecision (1)
+              << "     plain decode: " << plain_time << " ns" << std::endl
+              << "     front decode: " << coded_time << " ns" << std::endl
+              << std::resetiosflags (std::ios::fixed) << std::setprecision (6);
+  }
+}
+
+/**
+ * Is the relocation resolved when an XIP image is installed? The symbol is
+ * local and in the text or const section.
+ */
+static bool
+xip_resolved (const rap::relocation& reloc)
+{
+  if ((reloc.info & RAP_RELOC_STRING) != 0)
+    return false;
+  const uint32_t symsect = (reloc.info >> 8) & 0x7fffff;
+  return (symsect == rld::rap::rap_text) || (symsect == rld::rap::rap_const);
+}
+
+void
+rap_xip (rld::path::paths& raps, bool warnings)
+{
+  int failures = 0;
+
+  std::cout << "XIP .... " << std::endl;
+  for (rld::path::paths::iterator pi = raps.begin();
+       pi != raps.end();
+       ++pi)
+  {
+    rap::file r (*pi, warnings);
+    int       errors = 0;
+
+    std::cout << ' ' << r.name () << ':' << std::endl;
+
+    if (!r.xip ())
+    {
+      std::cout << "  error: not an XIP image, version: " << r.rhdr_version
+                << std::endl;
+      ++failures;
+      continue;
+    }
+
+    r.load ();
+
+    if (r.compressed ())
+    {
+      std::cout << "  error: XIP image is compressed" << std::endl;
+      ++errors;
+    }
+
+    if ((r.xip_align == 0) || ((r.xip_align & (r.xip_align - 1)) != 0))
+    {
+      std::cout << "  error: XIP alignment is not a power of 2: "
+                << r.xip_align << std::endl;
+      ++errors;
+    }
+
+    std::cout << "       alignment: " << r.xip_align << std::endl
+              << "         strings: "
+              << (r.front_coded () ? "front coded" : "plain") << std::endl;
+
+    /*
+     * The text and const sections are at the aligned file offsets.
+     */
+    for (int s = rld::rap::rap_text; s <= rld::rap::rap_const; ++s)
+    {
+      const rap::section& sec = r.secs[s];
+      const uint32_t      offset =
+        s == rld::rap::rap_text ? r.xip_text_off : r.xip_const_off;
+      const uint32_t      file_off = r.rhdr_len + sec.rap_off;
+
+      std::cout << std::setw (16) << sec.name << ": "
+                << std::hex << std::setfill ('0')
+                << "0x" << std::setw (8) << file_off
+                << std::setfill (' ') << std::dec
+                << " (" << file_off << ')'
+                << " size: " << sec.size << std::endl;
+
+      if (file_off != offset)
+      {
+        std::cout << "  error: " << sec.name << ": file offset does not match"
+                  << " the XIP offset: " << offset << std::endl;
+        ++errors;
+      }
+
+      if ((r.xip_align != 0) && ((file_off & (r.xip_align - 1)) != 0))
+      {
+        std::cout << "  error: " << sec.name << ": file offset is not aligned"
+                  << std::endl;
+        ++errors;
+      }
+
+      if (sec.alignment > r.xip_align)
+      {
+        std::cout << "  error: " << sec.name << ": section alignment "
+                  << sec.alignment << " is greater than the XIP alignment"
+                  << std::endl;
+        ++errors;
+      }
+    }
+
+    /*
+     * The relocations of the text and const sections are split into the
+     * resolved and writable relocations. The other sections are writable.
+     */
+    std::cout << "     Relocations:  total resolved writable" << std::endl;
+
+    for (int s = 0; s < rld::rap::rap_secs; ++s)
+    {
+      const rap::section& sec = r.secs[s];
+      const bool          xip_sec =
+        (s == rld::rap::rap_text) || (s == rld::rap::rap_const);
+      uint32_t            misplaced = 0;
+
+      std::cout << std::setw (16) << sec.name << ": "
+                << std::setw (6) << sec.relocs_size
+                << std::setw (9) << sec.relocs_resolved
+                << std::setw (9) << sec.relocs_size - sec.relocs_resolved
+                << std::endl;
+
+      if (sec.relocs_resolved > sec.relocs_size)
+      {
+        std::cout << "  error: " << sec.name
+                  << ": resolved relocations greater than the relocations"
+                  << std::endl;
+        ++errors;
+        continue;
+      }
+
+      if (!xip_sec && (sec.relocs_resolved != 0))
+      {
+        std::cout << "  error: " << sec.name
+                  << ": resolved relocations in a writable section"
+                  << std::endl;
+        ++errors;
+      }
+
+      for (rap::relocations::const_iterator ri = sec.relocs.begin ();
+           ri != sec.relocs.end ();
+           ++ri)
+      {
+        const rap::relocation& reloc = *ri;
+        if (xip_sec && (xip_resolved (reloc) != reloc.resolved))
+          ++misplaced;
+      }
+
+      if (misplaced)
+      {
+        std::cout << "  error: " << sec.name << ": " << misplaced
+                  << " relocations in the wrong part of the table"
+                  << std::endl;
+        ++errors;
+      }
+
+      if (xip_sec && (sec.relocs_size != sec.relocs_resolved))
+      {
+        std::cout << "  error: " << sec.name << ": "
+                  << sec.relocs_size - sec.relocs_resolved
+                  << " relocations need writable memory" << std::endl;
+        ++errors;
+      }
+    }
+
+    std::cout << "          verify: "
+              << (errors ? "failed" : "passed") << std::endl;
+
+    if (errors)
+      ++failures;
+  }
+
+  if (failures)
+    throw rld::error ("verify failed: " + rld::to_string (failures) +
+                      " image(s)", "xip");
+}
+
+void
+rap_verify (rld::path::paths& raps)
+{
+  int failures = 0;
+
+  std::cout << "Verify .... (CRC32C: " << rld::crc::crc32c_method () << ')'
+            << std::endl;
+  for (rld::path::paths::iterator pi = raps.begin();
+       pi != raps.end();
+       ++pi)
+  {
+    rap::file r (*pi, false);
+
+    std::cout << ' ' << r.name () << ':' << std::endl;
+
+    const int errors = r.verify ();
+
+    std::cout << "          verify: "
+              << (errors ? "failed" : "passed") << std::endl;
+
+    if (errors)
+      ++failures;
+  }
+
+  if (failures)
+    throw rld::error ("verify failed: " + rld::to_string (failures) +
+                      " image(s)", "checksum");
+}
+
 void
 rap_expander (rld::path::paths& raps, bool warnings)
 {
@@ -1081,6 +1598,9 @@ static struct option rld_opts[] = {
   { "relocs",      no_argument,            NULL,           'r' },
   { "overlay",     no_argument,            NULL,           'o' },
   { "expand",      no_argument,            NULL,           'x' },
+  { "compare-strings", no_argument,        NULL,           'c' },
+  { "xip",         no_argument,            NULL,           'X' },
+  { "checksum",    no_argument,            NULL,           'k' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -1103,6 +1623,12 @@ usage (int exit_code)
             << " -r        : show relocations (also --relocs)" << std::endl
             << " -o        : linkage overlay (also --overlay)" << std::endl
             << " -x        : expand (also --expand)" << std::endl
+            << " -c        : compare the size and decode time of the plain and" << std::endl
+            << "             front coded string tables (also --compare-strings)" << std::endl
+            << " -X        : report and verify the XIP layout and the split of the" << std::endl
+            << "             relocations (also --xip)" << std::endl
+            << " -k        : verify the image and block checksums without decompressing" << std::endl
+            << "             the image (also --checksum)" << std::endl
             << " -f        : show file details" << std::endl;
   ::exit (exit_code);
 }
@@ -1162,10 +1688,13 @@ main (int argc, char* argv[])
     bool             show_details = false;
     bool             overlay = false;
     bool             expand = false;
+    bool             compare_strings = false;
+    bool             xip = false;
+    bool             verify = false;
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvVnaHmlsSroxf", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvVnaHmlsSroxcfXk", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -1235,10 +1764,22 @@ main (int argc, char* argv[])
           expand = true;
           break;
 
+        case 'c':
+          compare_strings = true;
+          break;
+
         case 'f':
           show_details = true;
           break;
 
+        case 'X':
+          xip = true;
+          break;
+
+        case 'k':
+          verify = true;
+          break;
+
         case '?':
         case 'h':
           usage (0);
@@ -1279,6 +1820,15 @@ main (int argc, char* argv[])
 
     if (expand)
       rap_expander (raps, warnings);
+
+    if (compare_strings)
+      rap_strings_compare (raps, warnings);
+
+    if (xip)
+      rap_xip (raps, warnings);
+
+    if (verify)
+      rap_verify (raps);
   }
   catch (rld::error re)
   {
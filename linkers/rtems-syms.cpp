@@ -29,6 +29,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <set>
 
 #include <cxxabi.h>
 #include <signal.h>
@@ -42,6 +43,7 @@
 #include <rld-cc.h>
 #include <rld-outputter.h>
 #include <rld-process.h>
+#include <rld-rap.h>
 #include <rld-symbols.h>
 #include <rld-rtems.h>
 
@@ -267,6 +269,203 @@ generate_symmap (rld::process::tempfile& c,
   }
 }
 
+/**
+ * Load the keep list. A symbol name per line and '#' starts a comment.
+ */
+static void
+load_keep_list (const std::string& path, rld::strings& keep)
+{
+  std::ifstream in (path.c_str ());
+
+  if (!in.is_open ())
+    throw rld::error ("Cannot open: " + path, "keep-list");
+
+  std::string line;
+
+  while (std::getline (in, line))
+  {
+    std::string::size_type comment = line.find ('#');
+    if (comment != std::string::npos)
+      line = line.substr (0, comment);
+    line = rld::trim (line);
+    if (!line.empty ())
+      keep.push_back (line);
+  }
+}
+
+/**
+ * Prune the kernel's symbols to the symbols the modules reference and the
+ * symbols in the keep list. The undefined symbols of the object files and
+ * every archive member and the external symbols of RAP files read from their
+ * relocation records are looked up in the kernel. A kernel symbol referenced
+ * by a module is marked as referenced. An undefined symbol not in the kernel
+ * or the modules is reported and does not stop the pruning.
+ */
+static void
+prune_symbols (rld::symbols::table&    symbols,
+               rld::symbols::table&    pruned,
+               const rld::path::paths& modules,
+               const rld::strings&     keep,
+               bool                    warnings)
+{
+  rld::symbols::table base;
+
+  /*
+   * The weak symbols linked into the kernel are output as globals so the
+   * modules need to find them as globals.
+   */
+  for (rld::symbols::symtab::const_iterator si = symbols.globals ().begin ();
+       si != symbols.globals ().end ();
+       ++si)
+    base.add_global (*((*si).second));
+
+  for (rld::symbols::symtab::const_iterator si = symbols.weaks ().begin ();
+       si != symbols.weaks ().end ();
+       ++si)
+  {
+    rld::symbols::symbol& sym = *((*si).second);
+    if ((sym.value () != 0) && !base.find_global (sym.name ()))
+      base.add_global (sym);
+  }
+
+  rld::files::cache   cache;
+  rld::path::paths    objects;
+  rld::path::paths    libraries;
+  size_t              rap_externals = 0;
+  size_t              module_undefined = 0;
+
+  for (rld::path::paths::const_iterator mi = modules.begin ();
+       mi != modules.end ();
+       ++mi)
+  {
+    const std::string& module = *mi;
+
+    if (rld::path::extension (module) == ".rap")
+    {
+      rld::strings externals;
+
+      rld::rap::load_externals (module, externals);
+
+      for (rld::strings::const_iterator ei = externals.begin ();
+           ei != externals.end ();
+           ++ei)
+      {
+        rld::symbols::symbol* sym = base.find_global (*ei);
+        if (sym)
+          sym->referenced ();
+        else if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "prune: not in kernel: " << module
+                    << ": " << *ei << std::endl;
+      }
+
+      rap_externals += externals.size ();
+    }
+    else if (rld::path::extension (module) == ".a")
+    {
+      libraries.push_back (module);
+    }
+    else
+    {
+      objects.push_back (module);
+    }
+  }
+
+  if (!objects.empty () || !libraries.empty ())
+  {
+    rld::symbols::table module_symbols;
+
+    cache.add (objects);
+    cache.open ();
+    cache.add_libraries (libraries);
+
+    try
+    {
+      cache.archives_begin ();
+      cache.load_symbols (module_symbols);
+
+      /*
+       * Each archive member is a module so all the undefined symbols in the
+       * cache are looked up and not only those the object files need. A
+       * symbol a module defines is not a kernel reference.
+       */
+      rld::files::objects& objs = cache.get_objects ();
+      for (rld::files::objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+      {
+        rld::files::object&   obj = *((*oi).second);
+        rld::symbols::symtab& unresolved = obj.unresolved_symbols ();
+        for (rld::symbols::symtab::const_iterator ui = unresolved.begin ();
+             ui != unresolved.end ();
+             ++ui)
+        {
+          const std::string&    name = (*ui).first;
+          rld::symbols::symbol* sym = base.find_global (name);
+          if (sym)
+            sym->referenced ();
+          else if (!module_symbols.find_global (name) &&
+                   !module_symbols.find_weak (name) &&
+                   (rld::verbose () >= RLD_VERBOSE_INFO))
+            std::cout << "prune: not in kernel: " << obj.name ().full ()
+                      << ": " << name << std::endl;
+        }
+        module_undefined += unresolved.size ();
+      }
+    }
+    catch (...)
+    {
+      cache.archives_end ();
+      cache.close ();
+      throw;
+    }
+
+    cache.archives_end ();
+    cache.close ();
+  }
+
+  std::set < std::string > kept;
+
+  for (rld::strings::const_iterator ki = keep.begin ();
+       ki != keep.end ();
+       ++ki)
+  {
+    if (base.find_global (*ki))
+      kept.insert (*ki);
+    else if (warnings)
+      std::cerr << "warning: keep list symbol not in kernel: "
+                << *ki << std::endl;
+  }
+
+  for (rld::symbols::symtab::const_iterator si = symbols.globals ().begin ();
+       si != symbols.globals ().end ();
+       ++si)
+  {
+    rld::symbols::symbol& sym = *((*si).second);
+    if ((sym.references () > 0) || (kept.find (sym.name ()) != kept.end ()))
+      pruned.add_global (sym);
+  }
+
+  for (rld::symbols::symtab::const_iterator si = symbols.weaks ().begin ();
+       si != symbols.weaks ().end ();
+       ++si)
+  {
+    rld::symbols::symbol& sym = *((*si).second);
+    if ((sym.references () > 0) || (kept.find (sym.name ()) != kept.end ()))
+      pruned.add_weak (sym);
+  }
+
+  if (rld::verbose ())
+    std::cout << "prune: modules: " << modules.size ()
+              << " rap externals: " << rap_externals
+              << " undefined: " << module_undefined
+              << " keep: " << kept.size ()
+              << " symbols: "
+              << pruned.globals ().size () + pruned.weaks ().size ()
+              << " of "
+              << symbols.globals ().size () + symbols.weaks ().size ()
+              << std::endl;
+}
+
 /**
  * RTEMS Symbols options.
  */
@@ -283,6 +482,8 @@ static struct option rld_opts[] = {
   { "cc",          required_argument,      NULL,           'C' },
   { "exec-prefix", required_argument,      NULL,           'E' },
   { "cflags",      required_argument,      NULL,           'c' },
+  { "prune",       required_argument,      NULL,           'P' },
+  { "keep-list",   required_argument,      NULL,           'K' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -303,7 +504,11 @@ usage (int exit_code)
             << " -m file   : output a map file (also --map)" << std::endl
             << " -C file   : execute file as the target C compiler (also --cc)" << std::endl
             << " -E prefix : the RTEMS tool prefix (also --exec-prefix)" << std::endl
-            << " -c cflags : C compiler flags (also --cflags)" << std::endl;
+            << " -c cflags : C compiler flags (also --cflags)" << std::endl
+            << " -P file   : prune the symbols to those referenced by the RAP file," << std::endl
+            << "             object file or archive, can be repeated (also --prune)" << std::endl
+            << " -K file   : keep the symbols listed in the file when pruning" << std::endl
+            << "             (also --keep-list)" << std::endl;
   ::exit (exit_code);
 }
 
@@ -358,12 +563,15 @@ main (int argc, char* argv[])
     std::string         cc;
     std::string         symc;
     bool                embed = false;
+    bool                warnings = false;
+    rld::path::paths    modules;
+    std::string         keep_list;
 
     rld::set_cmdline (argc, argv);
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvVwkef:S:o:m:E:c:C:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvVwkef:S:o:m:E:c:C:P:K:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -381,6 +589,7 @@ main (int argc, char* argv[])
           break;
 
         case 'w':
+          warnings = true;
           break;
 
         case 'k':
@@ -419,6 +628,14 @@ main (int argc, char* argv[])
           symc = optarg;
           break;
 
+        case 'P':
+          modules.push_back (optarg);
+          break;
+
+        case 'K':
+          keep_list = optarg;
+          break;
+
         case '?':
           usage (3);
           break;
@@ -478,6 +695,21 @@ main (int argc, char* argv[])
       if (!rld::cc::is_cc_set () && !rld::cc::is_exec_prefix_set ())
         rld::cc::set_exec_prefix (rld::elf::machine_type ());
 
+      /*
+       * Prune the symbols if modules or a keep list are provided.
+       */
+      rld::symbols::table  pruned;
+      rld::symbols::table* output_symbols = &symbols;
+
+      if (!modules.empty () || !keep_list.empty ())
+      {
+        rld::strings keep;
+        if (!keep_list.empty ())
+          load_keep_list (keep_list, keep);
+        prune_symbols (symbols, pruned, modules, keep, warnings);
+        output_symbols = &pruned;
+      }
+
       /*
        * Create a map file if asked too.
        */
@@ -490,7 +722,7 @@ main (int argc, char* argv[])
         mout << "RTEMS Kernel Symbols Map" << std::endl
              << " kernel: " << kernel_name << std::endl
              << std::endl;
-        rld::symbols::output (mout, symbols);
+        rld::symbols::output (mout, *output_symbols);
         mout.close ();
       }
 
@@ -510,7 +742,7 @@ main (int argc, char* argv[])
         /*
          * Generate and compile the symbol map.
          */
-        generate_symmap (c, output, symbols, embed);
+        generate_symmap (c, output, *output_symbols, embed);
       }
 
       kernel.close ();
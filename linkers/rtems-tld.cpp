@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <iomanip>
@@ -64,6 +65,22 @@ namespace rld
      */
     bool dump_on_error;
 
+    /**
+     * The number of wrapper files the traces are split over. Each file is
+     * compiled concurrently.
+     */
+    size_t jobs = 1;
+
+    /**
+     * The directory of cached wrapper object files. Empty if not caching.
+     */
+    std::string wrapper_cache;
+
+    /**
+     * A container of temporary files.
+     */
+    typedef std::vector < rld::process::tempfile* > tempfiles;
+
     /**
      * A container of arguments.
      */
@@ -176,6 +193,7 @@ namespace rld
       std::string  lock_acquire;    /**< The lock acquire if provided. */
       std::string  lock_release;    /**< The lock release if provided. */
       std::string  buffer_local;    /**< Code template to declare a local buffer variable. */
+      std::string  trace_check;     /**< Code template to check if the function is traced. */
       rld::strings headers;         /**< Include statements. */
       rld::strings defines;         /**< Define statements. */
       std::string  entry_trace;     /**< Code template to trace the function entry. */
@@ -185,6 +203,7 @@ namespace rld
       std::string  exit_alloc;      /**< Code template to perform a buffer allocation. */
       std::string  ret_trace;       /**< Code template to trace the return value. */
       rld::strings code;            /**< Code block inserted before the trace code. */
+      rld::strings shared;          /**< Code block shared by all wrapper files. */
 
       /**
        * Default constructor.
@@ -203,6 +222,40 @@ namespace rld
       void dump (std::ostream& out) const;
     };
 
+    /**
+     * A pool of nul terminated strings. A string added more than once is held
+     * once and is referenced by its offset in the pool.
+     */
+    class string_pool
+    {
+    public:
+      /**
+       * Add a string returning its offset in the pool.
+       */
+      size_t add (const std::string& str);
+
+      /**
+       * The strings in the pool.
+       */
+      const std::string& strings () const;
+
+      /**
+       * The size of the pool in bytes.
+       */
+      size_t size () const;
+
+      /**
+       * Clear the pool.
+       */
+      void clear ();
+
+    private:
+      typedef std::map < std::string, size_t > offsets;
+
+      std::string strings_;  /**< The nul terminated strings. */
+      offsets     offsets_;  /**< The offset of each string. */
+    };
+
     /**
      * Tracer.
      */
@@ -259,9 +312,37 @@ namespace rld
       const std::string get_option (const std::string& name) const;
 
       /**
-       * Generate the wrapper object file.
+       * Generate the wrapper header and C files. The first C file holds the
+       * trace data and the generator's code blocks and the wrappers are split
+       * over the remaining C files. A single C file holds everything.
        */
-      void generate (rld::process::tempfile& c);
+      void generate (rld::process::tempfile& h, tempfiles& cs);
+
+      /**
+       * Generate the declarations of the trace data for the header.
+       */
+      void generate_decls (rld::process::tempfile& h);
+
+      /**
+       * Can the wrappers be split over more than one C file ?
+       */
+      bool can_split () const;
+
+      /**
+       * Build the string pool and the signature argument table if the
+       * strings are pooled.
+       */
+      void build_pool ();
+
+      /**
+       * Load the runtime filter from the options.
+       */
+      void load_filter ();
+
+      /**
+       * Generate the string pool.
+       */
+      void generate_strings (rld::process::tempfile& c);
 
       /**
        * Generate the trace names as a string table.
@@ -283,15 +364,23 @@ namespace rld
        */
       void generate_triggers (rld::process::tempfile& c);
 
+      /**
+       * Generate the runtime filter.
+       */
+      void generate_filter (rld::process::tempfile& c);
+
       /**
        * Generate the functions.
        */
       void generate_functions (rld::process::tempfile& c);
 
       /**
-       * Generate the trace functions.
+       * Generate the trace functions for the traces from first up to but not
+       * including last.
        */
-      void generate_traces (rld::process::tempfile& c);
+      void generate_traces (rld::process::tempfile& c,
+                            size_t                  first,
+                            size_t                  last);
 
       /**
        * Generate a bitmap.
@@ -301,6 +390,11 @@ namespace rld
                             const std::string&      label,
                             const bool              global_set);
 
+      /**
+       * The number of 32bit words in a bitmap.
+       */
+      size_t bitmap_size () const;
+
       /**
        * Function macro replace.
        */
@@ -313,6 +407,11 @@ namespace rld
        */
       const function& find_function (const std::string& name) const;
 
+      /**
+       * Find the signature of a trace.
+       */
+      const signature& find_signature (const std::string& trace) const;
+
       /**
        * Get the traces.
        */
@@ -333,6 +432,19 @@ namespace rld
       options      options_;      /**< The options. */
       functions    functions_;    /**< The functions that can be traced. */
       generator    generator_;    /**< The tracer's generator. */
+      bool         pool;          /**< The names and types are pooled. */
+      string_pool  strings;       /**< The pool of names and types. */
+      std::vector < size_t > name_offsets; /**< The pool offset of each name. */
+      rld::strings sig_args;      /**< The signature argument table types. */
+      std::vector < size_t > sig_firsts;   /**< The first argument of each
+                                            *   trace's signature. */
+      std::vector < size_t > sig_argcs;    /**< The number of arguments of
+                                            *   each trace's signature. */
+      bool         filter;        /**< The runtime filter is generated. */
+      std::vector < uint32_t > filter_tasks; /**< The filter's task ids. */
+      size_t       filter_slots;  /**< The size of the filter's task set. */
+      uint32_t     filter_contexts; /**< The filter's context mask. */
+      uint32_t     filter_cpus;   /**< The filter's processor mask. */
     };
 
     /**
@@ -343,6 +455,11 @@ namespace rld
     public:
       linker ();
 
+      /**
+       * Delete the wrapper files.
+       */
+      ~linker ();
+
       /**
        * Load the user's configuration.
        */
@@ -351,21 +468,20 @@ namespace rld
                         const std::string& path);
 
       /**
-       * Generate the C file.
+       * Generate the header and C files. If the wrapper is not empty the
+       * files are kept using the wrapper as the base name.
        */
-      void generate_wrapper (rld::process::tempfile& c);
+      void generate_wrapper (const std::string& wrapper);
 
       /**
-       * Compile the C file.
+       * Compile the C files concurrently using any cached object files.
        */
-      void compile_wrapper (rld::process::tempfile& c,
-                            rld::process::tempfile& o);
+      void compile_wrapper ();
 
       /**
        * Link the application.
        */
-      void link (rld::process::tempfile& o,
-                 const std::string&      ld_cmds);
+      void link (const std::string& ld_cmds);
 
       /**
        * Dump the linker.
@@ -374,12 +490,56 @@ namespace rld
 
     private:
 
+      /**
+       * Delete the temporary files.
+       */
+      void clean_up ();
+
       rld::config::config    config;     /**< User configuration. */
       tracer                 tracer_;    /**< The tracer */
-      rld::process::tempfile c; /**< The C wrapper file */
-      rld::process::tempfile o; /**< The wrapper object file */
+      rld::process::tempfile h;          /**< The wrapper header file */
+      tempfiles              cs;         /**< The C wrapper files */
+      tempfiles              os;         /**< The wrapper object files */
     };
 
+    /**
+     * Hash the text using 64bit FNV-1a.
+     */
+    static uint64_t
+    hash_text (const std::string& text, uint64_t hash = 14695981039346656037ULL)
+    {
+      for (size_t t = 0; t < text.size (); ++t)
+      {
+        hash ^= (uint8_t) text[t];
+        hash *= 1099511628211ULL;
+      }
+      return hash;
+    }
+
+    /**
+     * Copy a file. The copy is written to a temporary name and renamed so a
+     * partially written copy is never seen.
+     */
+    static void
+    copy_file (const std::string& from, const std::string& to)
+    {
+      const std::string tmp = to + ".tmp";
+      std::ifstream     in (from.c_str (), std::ios_base::in | std::ios_base::binary);
+      if (!in.is_open ())
+        throw rld::error ("cannot open", "copy: " + from);
+      std::ofstream out (tmp.c_str (),
+                         std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      if (!out.is_open ())
+        throw rld::error ("cannot open", "copy: " + tmp);
+      out << in.rdbuf ();
+      out.close ();
+      if (!out.good () || (::rename (tmp.c_str (), to.c_str ()) < 0))
+      {
+        rld::path::unlink (tmp);
+        throw rld::error ("write failed", "copy: " + to);
+      }
+    }
+
     /**
      * Recursive parser for strings.
      */
@@ -601,6 +761,11 @@ namespace rld
        * # lock-acquire The wrapper code to acquire the lock.
        * # lock-release The wrapper code to release the lock.
        * # buffer-local The wrapper code to declare a buffer index local variable.
+       * # trace-check  A C expression that is true if the function could be
+       *                traced. It is evaluated without the lock held before the
+       *                entry and the exit trace code and if false the lock and
+       *                all trace code is skipped. The check needs to be quick
+       *                and only read the trace state.
        * # buffer-alloc The wrapper call made with a lock held if defined to allocate
        *                buffer space to hold the trace data. A suitable 32bit buffer
        *                index is returned. If there is no space an invalid index is
@@ -609,6 +774,15 @@ namespace rld
        *                making the alloc all.
        * # code-blocks  A list of code blcok section names.
        * # code         A code block in `<<CODE ... CODE` (without the single quote).
+       *                Code blocks are placed in one wrapper file and can define
+       *                data.
+       * # shared-blocks A list of shared code block section names.
+       * # shared       A code block in `<<CODE ... CODE` placed in the header
+       *                included by every wrapper file. Shared code can only
+       *                declare data and define inline functions. A generator
+       *                with code blocks and no shared code blocks cannot be
+       *                split over more than one wrapper file. The number of
+       *                trace functions is defined as `RTLD_TRACE_FUNCS`.
        * # includes     A list of files to include.
        *
        * The following macros can be used in specific wrapper calls. The lists of
@@ -666,6 +840,7 @@ namespace rld
       parse (config, section, "headers",     "header", headers);
       parse (config, section, "defines",     "define", defines);
       parse (config, section, "code-blocks", "code",   code, false);
+      parse (config, section, "shared-blocks", "shared", shared, false);
 
       if (section.has_record ("lock-model"))
         lock_model = rld::dequote (section.get_record_item ("lock-model"));
@@ -677,6 +852,8 @@ namespace rld
         lock_release = rld::dequote (section.get_record_item ("lock-release"));
       if (section.has_record ("buffer-local"))
         buffer_local = rld::dequote (section.get_record_item ("buffer-local"));
+      if (section.has_record ("trace-check"))
+        trace_check = rld::dequote (section.get_record_item ("trace-check"));
       if (section.has_record ("entry-trace"))
         entry_trace = rld::dequote (section.get_record_item ("entry-trace"));
       if (section.has_record ("entry-alloc"))
@@ -709,7 +886,8 @@ namespace rld
       {
         out << "    " << (*di) << std::endl;
       }
-      out << "   Arg Trace Code: " << arg_trace << std::endl
+      out << "   Trace Check Code: " << trace_check << std::endl
+          << "   Arg Trace Code: " << arg_trace << std::endl
           << "   Return Trace Code: " << ret_trace << std::endl
           << "   Code blocks: " << std::endl;
       for (rld::strings::const_iterator ci = code.begin ();
@@ -719,9 +897,54 @@ namespace rld
         out << "      > "
             << rld::find_replace (*ci, "\n", "\n      | ") << std::endl;
       }
+      out << "   Shared code blocks: " << std::endl;
+      for (rld::strings::const_iterator ci = shared.begin ();
+           ci != shared.end ();
+           ++ci)
+      {
+        out << "      > "
+            << rld::find_replace (*ci, "\n", "\n      | ") << std::endl;
+      }
+    }
+
+    size_t
+    string_pool::add (const std::string& str)
+    {
+      offsets::const_iterator oi = offsets_.find (str);
+      if (oi != offsets_.end ())
+        return (*oi).second;
+      size_t offset = strings_.size ();
+      strings_ += str;
+      strings_ += '\0';
+      offsets_[str] = offset;
+      return offset;
+    }
+
+    const std::string&
+    string_pool::strings () const
+    {
+      return strings_;
+    }
+
+    size_t
+    string_pool::size () const
+    {
+      return strings_.size ();
+    }
+
+    void
+    string_pool::clear ()
+    {
+      strings_.clear ();
+      offsets_.clear ();
     }
 
     tracer::tracer ()
+      : pool (false),
+        filter (false),
+        filter_slots (0),
+        filter_contexts (0),
+        filter_cpus (0)
     {
     }
 
@@ -830,6 +1053,14 @@ namespace rld
           {
             rld::rtems::set_arch_bsp(opt[0]);
           }
+          else if (opt.name == "jobs")
+          {
+            jobs = ::strtoul(opt[0].c_str (), 0, 0);
+          }
+          else if (opt.name == "wrapper-cache")
+          {
+            wrapper_cache = opt[0];
+          }
         }
       }
     }
@@ -922,58 +1153,494 @@ namespace rld
     }
 
     void
-    tracer::generate (rld::process::tempfile& c)
+    tracer::generate (rld::process::tempfile& h, tempfiles& cs)
     {
-      c.open (true);
+      h.open (true);
 
       if (rld::verbose ())
-        std::cout << "wrapper C file: " << c.name () << std::endl;
+        std::cout << "wrapper H file: " << h.name () << std::endl;
 
       try
       {
-        c.write_line ("/*");
-        c.write_line (" * RTEMS Trace Linker Wrapper");
-        c.write_line (" *  Automatically generated.");
-        c.write_line (" */");
-
-        c.write_line ("");
-        c.write_line ("/*");
-        c.write_line (" * Tracer: " + name);
-        c.write_line (" */");
-        c.write_lines (defines);
-
-        c.write_line ("");
-        c.write_line ("/*");
-        c.write_line (" * Generator: " + generator_.name);
-        c.write_line (" */");
-        c.write_lines (generator_.defines);
-        c.write_lines (generator_.headers);
-        c.write_line ("");
-        generate_functions (c);
-        generate_names (c);
-        generate_signatures (c);
-        generate_enables (c);
-        generate_triggers (c);
-        c.write_line ("");
-        c.write_lines (generator_.code);
-
-        generate_traces (c);
+        h.write_line ("/*");
+        h.write_line (" * RTEMS Trace Linker Wrapper Header");
+        h.write_line (" *  Automatically generated.");
+        h.write_line (" */");
+
+        h.write_line ("");
+        h.write_line ("/*");
+        h.write_line (" * Tracer: " + name);
+        h.write_line (" */");
+        h.write_lines (defines);
+
+        h.write_line ("");
+        h.write_line ("/*");
+        h.write_line (" * Generator: " + generator_.name);
+        h.write_line (" */");
+        h.write_lines (generator_.defines);
+        h.write_lines (generator_.headers);
+        h.write_line ("");
+        generate_functions (h);
+        build_pool ();
+        load_filter ();
+        generate_decls (h);
+        h.write_line ("");
+        h.write_lines (generator_.shared);
       }
       catch (...)
       {
-        c.close ();
+        h.close ();
         if (dump_on_error)
           dump (std::cout);
         throw;
       }
 
-      c.close ();
+      h.close ();
+
+      /*
+       * Split the traces over the C files after the first. If there is only
+       * one file it holds the traces.
+       */
+      size_t files = cs.size () > 1 ? cs.size () - 1 : 1;
+      size_t per_file = (traces.size () + files - 1) / files;
+
+      for (size_t f = 0; f < cs.size (); ++f)
+      {
+        rld::process::tempfile& c = *cs[f];
+
+        c.open (true);
+
+        if (rld::verbose ())
+          std::cout << "wrapper C file: " << c.name () << std::endl;
+
+        try
+        {
+          c.write_line ("#include \"" + h.name () + "\"");
+          c.write_line ("");
+          c.write_line ("/*");
+          c.write_line (" * RTEMS Trace Linker Wrapper");
+          c.write_line (" *  Automatically generated.");
+          c.write_line (" */");
+
+          if (f == 0)
+          {
+            generate_strings (c);
+            generate_names (c);
+            generate_signatures (c);
+            generate_enables (c);
+            generate_triggers (c);
+            generate_filter (c);
+            c.write_line ("");
+            c.write_lines (generator_.code);
+          }
+
+          if (cs.size () == 1)
+          {
+            generate_traces (c, 0, traces.size ());
+          }
+          else if (f > 0)
+          {
+            size_t first = (f - 1) * per_file;
+            size_t last = first + per_file;
+            if (first > traces.size ())
+              first = traces.size ();
+            if (last > traces.size ())
+              last = traces.size ();
+            generate_traces (c, first, last);
+          }
+        }
+        catch (...)
+        {
+          c.close ();
+          if (dump_on_error)
+            dump (std::cout);
+          throw;
+        }
+
+        c.close ();
+
+        if (rld::verbose (RLD_VERBOSE_DETAILS))
+        {
+          std::cout << "Generated C file:" << std::endl;
+          c.output (" ", std::cout, true);
+        }
+      }
 
       if (rld::verbose (RLD_VERBOSE_DETAILS))
       {
-        std::cout << "Generated C file:" << std::endl;
-        c.output (" ", std::cout, true);
+        std::cout << "Generated H file:" << std::endl;
+        h.output (" ", std::cout, true);
+      }
+    }
+
+    void
+    tracer::generate_decls (rld::process::tempfile& h)
+    {
+      std::stringstream sss;
+
+      h.write_line ("");
+      h.write_line ("/*");
+      h.write_line (" * Trace data.");
+      h.write_line (" */");
+
+      sss << "#define RTLD_TRACE_FUNCS " << traces.size ();
+      h.write_line (sss.str ());
+      sss.str (std::string ());
+
+      const bool names = get_option ("gen-names") != "disable";
+      const bool sigs = get_option ("gen-sigs") != "disable";
+
+      /*
+       * The 'gen-strings' option set to 'pool' places the names and the
+       * signature types in a string pool the tables reference by offset. The
+       * tables have no pointers so there are no relocations and a type is
+       * held once. Use the accessors to read the tables in either form.
+       */
+      if (pool && (names || sigs))
+      {
+        h.write_line ("");
+        sss.str (std::string ());
+        sss << "typedef " << (strings.size () <= 0xffff ? "uint16_t" : "uint32_t")
+            << " __rtld_trace_string_offset;" << std::endl
+            << "extern const char __rtld_trace_strings[" << strings.size () << "];";
+        h.write_line (sss.str ());
+      }
+
+      if (names)
+      {
+        sss.str (std::string ());
+        sss << "extern uint32_t __rtld_trace_names_size;" << std::endl;
+        if (pool)
+          sss << "extern const __rtld_trace_string_offset __rtld_trace_name_offsets["
+              << traces.size() << "];" << std::endl
+              << "static inline const char* __rtld_trace_name(uint32_t index)" << std::endl
+              << "{" << std::endl
+              << "  return &__rtld_trace_strings[__rtld_trace_name_offsets[index]];" << std::endl
+              << "}";
+        else
+          sss << "extern const char const* __rtld_trace_names[" << traces.size() << "];" << std::endl
+              << "static inline const char* __rtld_trace_name(uint32_t index)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_names[index];" << std::endl
+              << "}";
+        h.write_line (sss.str ());
+      }
+
+      if (sigs)
+      {
+        h.write_line ("");
+        if (pool)
+        {
+          sss.str (std::string ());
+          sss << "typedef " << (sig_args.size () <= 0xffff ? "uint16_t" : "uint32_t")
+              << " __rtld_trace_sig_index;";
+          h.write_line (sss.str ());
+          h.write_line ("");
+          h.write_line ("typedef struct {");
+          h.write_line (" uint32_t                   size;");
+          h.write_line (" __rtld_trace_string_offset type;");
+          h.write_line ("} __rtld_trace_sig_arg;");
+          h.write_line ("");
+          h.write_line ("typedef struct {");
+          h.write_line (" __rtld_trace_sig_index argc;");
+          h.write_line (" __rtld_trace_sig_index args;");
+          h.write_line ("} __rtld_trace_sig;");
+          h.write_line ("");
+          sss.str (std::string ());
+          sss << "extern const __rtld_trace_sig_arg __rtld_trace_sig_args["
+              << sig_args.size () << "];" << std::endl
+              << "extern const __rtld_trace_sig __rtld_trace_sig_table["
+              << traces.size () << "];" << std::endl
+              << "static inline uint32_t __rtld_trace_sig_argc(uint32_t index)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_sig_table[index].argc;" << std::endl
+              << "}" << std::endl
+              << "static inline uint32_t __rtld_trace_sig_arg_size(uint32_t index, uint32_t arg)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_sig_args[__rtld_trace_sig_table[index].args + arg].size;" << std::endl
+              << "}" << std::endl
+              << "static inline const char* __rtld_trace_sig_arg_type(uint32_t index, uint32_t arg)" << std::endl
+              << "{" << std::endl
+              << "  return &__rtld_trace_strings[__rtld_trace_sig_args[__rtld_trace_sig_table[index].args + arg].type];" << std::endl
+              << "}";
+          h.write_line (sss.str ());
+        }
+        else
+        {
+          h.write_line ("typedef struct {");
+          h.write_line (" uint32_t          size;");
+          h.write_line (" const char* const type;");
+          h.write_line ("} __rtld_trace_sig_arg;");
+          h.write_line ("");
+          h.write_line ("typedef struct {");
+          h.write_line (" uint32_t                    argc;");
+          h.write_line (" const __rtld_trace_sig_arg* args;");
+          h.write_line ("} __rtld_trace_sig;");
+          h.write_line ("");
+          sss.str (std::string ());
+          sss << "extern const __rtld_trace_sig __rtld_trace_signatures["
+              << traces.size () << "];" << std::endl
+              << "static inline uint32_t __rtld_trace_sig_argc(uint32_t index)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_signatures[index].argc;" << std::endl
+              << "}" << std::endl
+              << "static inline uint32_t __rtld_trace_sig_arg_size(uint32_t index, uint32_t arg)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_signatures[index].args[arg].size;" << std::endl
+              << "}" << std::endl
+              << "static inline const char* __rtld_trace_sig_arg_type(uint32_t index, uint32_t arg)" << std::endl
+              << "{" << std::endl
+              << "  return __rtld_trace_signatures[index].args[arg].type;" << std::endl
+              << "}";
+          h.write_line (sss.str ());
+        }
+      }
+
+      const char* bitmaps[2] = { "enables", "triggers" };
+
+      for (int b = 0; b < 2; ++b)
+      {
+        if (get_option (std::string ("gen-") + bitmaps[b]) != "disable")
+        {
+          sss.str (std::string ());
+          sss << "extern uint32_t __rtld_trace_" << bitmaps[b] << "_size;" << std::endl
+              << "extern const uint32_t __rtld_trace_" << bitmaps[b]
+              << "[" << bitmap_size () << "];";
+          h.write_line (sss.str ());
+        }
+      }
+
+      /*
+       * The filter is read at runtime by a generator's trace check so it can
+       * be changed while the application runs. A task set with no tasks
+       * passes every task.
+       */
+      if (filter)
+      {
+        h.write_line ("");
+        sss.str (std::string ());
+        sss << "#define RTLD_TRACE_FILTER 1" << std::endl
+            << "#define RTLD_TRACE_FILTER_TASKS " << filter_slots << std::endl
+            << "#define RTLD_TRACE_FILTER_THREAD (1 << 0)" << std::endl
+            << "#define RTLD_TRACE_FILTER_ISR    (1 << 1)" << std::endl
+            << "extern volatile uint32_t __rtld_trace_filter_task_count;" << std::endl
+            << "extern volatile uint32_t __rtld_trace_filter_tasks[RTLD_TRACE_FILTER_TASKS];" << std::endl
+            << "extern volatile uint32_t __rtld_trace_filter_contexts;" << std::endl
+            << "extern volatile uint32_t __rtld_trace_filter_cpus;";
+        h.write_line (sss.str ());
+      }
+    }
+
+    bool
+    tracer::can_split () const
+    {
+      return generator_.code.empty () || !generator_.shared.empty ();
+    }
+
+    void
+    tracer::load_filter ()
+    {
+      /*
+       * The options are:
+       *
+       *  # gen-filter         Set to 'enable' to generate the filter.
+       *  # filter-tasks       A comma separated list of task ids to trace.
+       *                       No tasks traces all tasks.
+       *  # filter-task-slots  The size of the task set so tasks can be added
+       *                       at runtime. The default is 8.
+       *  # filter-contexts    A comma separated list of 'thread' and 'isr'.
+       *                       The default is both.
+       *  # filter-cpus        A mask of the processors to trace. The default
+       *                       is all processors.
+       */
+      filter = get_option ("gen-filter") == "enable";
+
+      filter_tasks.clear ();
+      filter_slots = 8;
+      filter_contexts = (1 << 0) | (1 << 1);
+      filter_cpus = 0xffffffff;
+
+      if (!filter)
+        return;
+
+      rld::strings ss;
+      std::string  opt;
+
+      opt = get_option ("filter-tasks");
+      if (!opt.empty ())
+      {
+        rld::split (ss, opt, ',');
+        for (rld::strings::const_iterator si = ss.begin ();
+             si != ss.end ();
+             ++si)
+        {
+          char*    end;
+          uint32_t id = ::strtoul ((*si).c_str (), &end, 0);
+          if ((*end != '\0') || (id == 0))
+            throw rld::error ("invalid task id: " + *si, "filter-tasks");
+          filter_tasks.push_back (id);
+        }
+      }
+
+      opt = get_option ("filter-task-slots");
+      if (!opt.empty ())
+      {
+        char* end;
+        filter_slots = ::strtoul (opt.c_str (), &end, 0);
+        if ((*end != '\0') || (filter_slots == 0))
+          throw rld::error ("invalid number of slots: " + opt, "filter-task-slots");
+      }
+      if (filter_slots < filter_tasks.size ())
+        filter_slots = filter_tasks.size ();
+
+      opt = get_option ("filter-contexts");
+      if (!opt.empty ())
+      {
+        filter_contexts = 0;
+        ss.clear ();
+        rld::split (ss, opt, ',');
+        for (rld::strings::const_iterator si = ss.begin ();
+             si != ss.end ();
+             ++si)
+        {
+          if (*si == "thread")
+            filter_contexts |= 1 << 0;
+          else if (*si == "isr")
+            filter_contexts |= 1 << 1;
+          else
+            throw rld::error ("invalid context: " + *si, "filter-contexts");
+        }
+      }
+
+      opt = get_option ("filter-cpus");
+      if (!opt.empty ())
+      {
+        char* end;
+        filter_cpus = ::strtoul (opt.c_str (), &end, 0);
+        if (*end != '\0')
+          throw rld::error ("invalid processor mask: " + opt, "filter-cpus");
+      }
+
+      if (rld::verbose ())
+        std::cout << "filter: tasks: " << filter_tasks.size ()
+                  << " slots: " << filter_slots
+                  << " contexts: " << filter_contexts
+                  << " cpus: 0x" << std::hex << filter_cpus << std::dec
+                  << std::endl;
+    }
+
+    void
+    tracer::build_pool ()
+    {
+      pool = get_option ("gen-strings") == "pool";
+
+      strings.clear ();
+      name_offsets.clear ();
+      sig_args.clear ();
+      sig_firsts.clear ();
+      sig_argcs.clear ();
+
+      if (!pool)
+        return;
+
+      /*
+       * The names are first and in trace order so they are contiguous in the
+       * pool.
+       */
+      if (get_option ("gen-names") != "disable")
+      {
+        for (rld::strings::const_iterator ti = traces.begin ();
+             ti != traces.end ();
+             ++ti)
+          name_offsets.push_back (strings.add (*ti));
+      }
+
+      /*
+       * Signatures with the same return and argument types share their
+       * arguments in the argument table.
+       */
+      if (get_option ("gen-sigs") != "disable")
+      {
+        typedef std::map < rld::strings, size_t > arg_lists;
+
+        arg_lists lists;
+
+        for (rld::strings::const_iterator ti = traces.begin ();
+             ti != traces.end ();
+             ++ti)
+        {
+          const signature& sig = find_signature (*ti);
+          rld::strings     types;
+
+          types.push_back (sig.has_ret () ? sig.ret : "void");
+          if (sig.has_args ())
+            types.insert (types.end (), sig.args.begin (), sig.args.end ());
+          else
+            types.push_back ("void");
+
+          arg_lists::const_iterator li = lists.find (types);
+          size_t                    first;
+
+          if (li != lists.end ())
+          {
+            first = (*li).second;
+          }
+          else
+          {
+            first = sig_args.size ();
+            for (rld::strings::const_iterator ai = types.begin ();
+                 ai != types.end ();
+                 ++ai)
+            {
+              sig_args.push_back (*ai);
+              strings.add (*ai);
+            }
+            lists[types] = first;
+          }
+
+          sig_firsts.push_back (first);
+          sig_argcs.push_back (types.size ());
+        }
+      }
+
+      if (rld::verbose ())
+        std::cout << "string pool: strings: " << strings.size ()
+                  << " signature args: " << sig_args.size () << std::endl;
+    }
+
+    void
+    tracer::generate_strings (rld::process::tempfile& c)
+    {
+      if (!pool || (strings.size () == 0))
+        return;
+
+      c.write_line ("");
+      c.write_line ("/*");
+      c.write_line (" * Strings.");
+      c.write_line (" */");
+
+      std::stringstream sss;
+      sss << "const char __rtld_trace_strings[" << strings.size () << "] =";
+      c.write_line (sss.str ());
+
+      /*
+       * Each string is a literal ending with a nul so an escape does not
+       * join the next string. The array's size drops the final nul.
+       */
+      const std::string& pooled = strings.strings ();
+      size_t             offset = 0;
+
+      while (offset < pooled.size ())
+      {
+        size_t end = pooled.find ('\0', offset);
+        sss.str (std::string ());
+        sss << "  /* " << std::setw (5) << offset << " */ \""
+            << pooled.substr (offset, end - offset) << "\\0\"";
+        c.write_line (sss.str ());
+        offset = end + 1;
       }
+
+      c.write_line ("  ;");
     }
 
     void
@@ -990,6 +1657,27 @@ namespace rld
       c.write_line (" */");
 
       std::stringstream sss;
+
+      if (pool)
+      {
+        sss << "uint32_t __rtld_trace_names_size = " << traces.size() << ";" << std::endl
+            << "const __rtld_trace_string_offset __rtld_trace_name_offsets["
+            << traces.size() << "] = " << std::endl
+            << "{";
+        c.write_line (sss.str ());
+
+        for (size_t n = 0; n < name_offsets.size (); ++n)
+        {
+          sss.str (std::string ());
+          sss << "  /* " << std::setw (3) << n << " */ " << name_offsets[n]
+              << ", /* " << traces[n] << " */";
+          c.write_line (sss.str ());
+        }
+
+        c.write_line ("};");
+        return;
+      }
+
       sss << "uint32_t __rtld_trace_names_size = " << traces.size() << ";" << std::endl
           << "const char const* __rtld_trace_names[" << traces.size() << "] = " << std::endl
           << "{";
@@ -1024,19 +1712,51 @@ namespace rld
       c.write_line (" * Signatures.");
       c.write_line (" */");
       c.write_line ("");
-      c.write_line ("typedef struct {");
-      c.write_line (" uint32_t          size;");
-      c.write_line (" const char* const type;");
-      c.write_line ("} __rtld_trace_sig_arg;");
-      c.write_line ("");
-      c.write_line ("typedef struct {");
-      c.write_line (" uint32_t                    argc;");
-      c.write_line (" const __rtld_trace_sig_arg* args;");
-      c.write_line ("} __rtld_trace_sig;");
-      c.write_line ("");
 
       std::stringstream sss;
 
+      if (pool)
+      {
+        sss << "const __rtld_trace_sig_arg __rtld_trace_sig_args["
+            << sig_args.size () << "] =" << std::endl
+            << "{";
+        c.write_line (sss.str ());
+
+        for (rld::strings::const_iterator ai = sig_args.begin ();
+             ai != sig_args.end ();
+             ++ai)
+        {
+          const std::string& type = *ai;
+          sss.str (std::string ());
+          if (type == "void")
+            sss << "  { 0, ";
+          else
+            sss << "  { sizeof (" << type << "), ";
+          sss << strings.add (type) << " }, /* " << type << " */";
+          c.write_line (sss.str ());
+        }
+
+        c.write_line ("};");
+        c.write_line ("");
+
+        sss.str (std::string ());
+        sss << "const __rtld_trace_sig __rtld_trace_sig_table["
+            << traces.size () << "] =" << std::endl
+            << "{";
+        c.write_line (sss.str ());
+
+        for (size_t t = 0; t < traces.size (); ++t)
+        {
+          sss.str (std::string ());
+          sss << "  { " << sig_argcs[t] << ", " << sig_firsts[t]
+              << " }, /* " << traces[t] << " */";
+          c.write_line (sss.str ());
+        }
+
+        c.write_line ("};");
+        return;
+      }
+
       for (rld::strings::const_iterator ti = traces.begin ();
            ti != traces.end ();
            ++ti)
@@ -1166,6 +1886,49 @@ namespace rld
       c.write_line ("");
     }
 
+    void
+    tracer::generate_filter (rld::process::tempfile& c)
+    {
+      if (!filter)
+        return;
+
+      std::stringstream ss;
+
+      c.write_line ("");
+      c.write_line ("/*");
+      c.write_line (" * Filter.");
+      c.write_line (" */");
+
+      ss << "volatile uint32_t __rtld_trace_filter_task_count = "
+         << filter_tasks.size () << ";" << std::endl
+         << "volatile uint32_t __rtld_trace_filter_tasks[RTLD_TRACE_FILTER_TASKS] =" << std::endl
+         << "{" << std::endl;
+
+      if (filter_tasks.empty ())
+        ss << " 0";
+
+      /*
+       * The tasks, contexts and cpus are all hex masks or ids.
+       */
+      ss << std::hex << std::setfill ('0');
+
+      for (size_t t = 0; t < filter_tasks.size (); ++t)
+      {
+        if ((t > 0) && ((t % 4) == 0))
+          ss << std::endl;
+        ss << " 0x" << std::setw (8) << filter_tasks[t] << ',';
+      }
+
+      ss << std::endl
+         << "};" << std::endl
+         << "volatile uint32_t __rtld_trace_filter_contexts = 0x"
+         << std::setw (8) << filter_contexts << ";" << std::endl
+         << "volatile uint32_t __rtld_trace_filter_cpus = 0x"
+         << std::setw (8) << filter_cpus << ";";
+
+      c.write_line (ss.str ());
+    }
+
     void
     tracer::generate_functions (rld::process::tempfile& c)
     {
@@ -1201,16 +1964,18 @@ namespace rld
     }
 
     void
-    tracer::generate_traces (rld::process::tempfile& c)
+    tracer::generate_traces (rld::process::tempfile& c,
+                             size_t                  first,
+                             size_t                  last)
     {
       c.write_line ("/*");
       c.write_line (" * Wrappers.");
       c.write_line (" */");
 
-      size_t count = 0;
+      size_t count = first;
 
-      for (rld::strings::const_iterator ti = traces.begin ();
-           ti != traces.end ();
+      for (rld::strings::const_iterator ti = traces.begin () + first;
+           ti != traces.begin () + last;
            ++ti)
       {
         const std::string& trace = *ti;
@@ -1301,24 +2066,43 @@ namespace rld
               c.write_line(" " + sig.ret + " ret;");
 
             std::string l;
+            std::string check;
+            std::string in;
+
+            /*
+             * The check is made without the lock held so a function that is
+             * not being traced does not take the lock or run any trace code.
+             */
+            if (!generator_.trace_check.empty ())
+            {
+              check = generator_.trace_check;
+              macro_func_replace (check, sig, lss.str ());
+              in = "  ";
+            }
+
+            if (!check.empty ())
+            {
+              c.write_line(" if (" + check + ")");
+              c.write_line(" {");
+            }
 
             if (!generator_.lock_acquire.empty ())
-              c.write_line(generator_.lock_acquire);
+              c.write_line(in + generator_.lock_acquire);
 
             if (!generator_.entry_alloc.empty ())
             {
-              l = " " + generator_.entry_alloc;
+              l = in + " " + generator_.entry_alloc;
               macro_func_replace (l, sig, lss.str ());
               c.write_line(l);
             }
 
             if (!generator_.lock_release.empty () &&
                 (generator_.lock_model.empty () || (generator_.lock_model == "alloc")))
-              c.write_line(generator_.lock_release);
+              c.write_line(in + generator_.lock_release);
 
             if (!generator_.entry_trace.empty ())
             {
-              l = " " + generator_.entry_trace;
+              l = in + " " + generator_.entry_trace;
               macro_func_replace (l, sig, lss.str ());
               c.write_line(l);
             }
@@ -1328,7 +2112,7 @@ namespace rld
               for (size_t a = 0; a < sig.args.size (); ++a)
               {
                 std::string n = rld::to_string ((int) (a + 1));
-                l = " " + generator_.arg_trace;
+                l = in + " " + generator_.arg_trace;
                 l = rld::find_replace (l, "@ARG_NUM@", n);
                 l = rld::find_replace (l, "@ARG_TYPE@", '"' + sig.args[a] + '"');
                 l = rld::find_replace (l, "@ARG_SIZE@", "sizeof(" + sig.args[a] + ')');
@@ -1338,7 +2122,10 @@ namespace rld
             }
 
             if (!generator_.lock_release.empty () && generator_.lock_model == "trace")
-              c.write_line(generator_.lock_release);
+              c.write_line(in + generator_.lock_release);
+
+            if (!check.empty ())
+              c.write_line(" }");
 
             l.clear ();
 
@@ -1358,38 +2145,47 @@ namespace rld
             l += ");";
             c.write_line(l);
 
+            if (!check.empty ())
+            {
+              c.write_line(" if (" + check + ")");
+              c.write_line(" {");
+            }
+
             if (!generator_.lock_acquire.empty ())
-              c.write_line(generator_.lock_acquire);
+              c.write_line(in + generator_.lock_acquire);
 
             if (!generator_.exit_alloc.empty ())
             {
-              l = " " + generator_.exit_alloc;
+              l = in + " " + generator_.exit_alloc;
               macro_func_replace (l, sig, lss.str ());
               c.write_line(l);
             }
 
             if (!generator_.lock_release.empty () &&
                 (generator_.lock_model.empty () || (generator_.lock_model == "alloc")))
-              c.write_line(generator_.lock_release);
+              c.write_line(in + generator_.lock_release);
 
             if (!generator_.exit_trace.empty ())
             {
-              l = " " + generator_.exit_trace;
+              l = in + " " + generator_.exit_trace;
               macro_func_replace (l, sig, lss.str ());
               c.write_line(l);
             }
 
             if (sig.has_ret () && !generator_.ret_trace.empty ())
             {
-              std::string l = " " + generator_.ret_trace;
+              std::string l = in + " " + generator_.ret_trace;
               l = rld::find_replace (l, "@RET_TYPE@", '"' + sig.ret + '"');
               l = rld::find_replace (l, "@RET_SIZE@", "sizeof(" + sig.ret + ')');
               l = rld::find_replace (l, "@RET_LABEL@", "ret");
               c.write_line(l);
             }
 
-            if (!generator_.lock_release.empty ())
-              c.write_line(generator_.lock_release);
+            if (!generator_.lock_release.empty () && generator_.lock_model == "trace")
+              c.write_line(in + generator_.lock_release);
+
+            if (!check.empty ())
+              c.write_line(" }");
 
             if (sig.has_ret ())
               c.write_line(" return ret;");
@@ -1411,12 +2207,10 @@ namespace rld
                              const std::string&      label,
                              const bool              global_set)
     {
-      uint32_t bitmap_size = ((traces.size () - 1) / (4 * 8)) + 1;
-
       std::stringstream ss;
 
       ss << "uint32_t __rtld_trace_" << label << "_size = " << traces.size() << ";" << std::endl
-         << "const uint32_t __rtld_trace_" << label << "[" << bitmap_size << "] = " << std::endl
+         << "const uint32_t __rtld_trace_" << label << "[" << bitmap_size () << "] = " << std::endl
          << "{" << std::endl;
 
       size_t   count = 0;
@@ -1459,6 +2253,12 @@ namespace rld
       c.write_line ("};");
     }
 
+    size_t
+    tracer::bitmap_size () const
+    {
+      return ((traces.size () - 1) / (4 * 8)) + 1;
+    }
+
     void
     tracer::macro_func_replace (std::string&      text,
                                const signature&   sig,
@@ -1472,6 +2272,23 @@ namespace rld
       text = rld::find_replace (text, "@FUNC_DATA_RET_SIZE@", "FUNC_DATA_RET_SIZE_" + sig.name);
     }
 
+    const signature&
+    tracer::find_signature (const std::string& trace) const
+    {
+      for (functions::const_iterator fi = functions_.begin ();
+           fi != functions_.end ();
+           ++fi)
+      {
+        const function&            funcs = *fi;
+        signatures::const_iterator si = funcs.signatures_.find (trace);
+
+        if (si != funcs.signatures_.end ())
+          return (*si).second;
+      }
+
+      throw rld::error ("not found", "trace function: " + trace);
+    }
+
     const rld::strings&
     tracer::get_traces () const
     {
@@ -1501,7 +2318,24 @@ namespace rld
     }
 
     linker::linker ()
+      : h (".h")
+    {
+    }
+
+    linker::~linker ()
     {
+      clean_up ();
+    }
+
+    void
+    linker::clean_up ()
+    {
+      for (tempfiles::iterator ci = cs.begin (); ci != cs.end (); ++ci)
+        delete *ci;
+      for (tempfiles::iterator oi = os.begin (); oi != os.end (); ++oi)
+        delete *oi;
+      cs.clear ();
+      os.clear ();
     }
 
     void
@@ -1528,57 +2362,254 @@ namespace rld
     }
 
     void
-    linker::generate_wrapper (rld::process::tempfile& c)
+    linker::generate_wrapper (const std::string& wrapper)
     {
-      tracer_.generate (c);
+      /*
+       * One C file for the data and a C file for each of the remaining jobs
+       * so all the files are compiled at once. A single job is one C file.
+       */
+      size_t files = 1;
+
+      if (jobs > 1)
+      {
+        if (tracer_.can_split ())
+        {
+          size_t traces = tracer_.get_traces ().size ();
+          files = (jobs - 1 < traces ? jobs - 1 : traces) + 1;
+        }
+        else if (rld::verbose ())
+          std::cout << "wrapper: generator has code blocks and no shared code blocks, "
+                    << "not splitting" << std::endl;
+      }
+
+      clean_up ();
+
+      if (!wrapper.empty ())
+      {
+        h.override (wrapper);
+        h.keep ();
+      }
+
+      for (size_t f = 0; f < files; ++f)
+      {
+        cs.push_back (new rld::process::tempfile (".c"));
+        os.push_back (new rld::process::tempfile (".o"));
+
+        if (!wrapper.empty ())
+        {
+          std::string name = wrapper;
+          if (f > 0)
+            name += '-' + rld::to_string ((int) f);
+          cs.back ()->override (name);
+          cs.back ()->keep ();
+          os.back ()->override (name);
+          os.back ()->keep ();
+        }
+      }
+
+      tracer_.generate (h, cs);
     }
 
     void
-    linker::compile_wrapper (rld::process::tempfile& c,
-                             rld::process::tempfile& o)
+    linker::compile_wrapper ()
     {
-     rld::process::arg_container args;
-
-      if (rld::verbose ())
-        std::cout << "wrapper O file: " << o.name () << std::endl;
+      rld::process::arg_container args;
 
       rld::cc::make_cc_command (args);
       rld::cc::append_flags (rld::cc::ft_cflags, args);
 
       args.push_back ("-O2");
       args.push_back ("-g");
+
+      rld::process::arg_container cpp_args = args;
+
+      cpp_args.push_back ("-E");
       args.push_back ("-c");
-      args.push_back ("-o");
-      args.push_back (o.name ());
-      args.push_back (c.name ());
 
-      rld::process::tempfile out;
-      rld::process::tempfile err;
-      rld::process::status   status;
+      rld::process::jobs compiles;
+      rld::strings       cached;
+      rld::strings       keys;
+      tempfiles          outs;
 
-      status = rld::process::execute (rld::cc::get_cc (),
-                                      args,
-                                      out.name (),
-                                      err.name ());
+      try
+      {
+        /*
+         * The object file of a C file is cached by a hash of the compiler's
+         * version, the compiler command and the preprocessed C file, so a
+         * change to the compiler or to any header the C file includes is a
+         * miss. The names of the header and C files are temporary names and
+         * are removed from the preprocessed output.
+         */
+        if (!wrapper_cache.empty ())
+        {
+          if (!rld::path::check_directory (wrapper_cache))
+            throw rld::error ("not a directory: " + wrapper_cache, "wrapper cache");
+
+          rld::process::arg_container version_args;
+          rld::process::tempfile      out;
+          rld::process::tempfile      err;
+          rld::process::status        status;
+
+          rld::cc::make_cc_command (version_args);
+          version_args.push_back ("--version");
+
+          status = rld::process::execute (rld::cc::get_cc (),
+                                          version_args,
+                                          out.name (),
+                                          err.name ());
+          if ((status.type != rld::process::status::normal) ||
+              (status.code != 0))
+          {
+            err.output (rld::cc::get_cc (), std::cout);
+            throw rld::error ("Compiler error", "wrapper cache version");
+          }
 
-      if ((status.type != rld::process::status::normal) ||
-          (status.code != 0))
+          std::string version;
+          out.open ();
+          out.read (version);
+          out.close ();
+
+          uint64_t hash = hash_text (rld::join (args, " ") + '\n' + version);
+
+          rld::process::jobs preprocesses;
+
+          for (size_t f = 0; f < cs.size (); ++f)
+          {
+            outs.push_back (new rld::process::tempfile (".i"));
+            outs.push_back (new rld::process::tempfile);
+
+            rld::process::job job;
+
+            job.args = cpp_args;
+            job.args.push_back (cs[f]->name ());
+            job.outname = outs[outs.size () - 2]->name ();
+            job.errname = outs[outs.size () - 1]->name ();
+
+            preprocesses.push_back (job);
+          }
+
+          rld::process::execute (rld::cc::get_cc (), preprocesses, jobs);
+
+          for (size_t f = 0; f < cs.size (); ++f)
+          {
+            const rld::process::status& status = preprocesses[f].result;
+            if ((status.type != rld::process::status::normal) ||
+                (status.code != 0))
+            {
+              outs[(f * 2) + 1]->output (rld::cc::get_cc (), std::cout);
+              throw rld::error ("Compiler error", "preprocessing wrapper");
+            }
+
+            std::string text;
+            outs[f * 2]->open ();
+            outs[f * 2]->read (text);
+            outs[f * 2]->close ();
+
+            text = rld::find_replace (text, h.name (), "wrapper.h");
+            text = rld::find_replace (text, cs[f]->name (), "wrapper.c");
+
+            std::stringstream oss;
+            oss << std::hex << std::setfill ('0') << std::setw (16)
+                << hash_text (text, hash) << ".o";
+
+            keys.push_back (oss.str ());
+          }
+
+          for (tempfiles::iterator oi = outs.begin (); oi != outs.end (); ++oi)
+            delete *oi;
+          outs.clear ();
+        }
+
+        for (size_t f = 0; f < cs.size (); ++f)
+        {
+          rld::process::tempfile& c = *cs[f];
+          rld::process::tempfile& o = *os[f];
+
+          if (rld::verbose ())
+            std::cout << "wrapper O file: " << o.name () << std::endl;
+
+          std::string cache_o;
+
+          if (!wrapper_cache.empty ())
+          {
+            rld::path::path_join (wrapper_cache, keys[f], cache_o);
+
+            if (rld::path::check_file (cache_o))
+            {
+              if (rld::verbose ())
+                std::cout << "wrapper cache: hit: " << cache_o << std::endl;
+              copy_file (cache_o, o.name ());
+              cached.push_back (std::string ());
+              continue;
+            }
+
+            if (rld::verbose ())
+              std::cout << "wrapper cache: miss: " << cache_o << std::endl;
+          }
+
+          cached.push_back (cache_o);
+
+          outs.push_back (new rld::process::tempfile);
+          outs.push_back (new rld::process::tempfile);
+
+          rld::process::job job;
+
+          job.args = args;
+          job.args.push_back ("-o");
+          job.args.push_back (o.name ());
+          job.args.push_back (c.name ());
+          job.outname = outs[outs.size () - 2]->name ();
+          job.errname = outs[outs.size () - 1]->name ();
+
+          compiles.push_back (job);
+        }
+
+        rld::process::execute (rld::cc::get_cc (), compiles, jobs);
+
+        bool failed = false;
+
+        for (size_t j = 0; j < compiles.size (); ++j)
+        {
+          const rld::process::status& status = compiles[j].result;
+          if ((status.type != rld::process::status::normal) ||
+              (status.code != 0))
+          {
+            outs[(j * 2) + 1]->output (rld::cc::get_cc (), std::cout);
+            failed = true;
+          }
+        }
+
+        if (failed)
+        {
+          if (dump_on_error)
+            dump (std::cout);
+          throw rld::error ("Compiler error", "compiling wrapper");
+        }
+
+        for (size_t f = 0; f < cs.size (); ++f)
+        {
+          if (!cached[f].empty ())
+            copy_file (os[f]->name (), cached[f]);
+        }
+      }
+      catch (...)
       {
-        err.output (rld::cc::get_cc (), std::cout);
-        if (dump_on_error)
-          dump (std::cout);
-        throw rld::error ("Compiler error", "compiling wrapper");
+        for (tempfiles::iterator oi = outs.begin (); oi != outs.end (); ++oi)
+          delete *oi;
+        throw;
       }
+
+      for (tempfiles::iterator oi = outs.begin (); oi != outs.end (); ++oi)
+        delete *oi;
     }
 
     void
-    linker::link (rld::process::tempfile& o,
-                  const std::string&      ld_cmd)
+    linker::link (const std::string& ld_cmd)
     {
      rld::process::arg_container args;
 
       if (rld::verbose ())
-        std::cout << "linking: " << o.name () << std::endl;
+        std::cout << "linking: " << os.size () << " wrapper object(s)" << std::endl;
 
       std::string wrap = " -Wl,--wrap=";
 
@@ -1586,7 +2617,8 @@ namespace rld
 
       rld::process::args_append (args,
                                  wrap + rld::join (tracer_.get_traces (), wrap));
-      args.push_back (o.name ());
+      for (tempfiles::iterator oi = os.begin (); oi != os.end (); ++oi)
+        args.push_back ((*oi)->name ());
       rld::process::args_append (args, ld_cmd);
 
       rld::process::tempfile out;
@@ -1644,6 +2676,8 @@ static struct option rld_opts[] = {
   { "config",      required_argument,      NULL,           'C' },
   { "path",        required_argument,      NULL,           'P' },
   { "wrapper",     required_argument,      NULL,           'W' },
+  { "jobs",        required_argument,      NULL,           'j' },
+  { "cache",       required_argument,      NULL,           'H' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -1666,7 +2700,10 @@ usage (int exit_code)
             << " -B bsp      : RTEMS arch/bsp (also --rtems-bsp)" << std::endl
             << " -W wrapper  : wrapper file name without ext (also --wrapper)" << std::endl
             << " -C ini      : user configuration INI file (also --config)" << std::endl
-            << " -P path     : user configuration file search path (also --path)" << std::endl;
+            << " -P path     : user configuration file search path (also --path)" << std::endl
+            << " -j jobs     : split the wrappers over jobs files compiled concurrently" << std::endl
+            << "               (also --jobs)" << std::endl
+            << " -H path     : wrapper object file cache directory (also --cache)" << std::endl;
   ::exit (exit_code);
 }
 
@@ -1723,12 +2760,14 @@ main (int argc, char* argv[])
     std::string        wrapper;
     std::string        rtems_path;
     std::string        rtems_arch_bsp;
+    size_t             jobs = 0;
+    std::string        cache;
 
     rld::set_cmdline (argc, argv);
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvwkVc:l:E:f:C:P:r:B:W:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvwkVc:l:E:f:C:P:r:B:W:j:H:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -1793,6 +2832,14 @@ main (int argc, char* argv[])
           wrapper = optarg;
           break;
 
+        case 'j':
+          jobs = ::strtoul (optarg, 0, 0);
+          break;
+
+        case 'H':
+          cache = optarg;
+          break;
+
         case '?':
           usage (3);
           break;
@@ -1866,20 +2913,17 @@ main (int argc, char* argv[])
     {
       linker.load_config (configuration, trace, path);
 
-      rld::process::tempfile c (".c");
-      rld::process::tempfile o (".o");
-
-      if (!wrapper.empty ())
-      {
-        c.override (wrapper);
-        c.keep ();
-        o.override (wrapper);
-        o.keep ();
-      }
-
-      linker.generate_wrapper (c);
-      linker.compile_wrapper (c, o);
-      linker.link (o, ld_cmd);
+      /*
+       * The command line overrides the configuration's options.
+       */
+      if (jobs)
+        rld::trace::jobs = jobs;
+      if (!cache.empty ())
+        rld::trace::wrapper_cache = cache;
+
+      linker.generate_wrapper (wrapper);
+      linker.compile_wrapper ();
+      linker.link (ld_cmd);
 
       if (rld::verbose ())
         linker.dump (std::cout);
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Trace Linker wrapper overhead benchmark host services.
+ *
+ * The host replacements for the RTEMS services the trace buffer generator's
+ * wrappers use. The interrupt lock is a spin lock and the uptime is the
+ * host's monotonic clock. The interrupt state and the processor are set by
+ * the benchmark.
+ */
+
+#if !defined(_RTLD_TRACE_BENCH_RTEMS_H_)
+#define _RTLD_TRACE_BENCH_RTEMS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+typedef volatile int rtems_interrupt_lock;
+typedef int          rtems_interrupt_lock_context;
+
+#define RTEMS_INTERRUPT_LOCK_DECLARE(_qualifier, _name) \
+  _qualifier rtems_interrupt_lock _name
+#define RTEMS_INTERRUPT_LOCK_DEFINE(_qualifier, _name, _label) \
+  _qualifier rtems_interrupt_lock _name = 0
+
+#define rtems_interrupt_lock_acquire(_l, _c) \
+  do { (void) (_c); while (__atomic_exchange_n(_l, 1, __ATOMIC_ACQUIRE)); } while (0)
+#define rtems_interrupt_lock_release(_l, _c) \
+  do { (void) (_c); __atomic_store_n(_l, 0, __ATOMIC_RELEASE); } while (0)
+
+extern bool     rtld_bench_isr;
+extern uint32_t rtld_bench_cpu;
+
+#define rtems_interrupt_is_in_progress() rtld_bench_isr
+#define rtems_get_current_processor()    rtld_bench_cpu
+
+static inline uint64_t rtems_clock_get_uptime_nanoseconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+#endif
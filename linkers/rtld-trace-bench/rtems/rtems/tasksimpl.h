@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Trace Linker wrapper overhead benchmark host thread.
+ *
+ * The fields of the executing thread the trace buffer generator's wrappers
+ * read. The executing thread is set by the benchmark.
+ */
+
+#if !defined(_RTLD_TRACE_BENCH_TASKSIMPL_H_)
+#define _RTLD_TRACE_BENCH_TASKSIMPL_H_
+
+#include <rtems.h>
+
+struct Thread_Control
+{
+  struct
+  {
+    uint32_t id;
+  } Object;
+  uint32_t current_priority;
+  uint32_t real_priority;
+  uint32_t current_state;
+};
+
+extern struct Thread_Control rtld_bench_executing;
+
+static inline struct Thread_Control* _Thread_Get_executing(void)
+{
+  return &rtld_bench_executing;
+}
+
+#endif
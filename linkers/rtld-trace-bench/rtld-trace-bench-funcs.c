@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Trace Linker wrapper overhead benchmark functions.
+ *
+ * The traced functions are in a separate file so the calls from the benchmark
+ * are references the linker wraps.
+ */
+
+#include <rtems/rtems/tasksimpl.h>
+
+/*
+ * The host context the generated wrappers read.
+ */
+struct Thread_Control rtld_bench_executing = { { 0x0a010001 }, 1, 1, 0 };
+bool                  rtld_bench_isr;
+uint32_t              rtld_bench_cpu;
+
+int bench_on(int a1)
+{
+  __asm__ __volatile__("" : : : "memory");
+  return a1 + 1;
+}
+
+int bench_off(int a1)
+{
+  __asm__ __volatile__("" : : : "memory");
+  return a1 + 1;
+}
+
+int bench_direct(int a1)
+{
+  __asm__ __volatile__("" : : : "memory");
+  return a1 + 1;
+}
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Trace Linker wrapper overhead benchmark.
+ *
+ * A host benchmark of the overhead of the trace buffer generator's wrappers.
+ * The wrappers are generated by rtems-tld from rtld-trace-bench.ini and built
+ * with the host compiler. The headers in this directory replace the RTEMS
+ * interrupt lock with a host spin lock and the uptime with the host's
+ * monotonic clock. The wrapper of 'bench_on' is enabled and the wrapper of
+ * 'bench_off' is not. The wrappers check the runtime task, context and
+ * processor filter before taking the lock and 'bench_on' is timed with the
+ * filter passing and rejecting the call. The filter the generator defines
+ * with no tasks and the filter cases are checked before the timing starts.
+ *
+ * Usage: rtld-trace-bench [calls]
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <rtems/rtems/tasksimpl.h>
+
+/*
+ * The generated trace data the benchmark accesses.
+ */
+#define RTLD_TRACE_FILTER_TASKS  8
+#define RTLD_TRACE_FILTER_THREAD (1 << 0)
+#define RTLD_TRACE_FILTER_ISR    (1 << 1)
+
+extern volatile uint32_t __rtld_trace_filter_task_count;
+extern volatile uint32_t __rtld_trace_filter_tasks[RTLD_TRACE_FILTER_TASKS];
+extern volatile uint32_t __rtld_trace_filter_contexts;
+extern volatile uint32_t __rtld_trace_filter_cpus;
+
+extern volatile uint32_t __rtld_tbg_buffer_in;
+extern volatile bool     __rtld_tbg_finished;
+
+/*
+ * The traced functions and the function that is not wrapped.
+ */
+int bench_on(int a1);
+int bench_off(int a1);
+int bench_direct(int a1);
+
+/*
+ * The calls between restarting the buffer. A call records an entry and an
+ * exit record and the buffer holds more than this many calls.
+ */
+#define BENCH_CALLS_PER_BUFFER 1024
+
+typedef int (*function)(int a1);
+
+/*
+ * A filter case. The filter is set, the context is set and the enabled
+ * function is called once.
+ */
+typedef struct
+{
+  const char* label;
+  uint32_t    tasks;      /* the number of tasks in the set */
+  uint32_t    contexts;
+  uint32_t    cpus;
+  uint32_t    id;
+  bool        isr;
+  uint32_t    cpu;
+  bool        recorded;
+} filter_case;
+
+static const filter_case filter_cases[] =
+{
+  { "any task",          0, 3, 0xffffffff, 0x0a010009, false, 0, true  },
+  { "task in set",       2, 3, 0xffffffff, 0x0a010002, false, 0, true  },
+  { "task not in set",   2, 3, 0xffffffff, 0x0a010009, false, 0, false },
+  { "isr with task set", 2, 3, 0xffffffff, 0x0a010009, true,  0, true  },
+  { "isr masked",        0, 1, 0xffffffff, 0x0a010001, true,  0, false },
+  { "thread masked",     0, 2, 0xffffffff, 0x0a010001, false, 0, false },
+  { "cpu in mask",       0, 3, 0x00000002, 0x0a010001, false, 1, true  },
+  { "cpu not in mask",   0, 3, 0x00000002, 0x0a010001, false, 0, false },
+  { "cpu above mask",    0, 3, 0x00000001, 0x0a010001, false, 40, true }
+};
+
+static void set_filter(uint32_t tasks, uint32_t contexts, uint32_t cpus)
+{
+  uint32_t t;
+  for (t = 0; t < RTLD_TRACE_FILTER_TASKS; ++t)
+    __rtld_trace_filter_tasks[t] = t < tasks ? 0x0a010001 + t : 0;
+  __rtld_trace_filter_task_count = tasks;
+  __rtld_trace_filter_contexts = contexts;
+  __rtld_trace_filter_cpus = cpus;
+}
+
+static void set_context(uint32_t id, bool isr, uint32_t cpu)
+{
+  rtld_bench_executing.Object.id = id;
+  rtld_bench_isr = isr;
+  rtld_bench_cpu = cpu;
+}
+
+static void restart_buffer(void)
+{
+  __rtld_tbg_buffer_in = 0;
+  __rtld_tbg_finished = false;
+}
+
+/*
+ * Check the filter the generator defines. There are no tasks in the set and
+ * all contexts and processors are traced.
+ */
+static int check_generated_filter(void)
+{
+  int failures = 0;
+  if (__rtld_trace_filter_task_count != 0)
+  {
+    printf("filter: generated task count: %u\n",
+           (unsigned int) __rtld_trace_filter_task_count);
+    ++failures;
+  }
+  if (__rtld_trace_filter_contexts !=
+      (RTLD_TRACE_FILTER_THREAD | RTLD_TRACE_FILTER_ISR))
+  {
+    printf("filter: generated contexts: 0x%08x\n",
+           (unsigned int) __rtld_trace_filter_contexts);
+    ++failures;
+  }
+  if (__rtld_trace_filter_cpus != 0xffffffff)
+  {
+    printf("filter: generated cpus: 0x%08x\n",
+           (unsigned int) __rtld_trace_filter_cpus);
+    ++failures;
+  }
+  return failures;
+}
+
+/*
+ * Check the filter cases. A recorded call writes an entry and an exit record.
+ */
+static int check_filter(void)
+{
+  size_t c;
+  int    failures = 0;
+  for (c = 0; c < sizeof(filter_cases) / sizeof(filter_cases[0]); ++c)
+  {
+    const filter_case* fc = &filter_cases[c];
+    bool               recorded;
+    set_filter(fc->tasks, fc->contexts, fc->cpus);
+    set_context(fc->id, fc->isr, fc->cpu);
+    restart_buffer();
+    bench_on(0);
+    recorded = __rtld_tbg_buffer_in != 0;
+    if (recorded != fc->recorded)
+    {
+      printf("filter: %s: failed\n", fc->label);
+      ++failures;
+    }
+  }
+  restart_buffer();
+  bench_off(0);
+  if (__rtld_tbg_buffer_in != 0)
+  {
+    printf("filter: disabled function recorded\n");
+    ++failures;
+  }
+  set_filter(0, RTLD_TRACE_FILTER_THREAD | RTLD_TRACE_FILTER_ISR, 0xffffffff);
+  set_context(0x0a010001, false, 0);
+  return failures;
+}
+
+/*
+ * Time the calls and return the nanoseconds per call. The buffer is
+ * restarted so each enabled call writes its records.
+ */
+static double bench(function func, unsigned long calls)
+{
+  uint64_t      start;
+  uint64_t      end;
+  unsigned long c = 0;
+  volatile int  sum = 0;
+  start = rtems_clock_get_uptime_nanoseconds();
+  while (c < calls)
+  {
+    unsigned long chunk = calls - c;
+    if (chunk > BENCH_CALLS_PER_BUFFER)
+      chunk = BENCH_CALLS_PER_BUFFER;
+    restart_buffer();
+    for (; chunk > 0; --chunk, ++c)
+      sum += func((int) c);
+  }
+  end = rtems_clock_get_uptime_nanoseconds();
+  return (double) (end - start) / calls;
+}
+
+int main(int argc, char* argv[])
+{
+  unsigned long calls = 10000000;
+
+  if (argc > 1)
+    calls = strtoul(argv[1], NULL, 0);
+  if (calls == 0)
+  {
+    fprintf(stderr, "usage: rtld-trace-bench [calls]\n");
+    return 1;
+  }
+
+  if (check_generated_filter() != 0)
+    return 1;
+
+  /*
+   * Call the trigger so the trace is running.
+   */
+  bench_on(0);
+
+  if (check_filter() != 0)
+    return 1;
+
+  printf("calls: %lu\n", calls);
+  printf("no wrapper        : %8.2f ns/call\n", bench(bench_direct, calls));
+  printf("enabled           : %8.2f ns/call\n", bench(bench_on, calls));
+  printf("disabled          : %8.2f ns/call\n", bench(bench_off, calls));
+  set_filter(4, RTLD_TRACE_FILTER_THREAD, 0xffffffff);
+  set_context(0x0a010004, false, 0);
+  printf("filter   pass     : %8.2f ns/call\n", bench(bench_on, calls));
+  set_context(0x0a010009, false, 0);
+  printf("filter   reject   : %8.2f ns/call\n", bench(bench_on, calls));
+
+  return 0;
+}
@@ -156,6 +156,11 @@ class execute(object):
                             if encoding:
                                 lines = bytes(lines, sys.stdin.encoding)
                             fh.write(lines)
+                            #
+                            # The stdin pipe is buffered, flush so the
+                            # process sees the input as it is written.
+                            #
+                            fh.flush()
                         except:
                             break
                     if lines == None or \
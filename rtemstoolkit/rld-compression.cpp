@@ -34,6 +34,7 @@
 
 #include <rld.h>
 #include <rld-compression.h>
+#include <rld-crc.h>
 
 #include "fastlz.h"
 
@@ -44,16 +45,19 @@ namespace rld
     compressor::compressor (files::image& image,
                             size_t        size,
                             bool          out,
-                            bool          compress)
+                            bool          compress,
+                            bool          checksum)
       : image (image),
         size (size),
         out (out),
         compress (compress),
+        checksum (checksum),
         buffer (0),
         io (0),
         level (0),
         total (0),
-        total_compressed (0)
+        total_compressed (0),
+        image_crc (0)
     {
       if (size > 0xffff)
         throw rld::error ("Size too big, 16 bits only", "compression");
@@ -231,6 +235,12 @@ namespace rld
       return total;
     }
 
+    uint32_t
+    compressor::crc () const
+    {
+      return image_crc;
+    }
+
     void
     compressor::output (bool forced)
     {
@@ -252,10 +262,36 @@ namespace rld
           image.write (io, writing);
 
           total_compressed += 2 + writing;
+
+          if (checksum)
+          {
+            uint32_t block_crc;
+            uint8_t  trailer[4];
+
+            block_crc = crc::crc32c (0, header, 2);
+            block_crc = crc::crc32c (block_crc, io, writing);
+
+            trailer[0] = block_crc >> 24;
+            trailer[1] = block_crc >> 16;
+            trailer[2] = block_crc >> 8;
+            trailer[3] = block_crc;
+
+            image.write (trailer, 4);
+
+            total_compressed += 4;
+
+            image_crc = crc::crc32c (image_crc, header, 2);
+            image_crc = crc::crc32c (image_crc, io, writing);
+            image_crc = crc::crc32c (image_crc, trailer, 4);
+          }
         }
         else
         {
           image.write (buffer, level);
+          total_compressed += level;
+
+          if (checksum)
+            image_crc = crc::crc32c (image_crc, buffer, level);
         }
 
         level = 0;
@@ -288,13 +324,44 @@ namespace rld
             if (image.read (io, block_size) != block_size)
               throw rld::error ("Read past end", "compression");
 
+            if (checksum)
+            {
+              uint8_t trailer[4];
+
+              if (image.read (trailer, 4) != 4)
+                throw rld::error ("Read past end", "compression");
+
+              total_compressed += 4;
+
+              uint32_t block_crc;
+
+              block_crc = crc::crc32c (0, header, 2);
+              block_crc = crc::crc32c (block_crc, io, block_size);
+
+              if (block_crc != ((((uint32_t) trailer[0]) << 24) |
+                                (((uint32_t) trailer[1]) << 16) |
+                                (((uint32_t) trailer[2]) << 8) |
+                                (uint32_t) trailer[3]))
+                throw rld::error ("Block checksum error: offset=" +
+                                  rld::to_string (total_compressed -
+                                                  block_size - 6),
+                                  "compression");
+
+              image_crc = crc::crc32c (image_crc, header, 2);
+              image_crc = crc::crc32c (image_crc, io, block_size);
+              image_crc = crc::crc32c (image_crc, trailer, 4);
+            }
+
             level = ::fastlz_decompress (io, block_size, buffer, size);
           }
         }
         else
         {
-          image.read (buffer, size);
-          level = size;
+          level = image.read (buffer, size);
+          total_compressed += level;
+
+          if (checksum)
+            image_crc = crc::crc32c (image_crc, buffer, level);
         }
       }
     }
@@ -44,11 +44,15 @@ namespace rld
        * @param size The size of the input and output buffers.
        * @param out The compressor is compressing.
        * @param compress Set to false to disable compression.
+       * @param checksum Set to true to checksum the data transferred. A
+       *                 compressed block is followed by the CRC32C of the
+       *                 block header and the compressed data.
        */
       compressor (files::image& image,
                   size_t        size,
                   bool          out = true,
-                  bool          compress = true);
+                  bool          compress = true,
+                  bool          checksum = false);
 
       /**
        * Destruct the compressor.
@@ -130,6 +134,14 @@ namespace rld
        */
       off_t offset () const;
 
+      /**
+       * The CRC32C of the data transferred to or from the image. The CRC is
+       * only valid if the compressor checksums the data.
+       *
+       * @return uint32_t The CRC32C of the image data.
+       */
+      uint32_t crc () const;
+
     private:
 
       /**
@@ -148,6 +160,7 @@ namespace rld
       size_t        size;             //< The size of the buffer.
       bool          out;              //< If true the it is compression.
       bool          compress;         //< If true compress the data.
+      bool          checksum;         //< If true checksum the data.
       uint8_t*      buffer;           //< The decompressed buffer
       uint8_t*      io;               //< The I/O buffer.
       size_t        level;            //< The amount of data in the buffer.
@@ -155,6 +168,7 @@ namespace rld
                                       //  transferred.
       size_t        total_compressed; //< The amount of compressed data
                                       //  transferred.
+      uint32_t      image_crc;        //< The CRC32C of the image data.
     };
 
     /**
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker CRC32C checksums.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <rld-crc.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define RLD_CRC_SSE42 1
+#include <nmmintrin.h>
+#endif
+
+#if defined (__aarch64__) && defined (__ARM_FEATURE_CRC32) && \
+    !defined (__ARM_BIG_ENDIAN)
+#define RLD_CRC_ARMV8 1
+#include <arm_acle.h>
+#endif
+
+namespace rld
+{
+  namespace crc
+  {
+    /**
+     * The reflected CRC32C polynomial.
+     */
+    static const uint32_t polynomial = 0x82f63b78;
+
+    /**
+     * The tables for the checksum of eight bytes a loop. The first table is
+     * the checksum of a byte and each following table is the checksum of a
+     * byte followed by a zero byte.
+     */
+    static uint32_t tables[8][256];
+    static bool     tables_valid = false;
+
+    static void
+    make_tables ()
+    {
+      for (uint32_t b = 0; b < 256; ++b)
+      {
+        uint32_t c = b;
+        for (int bit = 0; bit < 8; ++bit)
+          c = (c >> 1) ^ ((c & 1) ? polynomial : 0);
+        tables[0][b] = c;
+      }
+
+      for (uint32_t b = 0; b < 256; ++b)
+        for (int t = 1; t < 8; ++t)
+          tables[t][b] =
+            (tables[t - 1][b] >> 8) ^ tables[0][tables[t - 1][b] & 0xff];
+
+      tables_valid = true;
+    }
+
+    static uint32_t
+    crc32c_tables (uint32_t crc, const uint8_t* data, size_t length)
+    {
+      if (!tables_valid)
+        make_tables ();
+
+      while (length >= 8)
+      {
+        uint32_t lo = crc ^ (((uint32_t) data[0]) |
+                             (((uint32_t) data[1]) << 8) |
+                             (((uint32_t) data[2]) << 16) |
+                             (((uint32_t) data[3]) << 24));
+        uint32_t hi = (((uint32_t) data[4]) |
+                       (((uint32_t) data[5]) << 8) |
+                       (((uint32_t) data[6]) << 16) |
+                       (((uint32_t) data[7]) << 24));
+        crc = (tables[7][lo & 0xff] ^
+               tables[6][(lo >> 8) & 0xff] ^
+               tables[5][(lo >> 16) & 0xff] ^
+               tables[4][lo >> 24] ^
+               tables[3][hi & 0xff] ^
+               tables[2][(hi >> 8) & 0xff] ^
+               tables[1][(hi >> 16) & 0xff] ^
+               tables[0][hi >> 24]);
+        data += 8;
+        length -= 8;
+      }
+
+      while (length--)
+        crc = (crc >> 8) ^ tables[0][(crc ^ *data++) & 0xff];
+
+      return crc;
+    }
+
+#if RLD_CRC_SSE42
+    __attribute__ ((target ("sse4.2"))) static uint32_t
+    crc32c_sse42 (uint32_t crc, const uint8_t* data, size_t length)
+    {
+#if defined (__x86_64__)
+      uint64_t crc64 = crc;
+      while (length >= 8)
+      {
+        uint64_t value;
+        ::memcpy (&value, data, sizeof (value));
+        crc64 = _mm_crc32_u64 (crc64, value);
+        data += 8;
+        length -= 8;
+      }
+      crc = (uint32_t) crc64;
+#endif
+      while (length >= 4)
+      {
+        uint32_t value;
+        ::memcpy (&value, data, sizeof (value));
+        crc = _mm_crc32_u32 (crc, value);
+        data += 4;
+        length -= 4;
+      }
+      while (length--)
+        crc = _mm_crc32_u8 (crc, *data++);
+      return crc;
+    }
+
+    static bool
+    have_sse42 ()
+    {
+      static int have = -1;
+      if (have < 0)
+      {
+        __builtin_cpu_init ();
+        have = __builtin_cpu_supports ("sse4.2") ? 1 : 0;
+      }
+      return have != 0;
+    }
+#endif
+
+#if RLD_CRC_ARMV8
+    static uint32_t
+    crc32c_armv8 (uint32_t crc, const uint8_t* data, size_t length)
+    {
+      while (length >= 8)
+      {
+        uint64_t value;
+        ::memcpy (&value, data, sizeof (value));
+        crc = __crc32cd (crc, value);
+        data += 8;
+        length -= 8;
+      }
+      while (length--)
+        crc = __crc32cb (crc, *data++);
+      return crc;
+    }
+#endif
+
+    uint32_t
+    crc32c (uint32_t crc, const void* data_, size_t length)
+    {
+      const uint8_t* data = static_cast < const uint8_t* > (data_);
+
+      crc = ~crc;
+
+#if RLD_CRC_SSE42
+      if (have_sse42 ())
+        return ~crc32c_sse42 (crc, data, length);
+#endif
+#if RLD_CRC_ARMV8
+      return ~crc32c_armv8 (crc, data, length);
+#endif
+
+      return ~crc32c_tables (crc, data, length);
+    }
+
+    const char*
+    crc32c_method ()
+    {
+#if RLD_CRC_SSE42
+      if (have_sse42 ())
+        return "SSE4.2";
+#endif
+#if RLD_CRC_ARMV8
+      return "ARMv8";
+#endif
+      return "tables";
+    }
+  }
+}
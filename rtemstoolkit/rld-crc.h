@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker CRC32C checksums.
+ *
+ * The CRC32C (Castagnoli) checksum is used to check the integrity of RAP
+ * images. The SSE4.2 CRC32 instruction is used on x86 hosts that have it and
+ * the ARMv8 CRC32C instructions are used on AArch64 hosts built with the CRC
+ * extension. Other hosts use a table driven checksum that handles eight
+ * bytes a loop.
+ */
+
+#if !defined (_RLD_CRC_H_)
+#define _RLD_CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rld
+{
+  namespace crc
+  {
+    /**
+     * Update the CRC32C of the data. The CRC of no data is 0 and a checksum
+     * can be calculated in parts by passing the CRC of the previous part.
+     *
+     * @param crc The CRC of the data before this data.
+     * @param data The data to checksum.
+     * @param length The length of the data in bytes.
+     * @return uint32_t The CRC of the data.
+     */
+    uint32_t crc32c (uint32_t crc, const void* data, size_t length);
+
+    /**
+     * The name of the CRC32C method used on this host.
+     *
+     * @return const char* The method's name.
+     */
+    const char* crc32c_method ();
+  }
+}
+
+#endif
@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker DWARF line tables.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+
+#include <string.h>
+
+#include <rld.h>
+#include <rld-dwarf.h>
+
+namespace rld
+{
+  namespace dwarf
+  {
+    /**
+     * The standard opcodes of the line number program.
+     */
+    static const uint8_t lns_copy = 1;
+    static const uint8_t lns_advance_pc = 2;
+    static const uint8_t lns_advance_line = 3;
+    static const uint8_t lns_set_file = 4;
+    static const uint8_t lns_const_add_pc = 8;
+    static const uint8_t lns_fixed_advance_pc = 9;
+
+    /**
+     * The extended opcodes of the line number program.
+     */
+    static const uint8_t lne_end_sequence = 1;
+    static const uint8_t lne_set_address = 2;
+
+    /**
+     * The content types and forms of the DWARF 5 directory and file entries.
+     */
+    static const uint64_t lnct_path = 1;
+    static const uint64_t lnct_directory_index = 2;
+
+    static const uint64_t form_block = 0x09;
+    static const uint64_t form_data1 = 0x0b;
+    static const uint64_t form_data2 = 0x05;
+    static const uint64_t form_data4 = 0x06;
+    static const uint64_t form_data8 = 0x07;
+    static const uint64_t form_data16 = 0x1e;
+    static const uint64_t form_line_strp = 0x1f;
+    static const uint64_t form_string = 0x08;
+    static const uint64_t form_strp = 0x0e;
+    static const uint64_t form_udata = 0x0f;
+
+    /**
+     * A file index that is not valid.
+     */
+    static const uint32_t no_file = ~((uint32_t) 0);
+
+    /**
+     * A section's data.
+     */
+    struct section_data
+    {
+      const uint8_t* data;
+      size_t         size;
+
+      section_data ()
+        : data (0),
+          size (0) {
+      }
+    };
+
+    /**
+     * Read the data of a section in the file's byte order. Reading past the
+     * end throws an error.
+     */
+    class reader
+    {
+    public:
+      reader (const section_data& sec, bool big_endian)
+        : sec (sec),
+          big_endian (big_endian),
+          off (0) {
+      }
+
+      bool end () const {
+        return off >= sec.size;
+      }
+
+      size_t offset () const {
+        return off;
+      }
+
+      void seek (size_t offset) {
+        if (offset > sec.size)
+          throw rld::error ("Section truncated", "dwarf:lines");
+        off = offset;
+      }
+
+      void skip (size_t size) {
+        seek (off + size);
+      }
+
+      uint64_t value (size_t size) {
+        check (size);
+        uint64_t v = 0;
+        for (size_t b = 0; b < size; ++b)
+        {
+          size_t i = big_endian ? b : size - b - 1;
+          v = (v << 8) | sec.data[off + i];
+        }
+        off += size;
+        return v;
+      }
+
+      uint8_t u8 () {
+        return value (1);
+      }
+
+      uint16_t u16 () {
+        return value (2);
+      }
+
+      uint32_t u32 () {
+        return value (4);
+      }
+
+      uint64_t uleb () {
+        uint64_t v = 0;
+        int      shift = 0;
+        uint8_t  b;
+        do
+        {
+          b = u8 ();
+          if (shift < 64)
+            v |= ((uint64_t) (b & 0x7f)) << shift;
+          shift += 7;
+        } while (b & 0x80);
+        return v;
+      }
+
+      int64_t sleb () {
+        int64_t v = 0;
+        int     shift = 0;
+        uint8_t b;
+        do
+        {
+          b = u8 ();
+          if (shift < 64)
+            v |= ((int64_t) (b & 0x7f)) << shift;
+          shift += 7;
+        } while (b & 0x80);
+        if ((shift < 64) && (b & 0x40))
+          v |= -(((int64_t) 1) << shift);
+        return v;
+      }
+
+      const char* str () {
+        const char* s = (const char*) &sec.data[off];
+        const void* nul = ::memchr (s, 0, sec.size - off);
+        if (!nul)
+          throw rld::error ("String truncated", "dwarf:lines");
+        off += ((const char*) nul - s) + 1;
+        return s;
+      }
+
+      const char* str_at (size_t offset) {
+        seek (offset);
+        return str ();
+      }
+
+    private:
+      void check (size_t size) {
+        if ((off + size) > sec.size)
+          throw rld::error ("Section truncated", "dwarf:lines");
+      }
+
+      const section_data& sec;
+      const bool          big_endian;
+      size_t              off;
+    };
+
+    /**
+     * The header of a line number program.
+     */
+    struct program_header
+    {
+      uint16_t                    version;
+      size_t                      offset_size;
+      size_t                      address_size;
+      uint8_t                     min_inst_length;
+      int8_t                      line_base;
+      uint8_t                     line_range;
+      uint8_t                     opcode_base;
+      std::vector < uint8_t >     opcode_lengths;
+      std::vector < std::string > dirs;
+      std::vector < uint32_t >    files;
+    };
+
+    /**
+     * Order the rows by address with the end of a sequence before a sequence
+     * starting at the same address.
+     */
+    static bool
+    line_order (const line& l, const line& r)
+    {
+      if (l.addr != r.addr)
+        return l.addr < r.addr;
+      return l.end && !r.end;
+    }
+
+    static bool
+    line_addr_order (address addr, const line& l)
+    {
+      return addr < l.addr;
+    }
+
+    /**
+     * Join a directory and a file name.
+     */
+    static std::string
+    join_path (const std::string& dir, const std::string& name)
+    {
+      if (dir.empty () || name.empty () || (name[0] == '/') ||
+          ((name.size () > 1) && (name[1] == ':')))
+        return name;
+      return dir + '/' + name;
+    }
+
+    /**
+     * Read a DWARF 5 directory or file entry's value for a form.
+     */
+    static void
+    read_form (reader&               r,
+               uint64_t              form,
+               const program_header& hdr,
+               reader&               line_strs,
+               reader&               strs,
+               std::string&          str,
+               uint64_t&             value)
+    {
+      switch (form)
+      {
+        case form_string:
+          str = r.str ();
+          break;
+        case form_line_strp:
+          str = line_strs.str_at (r.value (hdr.offset_size));
+          break;
+        case form_strp:
+          str = strs.str_at (r.value (hdr.offset_size));
+          break;
+        case form_udata:
+          value = r.uleb ();
+          break;
+        case form_data1:
+          value = r.u8 ();
+          break;
+        case form_data2:
+          value = r.u16 ();
+          break;
+        case form_data4:
+          value = r.u32 ();
+          break;
+        case form_data8:
+          value = r.value (8);
+          break;
+        case form_data16:
+          r.skip (16);
+          break;
+        case form_block:
+          r.skip (r.uleb ());
+          break;
+        default:
+          throw rld::error ("Unsupported form: " + rld::to_string (form),
+                            "dwarf:lines");
+      }
+    }
+
+    lines::lines ()
+    {
+    }
+
+    void
+    lines::load (elf::file& file)
+    {
+      elf::sections secs;
+      section_data  line_sec;
+      section_data  line_str_sec;
+      section_data  str_sec;
+
+      if (file.is_relocatable ())
+        throw rld::error ("Relocatable file, line addresses not relocated",
+                          "dwarf:lines");
+
+      file.get_sections (secs, 0);
+
+      for (elf::sections::iterator si = secs.begin (); si != secs.end (); ++si)
+      {
+        elf::section& sec = *(*si);
+        section_data* sd = 0;
+
+        if (sec.name () == ".debug_line")
+          sd = &line_sec;
+        else if (sec.name () == ".debug_line_str")
+          sd = &line_str_sec;
+        else if (sec.name () == ".debug_str")
+          sd = &str_sec;
+
+        if (sd && sec.data ())
+        {
+          sd->data = (const uint8_t*) sec.data ()->d_buf;
+          sd->size = sec.data ()->d_size;
+        }
+      }
+
+      if (!line_sec.data)
+      {
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "dwarf:lines: no line table: " << file.name ()
+                    << std::endl;
+        return;
+      }
+
+      const bool big_endian = file.data_type () == ELFDATA2MSB;
+
+      reader r (line_sec, big_endian);
+      reader line_strs (line_str_sec, big_endian);
+      reader strs (str_sec, big_endian);
+
+      size_t loaded = rows.size ();
+
+      while (!r.end ())
+      {
+        program_header hdr;
+        uint64_t       length;
+
+        hdr.offset_size = 4;
+        hdr.address_size = file.object_class () == ELFCLASS64 ? 8 : 4;
+
+        length = r.u32 ();
+        if (length == 0xffffffff)
+        {
+          length = r.value (8);
+          hdr.offset_size = 8;
+        }
+
+        const size_t unit_end = r.offset () + length;
+
+        hdr.version = r.u16 ();
+        if ((hdr.version < 2) || (hdr.version > 5))
+        {
+          if (rld::verbose () >= RLD_VERBOSE_INFO)
+            std::cout << "dwarf:lines: unsupported version: " << hdr.version
+                      << ": " << file.name () << std::endl;
+          r.seek (unit_end);
+          continue;
+        }
+
+        if (hdr.version >= 5)
+        {
+          hdr.address_size = r.u8 ();
+          r.u8 ();
+        }
+
+        const uint64_t header_length = r.value (hdr.offset_size);
+        const size_t   program = r.offset () + header_length;
+
+        hdr.min_inst_length = r.u8 ();
+        if (hdr.version >= 4)
+          r.u8 ();
+        r.u8 ();
+        hdr.line_base = (int8_t) r.u8 ();
+        hdr.line_range = r.u8 ();
+        hdr.opcode_base = r.u8 ();
+
+        if (hdr.line_range == 0)
+          throw rld::error ("Invalid line range: " + file.name (),
+                            "dwarf:lines");
+
+        hdr.opcode_lengths.resize (hdr.opcode_base, 0);
+        for (uint8_t o = 1; o < hdr.opcode_base; ++o)
+          hdr.opcode_lengths[o] = r.u8 ();
+
+        if (hdr.version < 5)
+        {
+          /*
+           * The compilation directory is not in the line table so directory
+           * 0 is relative and file 0 is not valid.
+           */
+          const char* s;
+
+          hdr.dirs.push_back ("");
+          while (*(s = r.str ()) != '\0')
+            hdr.dirs.push_back (s);
+
+          hdr.files.push_back (no_file);
+          while (*(s = r.str ()) != '\0')
+          {
+            uint64_t dir = r.uleb ();
+            r.uleb ();
+            r.uleb ();
+            std::string d = dir < hdr.dirs.size () ? hdr.dirs[dir] : "";
+            hdr.files.push_back (add_file (join_path (d, s)));
+          }
+        }
+        else
+        {
+          for (int table = 0; table < 2; ++table)
+          {
+            typedef std::vector < std::pair < uint64_t, uint64_t > > formats;
+
+            formats  fmts;
+            uint8_t  fmt_count = r.u8 ();
+
+            for (uint8_t f = 0; f < fmt_count; ++f)
+            {
+              uint64_t content = r.uleb ();
+              uint64_t form = r.uleb ();
+              fmts.push_back (std::make_pair (content, form));
+            }
+
+            uint64_t count = r.uleb ();
+
+            for (uint64_t e = 0; e < count; ++e)
+            {
+              std::string path;
+              uint64_t    dir = 0;
+
+              for (formats::iterator fi = fmts.begin (); fi != fmts.end (); ++fi)
+              {
+                std::string str;
+                uint64_t    value = 0;
+                read_form (r, fi->second, hdr, line_strs, strs, str, value);
+                if (fi->first == lnct_path)
+                  path = str;
+                else if (fi->first == lnct_directory_index)
+                  dir = value;
+              }
+
+              if (table == 0)
+              {
+                if (!hdr.dirs.empty ())
+                  path = join_path (hdr.dirs[0], path);
+                hdr.dirs.push_back (path);
+              }
+              else
+              {
+                std::string d = dir < hdr.dirs.size () ? hdr.dirs[dir] : "";
+                hdr.files.push_back (add_file (join_path (d, path)));
+              }
+            }
+          }
+        }
+
+        /*
+         * Run the line number program.
+         */
+        r.seek (program);
+
+        address  addr = 0;
+        uint64_t file_reg = 1;
+        int64_t  line_reg = 1;
+
+        while (r.offset () < unit_end)
+        {
+          uint8_t op = r.u8 ();
+          bool    emit = false;
+          bool    end = false;
+
+          if (op >= hdr.opcode_base)
+          {
+            uint8_t adj = op - hdr.opcode_base;
+            addr += hdr.min_inst_length * (adj / hdr.line_range);
+            line_reg += hdr.line_base + (adj % hdr.line_range);
+            emit = true;
+          }
+          else if (op == 0)
+          {
+            uint64_t     len = r.uleb ();
+            const size_t next = r.offset () + len;
+
+            if (len != 0)
+            {
+              uint8_t eop = r.u8 ();
+              switch (eop)
+              {
+                case lne_end_sequence:
+                  emit = true;
+                  end = true;
+                  break;
+                case lne_set_address:
+                  if ((len - 1) <= 8)
+                    addr = r.value (len - 1);
+                  break;
+                default:
+                  break;
+              }
+            }
+
+            r.seek (next);
+          }
+          else
+          {
+            switch (op)
+            {
+              case lns_copy:
+                emit = true;
+                break;
+              case lns_advance_pc:
+                addr += hdr.min_inst_length * r.uleb ();
+                break;
+              case lns_advance_line:
+                line_reg += r.sleb ();
+                break;
+              case lns_set_file:
+                file_reg = r.uleb ();
+                break;
+              case lns_const_add_pc:
+                addr += hdr.min_inst_length *
+                  ((255 - hdr.opcode_base) / hdr.line_range);
+                break;
+              case lns_fixed_advance_pc:
+                addr += r.u16 ();
+                break;
+              default:
+                for (uint8_t a = 0; a < hdr.opcode_lengths[op]; ++a)
+                  r.uleb ();
+                break;
+            }
+          }
+
+          if (emit)
+          {
+            uint32_t f = no_file;
+            if (file_reg < hdr.files.size ())
+              f = hdr.files[file_reg];
+            if (end || (f != no_file))
+            {
+              line l;
+              l.addr = addr;
+              l.file = f;
+              l.number = line_reg;
+              l.end = end;
+              rows.push_back (l);
+            }
+
+            if (end)
+            {
+              addr = 0;
+              file_reg = 1;
+              line_reg = 1;
+            }
+          }
+        }
+
+        r.seek (unit_end);
+      }
+
+      std::stable_sort (rows.begin (), rows.end (), line_order);
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "dwarf:lines: " << file.name ()
+                  << ": rows=" << rows.size () - loaded
+                  << " files=" << files.size () << std::endl;
+    }
+
+    const line*
+    lines::find (address addr) const
+    {
+      line_table::const_iterator li;
+
+      li = std::upper_bound (rows.begin (), rows.end (), addr, line_addr_order);
+      if (li == rows.begin ())
+        return 0;
+
+      --li;
+      if (li->end)
+        return 0;
+
+      return &(*li);
+    }
+
+    const std::string&
+    lines::file_name (uint32_t file) const
+    {
+      return files[file];
+    }
+
+    size_t
+    lines::size () const
+    {
+      return rows.size ();
+    }
+
+    uint32_t
+    lines::add_file (const std::string& name)
+    {
+      file_index::iterator fi = file_names.find (name);
+      if (fi != file_names.end ())
+        return fi->second;
+      uint32_t index = files.size ();
+      files.push_back (name);
+      file_names[name] = index;
+      return index;
+    }
+  }
+}
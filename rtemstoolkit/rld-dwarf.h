@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker DWARF line tables.
+ *
+ * The line number programs in the .debug_line section of an executable are
+ * run in one pass and the rows are held in a table sorted by address. A row
+ * is the address, the line and an index into a table of the source file
+ * names shared by all the compilation units. DWARF versions 2 to 5 are
+ * supported. The section is not relocated so only executables can be
+ * loaded.
+ */
+
+#if !defined (_RLD_DWARF_H_)
+#define _RLD_DWARF_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <rld-elf.h>
+
+namespace rld
+{
+  namespace dwarf
+  {
+    /**
+     * Use a local type for the address.
+     */
+    typedef elf::elf_addr address;
+
+    /**
+     * A row of a line table.
+     */
+    struct line
+    {
+      address  addr;    //< The address of the row.
+      uint32_t file;    //< The index of the source file name.
+      uint32_t number;  //< The source line number.
+      bool     end;     //< The end of a sequence, the address is not code.
+    };
+
+    /**
+     * The line tables of an executable.
+     */
+    class lines
+    {
+    public:
+      /**
+       * Construct an empty line table.
+       */
+      lines ();
+
+      /**
+       * Load the line tables of the ELF file. The file can be loaded more
+       * than once to add the lines of other files. A relocatable file throws
+       * an error as its line addresses are not relocated.
+       *
+       * @param file The ELF file.
+       */
+      void load (elf::file& file);
+
+      /**
+       * Find the row holding an address.
+       *
+       * @param addr The address to find.
+       * @return const line* The row or 0 if the address has no line.
+       */
+      const line* find (address addr) const;
+
+      /**
+       * The source file name of an index.
+       *
+       * @param file The index of the file name.
+       * @return const std::string& The file name.
+       */
+      const std::string& file_name (uint32_t file) const;
+
+      /**
+       * The number of rows.
+       */
+      size_t size () const;
+
+    private:
+
+      /**
+       * Add a source file name returning its index.
+       */
+      uint32_t add_file (const std::string& name);
+
+      typedef std::vector < line > line_table;
+      typedef std::map < std::string, uint32_t > file_index;
+
+      line_table                  rows;        //< The sorted rows.
+      std::vector < std::string > files;       //< The source file names.
+      file_index                  file_names;  //< The index of the names.
+    };
+  }
+}
+
+#endif
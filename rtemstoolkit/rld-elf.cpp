@@ -428,7 +428,9 @@ namespace rld
         ident_str (0),
         ident_size (0),
         ehdr (0),
-        phdr (0)
+        phdr (0),
+        externals_loaded (false),
+        others_loaded (false)
     {
     }
 
@@ -612,6 +614,7 @@ namespace rld
        */
       shstrtab += '\0';
       shstrtab += ".shstrtab";
+      shstrtab += '\0';
 
       /*
        * Create the string table section.
@@ -775,15 +778,40 @@ namespace rld
       return ehdr->e_shstrndx;
     }
 
+    /**
+     * An external symbol is a global or weak function, object or no-type
+     * symbol. These are the symbols the linker resolves and the symbol tables
+     * hold. All other symbols are only needed when the relocation records or
+     * the local symbols are loaded.
+     */
+    static bool
+    external_symbol (const elf_sym& esym)
+    {
+      int stype = GELF_ST_TYPE (esym.st_info);
+      int sbind = GELF_ST_BIND (esym.st_info);
+      return (((sbind == STB_GLOBAL) || (sbind == STB_WEAK)) &&
+              ((stype == STT_NOTYPE) ||
+               (stype == STT_OBJECT) ||
+               (stype == STT_FUNC)));
+    }
+
     void
-    file::load_symbols ()
+    file::load_symbols (bool local)
     {
-      if (symbols.empty ())
+      bool externals = !externals_loaded;
+      bool others = local && !others_loaded;
+
+      if (externals || others)
       {
         if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
-          std::cout << "elf:symbol: " << name () << std::endl;
+          std::cout << "elf:symbol: " << name ()
+                    << " externals:" << externals
+                    << " others:" << others
+                    << std::endl;
 
-        sections symbol_secs;
+        sections                  symbol_secs;
+        size_t                    skipped = 0;
+        symbols::bucket::iterator pos = symbols.begin ();
 
         get_sections (symbol_secs, SHT_SYMTAB);
 
@@ -801,15 +829,58 @@ namespace rld
             if (!::gelf_getsym (sec.data (), s, &esym))
              error ("gelf_getsym");
 
+            /*
+             * Filter on the raw ELF symbol so no name or symbol is created
+             * for a symbol not being loaded.
+             */
+            if (external_symbol (esym) ? !externals : !others)
+            {
+              ++skipped;
+              continue;
+            }
+
             std::string     name = get_string (sec.link (), esym.st_name);
             symbols::symbol sym (s, name, esym);
 
             if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
               std::cout << "elf:symbol: " << sym << std::endl;
 
-            symbols.push_back (sym);
+            /*
+             * Keep the symbols in the symbol table's order when adding to
+             * the symbols already loaded.
+             */
+            while ((pos != symbols.end ()) && (pos->index () < s))
+              ++pos;
+
+            symbols.insert (pos, sym);
           }
         }
+
+        externals_loaded = true;
+        if (others)
+          others_loaded = true;
+
+        /*
+         * Index the symbols by their symbol table index so relocation records
+         * find their symbol without a search. The bucket is in index order.
+         */
+        symbol_index.clear ();
+        if (!symbols.empty ())
+          symbol_index.resize (symbols.back ().index () + 1, 0);
+        for (symbols::bucket::const_iterator si = symbols.begin ();
+             si != symbols.end ();
+             ++si)
+        {
+          const symbols::symbol& sym = *si;
+          if (symbol_index[sym.index ()] == 0)
+            symbol_index[sym.index ()] = &sym;
+        }
+
+        if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
+          std::cout << "elf:symbol: " << name ()
+                    << ": loaded:" << symbols.size ()
+                    << " skipped:" << skipped
+                    << std::endl;
       }
     }
 
@@ -828,7 +899,7 @@ namespace rld
                   << " " << name_
                   << std::endl;
 
-      load_symbols ();
+      load_symbols (local);
 
       filtered_syms.clear ();
 
@@ -876,25 +947,27 @@ namespace rld
     const symbols::symbol&
     file::get_symbol (const int index) const
     {
-      for (symbols::bucket::const_iterator si = symbols.begin ();
-           si != symbols.end ();
-           ++si)
-      {
-        const symbols::symbol& sym = *si;
-        if (index == sym.index ())
-          return sym;
-      }
+      if ((index >= 0) &&
+          (static_cast < size_t > (index) < symbol_index.size ()) &&
+          (symbol_index[index] != 0))
+        return *symbol_index[index];
 
       throw rld::error ("symbol index '" + rld::to_string (index) + "' not found",
                         "elf:file:get_symbol: " + name_);
     }
 
     void
-    file::load_relocations ()
+    file::load_relocations (bool loaded_only)
     {
       if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
         std::cout << "elf:reloc: " << name () << std::endl;
 
+      /*
+       * Relocation records reference any symbol, for example section symbols,
+       * so load the symbols not loaded.
+       */
+      load_symbols (true);
+
       sections rel_secs;
 
       get_sections (rel_secs, SHT_REL);
@@ -909,6 +982,9 @@ namespace rld
         int      rels = sec.entries ();
         bool     rela = sec.type () == SHT_RELA;
 
+        if (loaded_only && ((targetsec.flags () & SHF_ALLOC) == 0))
+          continue;
+
         targetsec.set_reloc_type (rela);
 
         if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
@@ -994,7 +1070,8 @@ namespace rld
     file::set_header (elf_half      type,
                       int           class_,
                       elf_half      machinetype,
-                      unsigned char datatype)
+                      unsigned char datatype,
+                      elf_word      flags)
     {
       check_writable ("set_header");
 
@@ -1018,7 +1095,7 @@ namespace rld
       {
         ((elf32_ehdr*)ehdr)->e_type = type;
         ((elf32_ehdr*)ehdr)->e_machine = machinetype;
-        ((elf32_ehdr*)ehdr)->e_flags = 0;
+        ((elf32_ehdr*)ehdr)->e_flags = flags;
         ((elf32_ehdr*)ehdr)->e_ident[EI_DATA] = datatype;
         ((elf32_ehdr*)ehdr)->e_version = EV_CURRENT;
       }
@@ -1026,7 +1103,7 @@ namespace rld
       {
         ehdr->e_type = type;
         ehdr->e_machine = machinetype;
-        ehdr->e_flags = 0;
+        ehdr->e_flags = flags;
         ehdr->e_ident[EI_DATA] = datatype;
         ehdr->e_version = EV_CURRENT;
       }
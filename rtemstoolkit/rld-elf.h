@@ -549,13 +549,21 @@ namespace rld
       std::string get_string (size_t offset);
 
       /**
-       * Load the symbols.
+       * Load the symbols. The binding and type of each ELF symbol is checked
+       * before the symbol is created so a file's global and weak function,
+       * object and no-type symbols can be loaded without creating the local
+       * symbols. The other symbols are loaded when first requested and can be
+       * loaded after the external symbols.
+       *
+       * @param local Load the local and other symbols as well as the external
+       *              symbols.
        */
-      void load_symbols ();
+      void load_symbols (bool local = true);
 
       /**
        * Get a filtered container of symbols given the various types. If the
-       * symbols are not loaded they are loaded.
+       * symbols are not loaded they are loaded. Local symbols are only loaded
+       * if requested.
        *
        * @param filtered_syms The filtered symbols found in the file. This is a
        *                      container of pointers.
@@ -571,14 +579,19 @@ namespace rld
                         bool                    global = true);
 
       /**
-       * Get the symbol by index in the symtabl section.
+       * Get the symbol by index in the symtabl section. The symbol must have
+       * been loaded, loading the relocation records loads all symbols.
        */
       const symbols::symbol& get_symbol (const int index) const;
 
       /**
        * Load the relocation records.
+       *
+       * @param loaded_only Only load the relocation records of the sections
+       *                    the target loads and skip those of the debug and
+       *                    other sections that are not allocated.
        */
-      void load_relocations ();
+      void load_relocations (bool loaded_only = false);
 
       /**
        * Clear the relocation records.
@@ -613,11 +626,13 @@ namespace rld
        * @param class_ The files ELF class.
        * @param machinetype The type of machine code present in the ELF file.
        * @param datatype The data type, ie LSB or MSB.
+       * @param flags The processor specific flags.
        */
       void set_header (elf_half      type,
                        int           class_,
                        elf_half      machinetype,
-                       unsigned char datatype);
+                       unsigned char datatype,
+                       elf_word      flags = 0);
 
       /**
        * Add a section to the ELF file if writable.
@@ -711,6 +726,13 @@ namespace rld
       program_headers      phdrs;      //< The program headers when creating
                                        //  ELF files.
       rld::symbols::bucket symbols;    //< The symbols. All tables point here.
+      bool                 externals_loaded; //< The external symbols are
+                                             //  loaded.
+      bool                 others_loaded;    //< The local and other symbols
+                                             //  are loaded.
+      std::vector < const symbols::symbol* > symbol_index; //< The loaded
+                                             //  symbols by their index in
+                                             //  the symbol table.
     };
 
     /**
@@ -19,6 +19,8 @@
 #endif
 
 #include <algorithm>
+#include <set>
+#include <vector>
 
 #include <errno.h>
 #include <fcntl.h>
@@ -28,6 +30,7 @@
 #include <unistd.h>
 
 #include <rld.h>
+#include <rld-symindex.h>
 
 #if __WIN32__
 #define CREATE_MODE (S_IRUSR | S_IWUSR)
@@ -474,6 +477,7 @@ namespace rld
      * Defines for the header of an archive.
      */
     #define rld_archive_ident         "!<arch>\n"
+    #define rld_archive_thin_ident    "!<thin>\n"
     #define rld_archive_ident_size    (sizeof (rld_archive_ident) - 1)
     #define rld_archive_fhdr_base     rld_archive_ident_size
     #define rld_archive_fname         (0)
@@ -493,8 +497,19 @@ namespace rld
     #define rld_archive_fhdr_size     (60)
     #define rld_archive_max_file_size (1024)
 
+    /**
+     * The GNU symbol table and extended file name table are the only headers
+     * in a thin archive with the data following the header.
+     */
+    static bool
+    archive_table (const uint8_t* header)
+    {
+      return (header[0] == '/') && ((header[1] == ' ') || (header[1] == '/'));
+    }
+
     archive::archive (const std::string& path)
-      : image (path, false)
+      : image (path, false),
+        thin_ (false)
     {
       if (!name ().is_valid ())
         throw rld_error_at ("name is empty");
@@ -511,7 +526,11 @@ namespace rld
     void
     archive::begin ()
     {
-      if (references () == 1)
+      /*
+       * The object files in a thin archive are opened in place so there is
+       * no ELF session for the archive.
+       */
+      if ((references () == 1) && !thin_)
       {
         elf ().begin (name ().full (), fd ());
 
@@ -527,7 +546,7 @@ namespace rld
     void
     archive::end ()
     {
-      if (references () == 1)
+      if ((references () == 1) && !thin_)
         elf ().end ();
     }
 
@@ -542,13 +561,57 @@ namespace rld
     {
       open ();
       uint8_t header[rld_archive_ident_size];
-      seek_read (0, &header[0], rld_archive_ident_size);
-      bool result = ::memcmp (header, rld_archive_ident,
-                              rld_archive_ident_size) == 0 ? true : false;
+      bool    result = false;
+      if (seek_read (0, &header[0], rld_archive_ident_size))
+      {
+        if (::memcmp (header, rld_archive_ident, rld_archive_ident_size) == 0)
+        {
+          thin_ = false;
+          result = true;
+        }
+        else if (::memcmp (header, rld_archive_thin_ident,
+                           rld_archive_ident_size) == 0)
+        {
+          thin_ = true;
+          result = true;
+        }
+      }
       close ();
       return result;
     }
 
+    bool
+    archive::is_thin () const
+    {
+      return thin_;
+    }
+
+    const std::string
+    archive::member_path (const std::string& name_) const
+    {
+      const std::string& apath = name ().path ();
+      size_t             sep = apath.find_last_of (RLD_PATH_SEPARATOR);
+      if (name_.empty () ||
+          (name_[0] == RLD_PATH_SEPARATOR) ||
+          (sep == std::string::npos))
+        return name_;
+      std::string mpath;
+      path::path_join (apath.substr (0, sep), name_, mpath);
+      return mpath;
+    }
+
+    const std::string
+    archive::member_name (const std::string& path_) const
+    {
+      const std::string& apath = name ().path ();
+      size_t             sep = apath.find_last_of (RLD_PATH_SEPARATOR);
+      if (sep == std::string::npos)
+        return path_;
+      if (path_.compare (0, sep + 1, apath, 0, sep + 1) == 0)
+        return path_.substr (sep + 1);
+      return path_;
+    }
+
     void
     archive::load_objects (objects& objs)
     {
@@ -563,12 +626,17 @@ namespace rld
         if (!read_header (offset, &header[0]))
           break;
 
+        size_t member_size =
+          scan_decimal (&header[rld_archive_size], rld_archive_size_size);
+
         /*
-         * The archive file headers are always aligned to an even address.
+         * The archive file headers are always aligned to an even address. The
+         * object files in a thin archive are not in the archive.
          */
-        size =
-          (scan_decimal (&header[rld_archive_size],
-                         rld_archive_size_size) + 1) & ~1;
+        if (thin_ && !archive_table (header))
+          size = 0;
+        else
+          size = (member_size + 1) & ~1;
 
         /*
          * Check for the GNU extensions.
@@ -611,9 +679,11 @@ namespace rld
                 off_t off = offset;
                 while (extended_file_names == 0)
                 {
-                  size_t esize =
-                    (scan_decimal (&header[rld_archive_size],
-                                   rld_archive_size_size) + 1) & ~1;
+                  size_t esize = 0;
+                  if (!thin_ || archive_table (header))
+                    esize =
+                      (scan_decimal (&header[rld_archive_size],
+                                     rld_archive_size_size) + 1) & ~1;
                   off += esize + rld_archive_fhdr_size;
 
                   if (!read_header (off, &header[0]))
@@ -639,7 +709,7 @@ namespace rld
                 seek_read (extended_file_names + extended_off,
                            (uint8_t*) &cname[0], rld_archive_max_file_size);
                 add_object (objs, cname,
-                            offset + rld_archive_fhdr_size, size);
+                            offset + rld_archive_fhdr_size, member_size);
               }
               break;
             default:
@@ -656,7 +726,7 @@ namespace rld
            */
           add_object (objs,
                       (char*) &header[rld_archive_fname],
-                      offset + rld_archive_fhdr_size, size);
+                      offset + rld_archive_fhdr_size, member_size);
         }
 
         offset += size + rld_archive_fhdr_size;
@@ -687,8 +757,16 @@ namespace rld
     archive::add_object (objects& objs, const char* path, off_t offset, size_t size)
     {
       const char* end = path;
-      while ((*end != '\0') && (*end != '/') && (*end != '\n'))
+      while ((*end != '\0') && (*end != '\n'))
+      {
+        /*
+         * A thin archive's names are paths terminated by a '/'.
+         */
+        if ((*end == '/') &&
+            (!thin_ || (end[1] == '\n') || (end[1] == ' ')))
+          break;
         ++end;
+      }
 
       std::string str;
       str.append (path, end - path);
@@ -696,8 +774,19 @@ namespace rld
       if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
         std::cout << "archive::add-object: " << str << std::endl;
 
-      file n (name ().path (), str, offset, size);
-      objs[n.full()] = new object (*this, n);
+      if (thin_)
+      {
+        /*
+         * The object file is opened in place.
+         */
+        file n ("", member_path (str), 0, size);
+        objs[n.full()] = new object (*this, n);
+      }
+      else
+      {
+        file n (name ().path (), str, offset, size);
+        objs[n.full()] = new object (*this, n);
+      }
     }
 
     void
@@ -730,20 +819,24 @@ namespace rld
     }
 
     void
-    archive::create (object_list& objects)
+    archive::create (object_list& objects, bool thin)
     {
       if (rld::verbose () >= RLD_VERBOSE_DETAILS)
         std::cout << "archive::create: " << name ().full ()
-                  << ", objects: " << objects.size () << std::endl;
+                  << ", objects: " << objects.size ()
+                  << (char*) (thin ? ", thin" : "") << std::endl;
 
       open (true);
 
       try
       {
-        seek_write (0, rld_archive_ident, rld_archive_ident_size);
+        seek_write (0,
+                    thin ? rld_archive_thin_ident : rld_archive_ident,
+                    rld_archive_ident_size);
 
         /*
-         * GNU extended filenames.
+         * GNU extended filenames. A thin archive holds the path of every
+         * object file in the table.
          */
         std::string extended_file_names;
 
@@ -752,9 +845,21 @@ namespace rld
              ++oi)
         {
           object& obj = *(*oi);
-          const std::string&  oname = path::basename (obj.name ().oname ());
-          if (oname.length () >= rld_archive_fname_size)
-            extended_file_names += oname + '\n';
+          if (thin)
+          {
+            if (!obj.name ().aname ().empty ())
+              throw rld::error ("Object file in an archive: " +
+                                obj.name ().full (),
+                                "archive-create:" + name ().full ());
+            extended_file_names +=
+              path::path_abs (obj.name ().oname ()) + "/\n";
+          }
+          else
+          {
+            const std::string&  oname = path::basename (obj.name ().oname ());
+            if (oname.length () >= rld_archive_fname_size)
+              extended_file_names += oname + '\n';
+          }
         }
 
         if (!extended_file_names.empty ())
@@ -773,6 +878,18 @@ namespace rld
         {
           object& obj = *(*oi);
 
+          if (thin)
+          {
+            std::string oname = path::path_abs (obj.name ().oname ()) + "/\n";
+            size_t      pos = extended_file_names.find (oname);
+            if (pos == std::string::npos)
+              throw rld_error_at ("extended file name not found");
+            std::ostringstream oss;
+            oss << '/' << pos;
+            write_header (oss.str (), 0, 0, 0, 0666, obj.name ().size ());
+            continue;
+          }
+
           obj.open ();
 
           try
@@ -824,7 +941,7 @@ namespace rld
         type (er.type ()),
         info (er.info ()),
         addend (er.addend ()),
-        symname (er.symbol ().name ()),
+        symindex (er.symbol ().index ()),
         symtype (er.symbol ().type ()),
         symsect (er.symbol ().section_index ()),
         symvalue (er.symbol ().value ()),
@@ -934,7 +1051,7 @@ namespace rld
     void
     object::open (bool writable)
     {
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
       {
         if (writable)
           throw rld_error_at ("object files in archives are not writable");
@@ -947,7 +1064,7 @@ namespace rld
     void
     object::close ()
     {
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
       {
         archive_->end ();
         archive_->close ();
@@ -970,7 +1087,7 @@ namespace rld
         std::cout << "object:begin: " << name ().full () << " in-archive:"
                   << ((char*) (archive_ ? "yes" : "no")) << std::endl;
 
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
         elf ().begin (name ().full (), archive_->elf(), name ().offset ());
       else
         elf ().begin (name ().full (), fd (), is_writable ());
@@ -1127,12 +1244,73 @@ namespace rld
     }
 
     void
-    object::load_relocations ()
+    object::load_symbols (rld::symbols::table&  symbols,
+                          rld::symbols::bucket& syms,
+                          bool                  local)
+    {
+      if (rld::verbose () >= RLD_VERBOSE_TRACE_SYMS)
+        std::cout << "object:load-sym: indexed: " << name ().full ()
+                  << ": total " << syms.size () << std::endl;
+
+      if (syms.empty ())
+        return;
+
+      symbols::bucket::iterator first = syms.begin ();
+
+      indexed.splice (indexed.end (), syms);
+
+      /*
+       * Filter the symbols the same way the ELF file's symbols are filtered
+       * when loaded.
+       */
+      for (symbols::bucket::iterator si = first;
+           si != indexed.end ();
+           ++si)
+      {
+        symbols::symbol& sym = *si;
+
+        int stype = sym.type ();
+        int sbind = sym.binding ();
+
+        if ((stype == STT_NOTYPE) &&
+            (sbind == STB_GLOBAL) &&
+            (sym.section_index () == SHN_UNDEF))
+        {
+          unresolved[sym.name ()] = &sym;
+        }
+        else if ((stype == STT_NOTYPE) ||
+                 (stype == STT_OBJECT) ||
+                 (stype == STT_FUNC))
+        {
+          if (sbind == STB_WEAK)
+          {
+            sym.set_object (*this);
+            symbols.add_weak (sym);
+            externals.push_back (&sym);
+            unresolved[sym.name ()] = &sym;
+          }
+          else if (sbind == STB_GLOBAL)
+          {
+            sym.set_object (*this);
+            symbols.add_global (sym);
+            externals.push_back (&sym);
+          }
+          else if (local && (sbind == STB_LOCAL))
+          {
+            sym.set_object (*this);
+            symbols.add_local (sym);
+          }
+        }
+      }
+    }
+
+    void
+    object::load_relocations (bool loaded_only)
     {
       if (rld::verbose () >= RLD_VERBOSE_TRACE)
         std::cout << "object:load-relocs: " << name ().full () << std::endl;
 
-      elf ().load_relocations ();
+      elf ().load_relocations (loaded_only);
 
       for (sections::iterator si = secs.begin ();
            si != secs.end ();
@@ -1147,7 +1325,7 @@ namespace rld
     int
     object::references () const
     {
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
         return archive_->references ();
       return image::references ();
     }
@@ -1155,7 +1333,7 @@ namespace rld
     size_t
     object::size () const
     {
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
         return archive_->size ();
       return image::size ();
     }
@@ -1163,7 +1341,7 @@ namespace rld
     int
     object::fd () const
     {
-      if (archive_)
+      if (archive_ && !archive_->is_thin ())
         return archive_->fd ();
       return image::fd ();
     }
@@ -1448,11 +1626,34 @@ namespace rld
         std::cout << "cache:load-sym: object files: " << objects_.size ()
                   << std::endl;
 
+      /*
+       * Use the symbol index of an archive or object file if present and up
+       * to date.
+       */
+      object_list loaded;
+
+      for (archives::iterator ai = archives_.begin ();
+           ai != archives_.end ();
+           ++ai)
+        load_symbol_index ((*ai).first, symbols, local, loaded);
+
+      for (objects::iterator oi = objects_.begin ();
+           oi != objects_.end ();
+           ++oi)
+      {
+        if ((*oi).second->get_archive () == 0)
+          load_symbol_index ((*oi).first, symbols, local, loaded);
+      }
+
+      std::set < object* > indexed (loaded.begin (), loaded.end ());
+
       for (objects::iterator oi = objects_.begin ();
            oi != objects_.end ();
            ++oi)
       {
         object* obj = (*oi).second;
+        if (indexed.find (obj) != indexed.end ())
+          continue;
         obj->open ();
         obj->begin ();
         obj->load_symbols (symbols, local);
@@ -1465,6 +1666,66 @@ namespace rld
                   << std::endl;
     }
 
+    bool
+    cache::load_symbol_index (const std::string& path,
+                              symbols::table&    symbols,
+                              bool               locals,
+                              object_list&       loaded)
+    {
+      symindex::index idx;
+
+      if (!idx.load (path))
+        return false;
+
+      archives::const_iterator ai = archives_.find (path);
+      const bool   is_archive = ai != archives_.end ();
+      const bool   is_thin = is_archive && (*ai).second->is_thin ();
+      const size_t members = idx.head ().member_count;
+
+      /*
+       * Map every member to an object file before loading any symbols so a
+       * stale index is not partially used.
+       */
+      std::vector < object* > objs;
+
+      for (uint32_t m = 0; m < members; ++m)
+      {
+        const symindex::member& mem = idx.get_member (m);
+        std::string             key = path;
+
+        if (is_thin)
+          key = (*ai).second->member_path (idx.get_string (mem.name));
+        else if (is_archive)
+          key = file (path, idx.get_string (mem.name), mem.offset, mem.size).full ();
+
+        objects::iterator oi = objects_.find (key);
+
+        if ((oi == objects_.end ()) || (!is_archive && (members != 1)))
+        {
+          if (rld::verbose () >= RLD_VERBOSE_INFO)
+            std::cout << "cache:load-sym: index does not match: " << path
+                      << std::endl;
+          return false;
+        }
+
+        objs.push_back ((*oi).second);
+      }
+
+      for (uint32_t m = 0; m < members; ++m)
+      {
+        symbols::bucket syms;
+        idx.load_symbols (m, syms);
+        objs[m]->load_symbols (symbols, syms, locals);
+        loaded.push_back (objs[m]);
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "cache:load-sym: indexed: " << path
+                  << ": object files: " << members << std::endl;
+
+      return true;
+    }
+
     void
     cache::output_unresolved_symbols (std::ostream& out)
     {
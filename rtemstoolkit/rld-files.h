@@ -436,13 +436,41 @@ namespace rld
       bool is (const std::string& name) const;
 
       /**
-       * Check this is a valid archive.
+       * Check this is a valid archive. A regular archive or a GNU thin archive
+       * is valid.
        *
        * @retval true It is a valid archive.
        * @retval false It is not a valid archive.
        */
       bool is_valid ();
 
+      /**
+       * Is this a GNU thin archive? A thin archive only holds the paths of the
+       * object files and the object files are opened in place.
+       *
+       * @retval true It is a thin archive.
+       * @retval false It is a regular archive.
+       */
+      bool is_thin () const;
+
+      /**
+       * The path of an object file named in a thin archive. A relative name
+       * is relative to the archive's directory.
+       *
+       * @param name The name of the object file in the archive.
+       * @return const std::string The path of the object file.
+       */
+      const std::string member_path (const std::string& name) const;
+
+      /**
+       * The name of an object file in a thin archive relative to the archive's
+       * directory. This is the inverse of @ref member_path.
+       *
+       * @param path The path of the object file.
+       * @return const std::string The name of the object file.
+       */
+      const std::string member_name (const std::string& path) const;
+
       /**
        * Load @ref object's from the @ref archive adding each to the provided
        * @ref objects container.
@@ -471,11 +499,14 @@ namespace rld
 
       /**
        * Create a new archive containing the given set of objects. If
-       * referening an existing archive it is overwritten.
+       * referening an existing archive it is overwritten. A thin archive
+       * holds the absolute paths of the object files and not their contents
+       * so the object files cannot be members of a regular archive.
        *
        * @param objects The list of objects to place in the archive.
+       * @param thin Create a GNU thin archive.
        */
-      void create (object_list& objects);
+      void create (object_list& objects, bool thin = false);
 
     private:
 
@@ -494,7 +525,9 @@ namespace rld
        * Add the object file from the archive to the object's container.
        *
        * @param objs The container to add the object to.
-       * @param name The name of the object file being added.
+       * @param name The name of the object file being added. The name of an
+       *             object file in a thin archive is its path which is
+       *             relative to the archive if not absolute.
        * @param offset The offset in the @ref archive of the object file.
        * @param size The size of the object file.
        */
@@ -520,6 +553,8 @@ namespace rld
                          int                mode,
                          size_t             size);
 
+      bool thin_;  //< The archive is a GNU thin archive.
+
       /**
        * Cannot copy via a copy constructor.
        */
@@ -534,7 +569,8 @@ namespace rld
     /**
      * A relocation record. We extract what we want because the elf::section
      * class requires the image be left open as references are alive. We
-     * extract and keep the data we need to create the image.
+     * extract and keep the data we need to create the image. The symbol is
+     * held by its index and its name is in the object's ELF symbols.
      */
     struct relocation
     {
@@ -542,7 +578,8 @@ namespace rld
       const uint32_t    type;      //< The type of relocation record.
       const uint32_t    info;      //< The ELF info field.
       const int32_t     addend;    //< The constant addend.
-      const std::string symname;   //< The name of the symbol.
+      const uint32_t    symindex;  //< The symbol's index in the object's
+                                   //  symbol table.
       const uint32_t    symtype;   //< The type of symbol.
       const int         symsect;   //< The symbol's section symbol.
       const uint32_t    symvalue;  //< The symbol's value.
@@ -689,10 +726,26 @@ namespace rld
        */
       void load_symbols (symbols::table& symbols, bool local = false);
 
+      /**
+       * Load the symbols into the symbols table from a bucket of symbols
+       * created without the object's ELF file, for example from a symbol
+       * index. The symbols are moved into the object file.
+       *
+       * @param symbols The symbol table to load.
+       * @param syms The symbols of this object file. The bucket is emptied.
+       * @param local Include local symbols. The default is not to.
+       */
+      void load_symbols (symbols::table&  symbols,
+                         symbols::bucket& syms,
+                         bool             local = false);
+
       /**
        * Load the relocations.
+       *
+       * @param loaded_only Only load the relocations of the allocated
+       *                    sections.
        */
-      void load_relocations ();
+      void load_relocations (bool loaded_only = false);
 
       /**
        * References to the image.
@@ -795,6 +848,7 @@ namespace rld
       bool              valid_;     //< If true begin has run and finished.
       symbols::symtab   unresolved; //< This object's unresolved symbols.
       symbols::pointers externals;  //< This object's external symbols.
+      symbols::bucket   indexed;    //< Symbols not loaded from the ELF file.
       sections          secs;       //< The sections.
       bool              resolving_; //< The object is being resolved.
       bool              resolved_;  //< The object has been resolved.
@@ -892,6 +946,22 @@ namespace rld
        */
       void load_symbols (symbols::table& symbols, bool locals = false);
 
+      /**
+       * Load the symbols of the object files in a file from the file's symbol
+       * index. The index is only used if it is newer than the file and it
+       * matches the object files in the cache.
+       *
+       * @param path The path of the archive or object file.
+       * @param symbols The symbol table to load.
+       * @param locals Include local symbols.
+       * @param loaded The object files loaded from the index are added.
+       * @retval true The symbols have been loaded from the index.
+       */
+      bool load_symbol_index (const std::string& path,
+                              symbols::table&    symbols,
+                              bool               locals,
+                              object_list&       loaded);
+
       /**
        * Output the unresolved symbol table to the output stream.
        */
@@ -28,12 +28,17 @@
 
 #include <fstream>
 #include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
 
 #include <errno.h>
 #include <string.h>
 
 #include <rld.h>
 #include <rld-rap.h>
+#include <rld-sha1.h>
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -44,6 +49,38 @@ namespace rld
 {
   namespace outputter
   {
+    bool        strip_debug = false;
+    std::string debug_dir;
+
+    /**
+     * The name of the GNU build-id note section and the size of the ID. The
+     * ID is a SHA-1 hash as the GNU linker's default build-id is.
+     */
+    static const char*  build_id_name = ".note.gnu.build-id";
+    static const size_t build_id_size = sha1::digest_size;
+
+    /**
+     * The class of a section when an object is split into a stripped and a
+     * debug image.
+     */
+    enum split_class
+    {
+      split_both,   //< In the stripped and debug images.
+      split_load,   //< Loaded by the target, in the stripped image.
+      split_debug   //< Not loaded, in the debug image.
+    };
+
+    /**
+     * An image of a split object being written.
+     */
+    struct split_image
+    {
+      files::image*                out;     //< The output image.
+      std::vector < elf::elf_shdr > shdrs;  //< The output section headers.
+      elf::elf_off                 pos;     //< The position in the object.
+      elf::elf_off                 shoff;   //< The section headers offset.
+    };
+
     int unlink (const char* path)
     {
 #if _WIN32
@@ -182,7 +219,8 @@ namespace rld
              const std::string&        entry,
              const std::string&        exit,
              const files::object_list& dependents,
-             const files::cache&       cache)
+             const files::cache&       cache,
+             bool                      thin)
     {
       if (rld::verbose () >= RLD_VERBOSE_INFO)
         std::cout << "outputter:archive: " << name
@@ -205,7 +243,7 @@ namespace rld
       objects.unique ();
 
       files::archive arch (name);
-      arch.create (objects);
+      arch.create (objects, thin);
     }
 
     void
@@ -338,6 +376,428 @@ namespace rld
       out.close ();
     }
 
+    /**
+     * Put a value in the byte order of the ELF file.
+     */
+    static void
+    put_value (uint8_t* buf, uint64_t value, size_t size, bool msb)
+    {
+      for (size_t b = 0; b < size; ++b)
+      {
+        size_t shift = (msb ? size - b - 1 : b) * 8;
+        buf[b] = (uint8_t) (value >> shift);
+      }
+    }
+
+    /**
+     * The bytes in hex.
+     */
+    static std::string
+    build_id_hex (const uint8_t* data, size_t size)
+    {
+      static const char* digits = "0123456789abcdef";
+      std::string        hex;
+      for (size_t b = 0; b < size; ++b)
+      {
+        hex += digits[data[b] >> 4];
+        hex += digits[data[b] & 0xf];
+      }
+      return hex;
+    }
+
+    static elf::elf_off
+    align_offset (elf::elf_off offset, elf::elf_xword alignment)
+    {
+      if (alignment > 1)
+        offset = (offset + alignment - 1) & ~(alignment - 1);
+      return offset;
+    }
+
+    static split_class
+    section_split_class (const std::vector < elf::elf_shdr >& shdrs,
+                         size_t                              index)
+    {
+      const elf::elf_shdr& sh = shdrs[index];
+
+      if ((sh.sh_flags & SHF_ALLOC) != 0)
+        return split_load;
+
+      switch (sh.sh_type)
+      {
+        case SHT_REL:
+        case SHT_RELA:
+          if ((sh.sh_info < shdrs.size ()) &&
+              ((shdrs[sh.sh_info].sh_flags & SHF_ALLOC) != 0))
+            return split_load;
+          return split_debug;
+        case SHT_SYMTAB:
+        case SHT_STRTAB:
+        case SHT_SYMTAB_SHNDX:
+        case SHT_GROUP:
+          return split_both;
+        default:
+          break;
+      }
+
+      /*
+       * Processor specific sections such as the ARM attributes describe the
+       * object.
+       */
+      if ((sh.sh_type >= SHT_LOPROC) && (sh.sh_type <= SHT_HIPROC))
+        return split_both;
+
+      return split_debug;
+    }
+
+    static void
+    split_pad (split_image& image, elf::elf_off offset)
+    {
+      static const uint8_t zeros[16] = { 0 };
+      while (image.pos < offset)
+      {
+        size_t size = offset - image.pos;
+        if (size > sizeof (zeros))
+          size = sizeof (zeros);
+        image.out->write (zeros, size);
+        image.pos += size;
+      }
+    }
+
+    /**
+     * Write the stripped and debug images of an object that have been laid
+     * out.
+     */
+    static void
+    split_write (files::object&                       obj,
+                 const elf::elf_ehdr&                 ehdr,
+                 const std::vector < elf::elf_shdr >& shdrs,
+                 size_t                               shstrndx,
+                 split_image                          images[2],
+                 const uint8_t*                       build_id,
+                 uint8_t*                             buffer,
+                 size_t                               buffer_size)
+    {
+      const size_t shnum = shdrs.size ();
+      const bool   msb = ehdr.e_ident[EI_DATA] == ELFDATA2MSB;
+      const bool   class64 = ehdr.e_ident[EI_CLASS] == ELFCLASS64;
+      const size_t shentsize = class64 ? 64 : 40;
+      const size_t name_size = ::strlen (build_id_name) + 1;
+      const size_t note_size = (3 * sizeof (uint32_t)) + 4 + build_id_size;
+      const size_t count = shnum + 1;
+
+      /*
+       * Write the ELF header with the section header offset and count of each
+       * image then the sections in order.
+       */
+      obj.seek (0);
+      obj.read (buffer, ehdr.e_ehsize);
+
+      for (int i = 0; i < 2; ++i)
+      {
+        split_image& image = images[i];
+        std::vector < uint8_t > header (buffer, buffer + ehdr.e_ehsize);
+
+        put_value (&header[class64 ? 40 : 32], image.shoff, class64 ? 8 : 4, msb);
+        put_value (&header[class64 ? 60 : 48],
+                   count >= SHN_LORESERVE ? 0 : count, 2, msb);
+
+        image.out->write (&header[0], header.size ());
+        image.pos = header.size ();
+      }
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        const elf::elf_shdr& sh = shdrs[s];
+
+        if ((sh.sh_type == SHT_NOBITS) || (sh.sh_size == 0))
+          continue;
+
+        for (int i = 0; i < 2; ++i)
+          if (images[i].shdrs[s].sh_type != SHT_NOBITS)
+            split_pad (images[i], images[i].shdrs[s].sh_offset);
+
+        obj.seek (sh.sh_offset);
+
+        elf::elf_xword size = sh.sh_size;
+
+        while (size)
+        {
+          size_t reading = size < buffer_size ? size : buffer_size;
+
+          obj.read (buffer, reading);
+
+          for (int i = 0; i < 2; ++i)
+          {
+            if (images[i].shdrs[s].sh_type != SHT_NOBITS)
+            {
+              images[i].out->write (buffer, reading);
+              images[i].pos += reading;
+            }
+          }
+
+          size -= reading;
+        }
+
+        if (s == shstrndx)
+        {
+          for (int i = 0; i < 2; ++i)
+          {
+            images[i].out->write (build_id_name, name_size);
+            images[i].pos += name_size;
+          }
+        }
+      }
+
+      /*
+       * The note's descriptor is the build-id's bytes.
+       */
+      uint8_t note[note_size];
+
+      put_value (&note[0], 4, 4, msb);
+      put_value (&note[4], build_id_size, 4, msb);
+      put_value (&note[8], NT_GNU_BUILD_ID, 4, msb);
+      ::memcpy (&note[12], "GNU", 4);
+      ::memcpy (&note[16], build_id, build_id_size);
+
+      for (int i = 0; i < 2; ++i)
+      {
+        split_image& image = images[i];
+
+        split_pad (image, image.shdrs.back ().sh_offset);
+        image.out->write (note, note_size);
+        image.pos += note_size;
+
+        split_pad (image, image.shoff);
+
+        for (size_t s = 0; s < image.shdrs.size (); ++s)
+        {
+          const elf::elf_shdr& sh = image.shdrs[s];
+          uint8_t              shdr[64];
+
+          if (class64)
+          {
+            put_value (&shdr[0],  sh.sh_name,      4, msb);
+            put_value (&shdr[4],  sh.sh_type,      4, msb);
+            put_value (&shdr[8],  sh.sh_flags,     8, msb);
+            put_value (&shdr[16], sh.sh_addr,      8, msb);
+            put_value (&shdr[24], sh.sh_offset,    8, msb);
+            put_value (&shdr[32], sh.sh_size,      8, msb);
+            put_value (&shdr[40], sh.sh_link,      4, msb);
+            put_value (&shdr[44], sh.sh_info,      4, msb);
+            put_value (&shdr[48], sh.sh_addralign, 8, msb);
+            put_value (&shdr[56], sh.sh_entsize,   8, msb);
+          }
+          else
+          {
+            put_value (&shdr[0],  sh.sh_name,      4, msb);
+            put_value (&shdr[4],  sh.sh_type,      4, msb);
+            put_value (&shdr[8],  sh.sh_flags,     4, msb);
+            put_value (&shdr[12], sh.sh_addr,      4, msb);
+            put_value (&shdr[16], sh.sh_offset,    4, msb);
+            put_value (&shdr[20], sh.sh_size,      4, msb);
+            put_value (&shdr[24], sh.sh_link,      4, msb);
+            put_value (&shdr[28], sh.sh_info,      4, msb);
+            put_value (&shdr[32], sh.sh_addralign, 4, msb);
+            put_value (&shdr[36], sh.sh_entsize,   4, msb);
+          }
+
+          image.out->write (shdr, shentsize);
+          image.pos += shentsize;
+        }
+      }
+    }
+
+    /**
+     * Split a relocatable object into the stripped image the target loads
+     * and a debug object. The sections are copied to one or both images. A
+     * section not in an image is SHT_NOBITS in that image so the section
+     * indexes, symbols and relocation records do not change. Both images
+     * have the same GNU build-id note. The debug object is a standard ELF
+     * file in the debug directory at the path GDB and other debuggers look
+     * for a build-id, '.build-id/xx/yyyy.debug' where 'xx' is the first byte
+     * of the build-id in hex and 'yyyy' the remaining bytes.
+     */
+    static void
+    split_object (files::object&     obj,
+                  files::image&      app,
+                  const std::string& debug_path,
+                  uint8_t*           buffer,
+                  size_t             buffer_size)
+    {
+      elf::elf*     elf = obj.elf ().get_elf ();
+      elf::elf_ehdr ehdr;
+      size_t        shnum;
+      size_t        shstrndx;
+
+      if (!::gelf_getehdr (elf, &ehdr) ||
+          (::elf_getshdrnum (elf, &shnum) < 0) ||
+          (::elf_getshdrstrndx (elf, &shstrndx) < 0))
+        throw rld::error (::elf_errmsg (-1),
+                          "strip-debug:header: " + obj.name ().full ());
+
+      const bool   class64 = ehdr.e_ident[EI_CLASS] == ELFCLASS64;
+      const size_t shentsize = class64 ? 64 : 40;
+
+      if ((ehdr.e_type != ET_REL) ||
+          (ehdr.e_shentsize != shentsize) ||
+          (ehdr.e_ehsize > buffer_size) ||
+          (shstrndx == SHN_UNDEF) ||
+          (shstrndx >= shnum))
+        throw rld::error ("Not a relocatable object with section names",
+                          "strip-debug: " + obj.name ().full ());
+
+      std::vector < elf::elf_shdr > shdrs (shnum);
+
+      for (size_t s = 0; s < shnum; ++s)
+      {
+        elf::elf_scn* scn = ::elf_getscn (elf, s);
+        if (!scn || !::gelf_getshdr (scn, &shdrs[s]))
+          throw rld::error (::elf_errmsg (-1),
+                            "strip-debug:gelf_getshdr: " + obj.name ().full ());
+      }
+
+      std::vector < split_class > classes (shnum, split_both);
+
+      for (size_t s = 1; s < shnum; ++s)
+        classes[s] = section_split_class (shdrs, s);
+
+      /*
+       * Lay out the stripped and debug images. The build-id note is the last
+       * section and its name is appended to the section name string table.
+       */
+      const size_t   name_size = ::strlen (build_id_name) + 1;
+      const size_t   note_size = (3 * sizeof (uint32_t)) + 4 + build_id_size;
+      const size_t   count = shnum + 1;
+      const uint32_t note_name = shdrs[shstrndx].sh_size;
+      split_image    images[2];
+
+      for (int i = 0; i < 2; ++i)
+      {
+        split_image& image = images[i];
+        split_class  drop = i == 0 ? split_debug : split_load;
+
+        image.shdrs = shdrs;
+        image.pos = ehdr.e_ehsize;
+
+        for (size_t s = 1; s < shnum; ++s)
+        {
+          elf::elf_shdr& sh = image.shdrs[s];
+          if (classes[s] == drop)
+          {
+            /*
+             * A dropped relocation section no longer applies to a section.
+             */
+            if ((sh.sh_type == SHT_REL) || (sh.sh_type == SHT_RELA))
+            {
+              sh.sh_flags &= ~SHF_INFO_LINK;
+              sh.sh_link = 0;
+              sh.sh_info = 0;
+              sh.sh_entsize = 0;
+            }
+            sh.sh_type = SHT_NOBITS;
+            sh.sh_offset = image.pos;
+          }
+          else if (sh.sh_type != SHT_NOBITS)
+          {
+            image.pos = align_offset (image.pos, sh.sh_addralign);
+            sh.sh_offset = image.pos;
+            if (s == shstrndx)
+              sh.sh_size += name_size;
+            image.pos += sh.sh_size;
+          }
+        }
+
+        elf::elf_shdr note;
+
+        ::memset (&note, 0, sizeof (note));
+        image.pos = align_offset (image.pos, 4);
+        note.sh_name = note_name;
+        note.sh_type = SHT_NOTE;
+        note.sh_offset = image.pos;
+        note.sh_size = note_size;
+        note.sh_addralign = 4;
+        image.shdrs.push_back (note);
+        image.pos += note_size;
+
+        image.shoff = align_offset (image.pos, class64 ? 8 : 4);
+
+        if (count >= SHN_LORESERVE)
+          image.shdrs[0].sh_size = count;
+        else
+          image.shdrs[0].sh_size = 0;
+      }
+
+      /*
+       * The build-id is the hash of the ELF header and the sections. It names
+       * the debug object so it is calculated before the images are written.
+       */
+      uint8_t    build_id[build_id_size];
+      sha1::hash hash;
+
+      obj.seek (0);
+      obj.read (buffer, ehdr.e_ehsize);
+      hash.update (buffer, ehdr.e_ehsize);
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        const elf::elf_shdr& sh = shdrs[s];
+
+        if ((sh.sh_type == SHT_NOBITS) || (sh.sh_size == 0))
+          continue;
+
+        obj.seek (sh.sh_offset);
+
+        elf::elf_xword size = sh.sh_size;
+
+        while (size)
+        {
+          size_t reading = size < buffer_size ? size : buffer_size;
+          obj.read (buffer, reading);
+          hash.update (buffer, reading);
+          size -= reading;
+        }
+      }
+
+      hash.final (build_id);
+
+      std::string debug_name;
+      std::string debug_sub;
+
+      path::path_join (debug_path, ".build-id", debug_sub);
+      path::path_join (debug_sub, build_id_hex (build_id, 1), debug_sub);
+      path::mkdir (debug_sub);
+      path::path_join (debug_sub,
+                       build_id_hex (&build_id[1], build_id_size - 1) + ".debug",
+                       debug_name);
+
+      files::image debug (debug_name);
+
+      debug.open (true);
+
+      images[0].out = &app;
+      images[1].out = &debug;
+
+      try
+      {
+        split_write (obj, ehdr, shdrs, shstrndx, images, build_id,
+                     buffer, buffer_size);
+      }
+      catch (...)
+      {
+        debug.close ();
+        throw;
+      }
+
+      debug.close ();
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "outputter:strip-debug: " << obj.name ().full ()
+                  << ": size: " << obj.name ().size ()
+                  << " stripped: " << images[0].pos
+                  << " debug: " << images[1].pos
+                  << ": " << debug_name << std::endl;
+    }
+
     void
     elf_application (const std::string&        name,
                      const std::string&        entry,
@@ -363,6 +823,15 @@ namespace rld
       objects.merge (dep_copy);
       objects.unique ();
 
+      /*
+       * The debug objects of the objects stripped from the application are
+       * written to the debug directory.
+       */
+      const std::string debug (debug_dir.empty () ? name + ".debug" : debug_dir);
+
+      if (strip_debug && (rld::verbose () >= RLD_VERBOSE_INFO))
+        std::cout << "outputter:debug: " << debug << std::endl;
+
       app.open (true);
       app.write (header.c_str (), header.size ());
 
@@ -384,18 +853,35 @@ namespace rld
 
           try
           {
-            obj.seek (0);
+            if (strip_debug)
+            {
+              obj.begin ();
+              try
+              {
+                split_object (obj, app, debug, buffer, APP_BUFFER_SIZE);
+              }
+              catch (...)
+              {
+                obj.end ();
+                throw;
+              }
+              obj.end ();
+            }
+            else
+            {
+              obj.seek (0);
 
-            size_t in_size = obj.name ().size ();
+              size_t in_size = obj.name ().size ();
 
-            while (in_size)
-            {
-              size_t reading =
-                in_size < APP_BUFFER_SIZE ? in_size : APP_BUFFER_SIZE;
+              while (in_size)
+              {
+                size_t reading =
+                  in_size < APP_BUFFER_SIZE ? in_size : APP_BUFFER_SIZE;
 
-              app.write (buffer, obj.read (buffer, reading));
+                app.write (buffer, obj.read (buffer, reading));
 
-              in_size -= reading;
+                in_size -= reading;
+              }
             }
           }
           catch (...)
@@ -419,6 +905,891 @@ namespace rld
       app.close ();
     }
 
+    /**
+     * A reference to a symbol of the relocatable output. The symbol table is
+     * the null symbol, the section symbols, the local symbols and then the
+     * global symbols so an index is only known when the table is written.
+     */
+    struct reloc_symref
+    {
+      enum ref_type
+      {
+        ref_null,     //< The null symbol.
+        ref_section,  //< The section symbol of an output section.
+        ref_local,    //< A local symbol.
+        ref_global    //< A global or weak symbol.
+      };
+
+      ref_type type;   //< The type of symbol referenced.
+      size_t   index;  //< The output section, local or global.
+
+      reloc_symref (ref_type type_ = ref_null, size_t index_ = 0)
+        : type (type_),
+          index (index_)
+      {
+      }
+    };
+
+    /**
+     * A relocation record of the relocatable output.
+     */
+    struct reloc_record
+    {
+      elf::elf_addr   offset;  //< The offset in the output section.
+      elf::elf_xword  type;    //< The relocation type.
+      elf::elf_sxword addend;  //< The addend of a RELA record.
+      reloc_symref    symbol;  //< The symbol.
+    };
+
+    /**
+     * A symbol of the relocatable output. The value of a symbol in a section
+     * is the offset in the output section.
+     */
+    struct reloc_symbol
+    {
+      std::string  name;     //< The symbol's name.
+      elf::elf_sym esym;     //< The ELF symbol.
+      int          section;  //< The output section, -1 for a special index.
+      std::string  object;   //< The object the symbol is from.
+    };
+
+    /**
+     * A section of the relocatable output. The like named sections of the
+     * objects are concatenated.
+     */
+    struct reloc_section
+    {
+      std::string                  name;    //< The section's name.
+      elf::elf_shdr                shdr;    //< The type, flags, size etc.
+      std::vector < uint8_t >      data;    //< The section's contents.
+      int                          link;    //< The link order section.
+      bool                         rela;    //< The records have addends.
+      std::vector < reloc_record > relocs;  //< The relocation records.
+    };
+
+    typedef std::vector < reloc_section > reloc_sections;
+    typedef std::vector < reloc_symbol > reloc_symbols;
+    typedef std::map < std::string, size_t > reloc_index;
+    typedef std::pair < size_t, elf::elf_addr > reloc_anchor_key;
+    typedef std::map < reloc_anchor_key, size_t > reloc_anchors;
+
+    /**
+     * The relocatable output being linked.
+     */
+    struct reloc_output
+    {
+      reloc_sections          sections;      //< The output sections.
+      reloc_index             section_names; //< The sections by name.
+      reloc_symbols           locals;        //< The local symbols.
+      reloc_symbols           globals;       //< The global and weak symbols.
+      reloc_index             global_names;  //< The global symbols by name.
+      reloc_anchors           anchors;       //< The local anchor symbols.
+      std::set < std::string > groups;       //< The COMDAT groups linked.
+      elf::elf_word           flags;         //< The ELF header flags.
+
+      reloc_output ()
+        : flags (0)
+      {
+      }
+    };
+
+    static bool
+    reloc_undefined (const reloc_symbol& sym)
+    {
+      return (sym.section < 0) && (sym.esym.st_shndx == SHN_UNDEF);
+    }
+
+    static bool
+    reloc_common (const reloc_symbol& sym)
+    {
+      return (sym.section < 0) && (sym.esym.st_shndx == SHN_COMMON);
+    }
+
+    /**
+     * Merge a global or weak symbol into the global symbols returning its
+     * index. A definition replaces a reference, a strong definition replaces
+     * a weak or common definition and the largest common is kept.
+     */
+    static size_t
+    reloc_merge_symbol (reloc_output& out, const reloc_symbol& sym)
+    {
+      reloc_index::iterator gi = out.global_names.find (sym.name);
+
+      if (gi == out.global_names.end ())
+      {
+        out.global_names[sym.name] = out.globals.size ();
+        out.globals.push_back (sym);
+        return out.globals.size () - 1;
+      }
+
+      reloc_symbol& global = out.globals[gi->second];
+      int           bind = GELF_ST_BIND (sym.esym.st_info);
+
+      if (reloc_undefined (sym))
+      {
+        /*
+         * A strong reference makes an unresolved weak reference strong.
+         */
+        if (reloc_undefined (global) && (bind == STB_GLOBAL))
+          global.esym.st_info =
+            GELF_ST_INFO (STB_GLOBAL, GELF_ST_TYPE (global.esym.st_info));
+      }
+      else if (reloc_undefined (global))
+        global = sym;
+      else if (reloc_common (sym))
+      {
+        if (reloc_common (global))
+        {
+          if (sym.esym.st_size > global.esym.st_size)
+            global.esym.st_size = sym.esym.st_size;
+          if (sym.esym.st_value > global.esym.st_value)
+            global.esym.st_value = sym.esym.st_value;
+        }
+      }
+      else if (reloc_common (global))
+        global = sym;
+      else if (bind == STB_WEAK)
+        ;
+      else if (GELF_ST_BIND (global.esym.st_info) == STB_WEAK)
+        global = sym;
+      else
+        throw rld::error ("multiple definition of '" + sym.name +
+                          "', first defined in " + global.object,
+                          "relocatable: " + sym.object);
+
+      return gi->second;
+    }
+
+    /**
+     * Return a local symbol at an offset in an output section. A REL record's
+     * addend is in the section's contents so a record against a section
+     * symbol is moved to a symbol at the input section's offset. The addend
+     * is then relative to the symbol and not a string so the section's
+     * strings can no longer be merged.
+     */
+    static reloc_symref
+    reloc_anchor (reloc_output& out, size_t section, elf::elf_addr offset)
+    {
+      reloc_anchor_key        key (section, offset);
+      reloc_anchors::iterator ai = out.anchors.find (key);
+
+      if (ai == out.anchors.end ())
+      {
+        reloc_symbol sym;
+
+        ::memset (&sym.esym, 0, sizeof (sym.esym));
+        sym.esym.st_info = GELF_ST_INFO (STB_LOCAL, STT_NOTYPE);
+        sym.esym.st_value = offset;
+        sym.section = section;
+
+        ai = out.anchors.insert (std::make_pair (key, out.locals.size ())).first;
+        out.locals.push_back (sym);
+
+        out.sections[section].shdr.sh_flags &= ~(SHF_MERGE | SHF_STRINGS);
+      }
+
+      return reloc_symref (reloc_symref::ref_local, ai->second);
+    }
+
+    /**
+     * Link an object into the relocatable output. The sections are appended
+     * to the like named output sections, the symbols are added and the
+     * relocation records moved to the output sections and symbols. The
+     * sections of a COMDAT group already linked are discarded.
+     */
+    static void
+    reloc_object (reloc_output& out, files::object& obj, bool first)
+    {
+      elf::file&    elf = obj.elf ();
+      elf::elf_ehdr ehdr;
+      size_t        shnum;
+      size_t        shstrndx;
+
+      if (!::gelf_getehdr (elf.get_elf (), &ehdr) ||
+          (::elf_getshdrnum (elf.get_elf (), &shnum) < 0) ||
+          (::elf_getshdrstrndx (elf.get_elf (), &shstrndx) < 0))
+        throw rld::error (::elf_errmsg (-1),
+                          "relocatable:header: " + obj.name ().full ());
+
+      if (ehdr.e_type != ET_REL)
+        throw rld::error ("Not a relocatable object",
+                          "relocatable: " + obj.name ().full ());
+
+      if (first)
+        out.flags = ehdr.e_flags;
+
+      std::vector < elf::section > secs;
+      size_t                       symtab = 0;
+      size_t                       symstrtab = 0;
+
+      /*
+       * The sections are indexed by the section number. Section 0 is the null
+       * section.
+       */
+      secs.reserve (shnum);
+      secs.push_back (elf::section ());
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        secs.push_back (elf::section (elf, s));
+
+        if ((secs[s].type () == SHT_SYMTAB) && (symtab == 0))
+        {
+          symtab = s;
+          symstrtab = secs[s].link ();
+        }
+        else if (secs[s].type () == SHT_SYMTAB_SHNDX)
+          throw rld::error ("Extended section indexes not supported",
+                            "relocatable: " + obj.name ().full ());
+      }
+
+      /*
+       * Discard the group sections and the members of a COMDAT group already
+       * linked.
+       */
+      std::vector < bool > discard (shnum, false);
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        elf::section& sec = secs[s];
+
+        if (sec.type () != SHT_GROUP)
+          continue;
+
+        discard[s] = true;
+
+        const elf::elf_word* words = (const elf::elf_word*) sec.data ()->d_buf;
+        size_t               count =
+          sec.data ()->d_size / sizeof (elf::elf_word);
+
+        if ((count == 0) || ((words[0] & GRP_COMDAT) == 0) ||
+            (sec.link () >= shnum))
+          continue;
+
+        elf::elf_sym esym;
+
+        if (!::gelf_getsym (secs[sec.link ()].data (), sec.info (), &esym))
+          throw rld::error (::elf_errmsg (-1),
+                            "relocatable:group: " + obj.name ().full ());
+
+        std::string signature =
+          elf.get_string (secs[sec.link ()].link (), esym.st_name);
+
+        if (out.groups.insert (signature).second)
+          continue;
+
+        for (size_t w = 1; w < count; ++w)
+          if (words[w] < shnum)
+            discard[words[w]] = true;
+      }
+
+      /*
+       * Append the sections to the output sections.
+       */
+      std::vector < int >           out_sec (shnum, -1);
+      std::vector < elf::elf_addr > sec_offset (shnum, 0);
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        elf::section& sec = secs[s];
+
+        switch (sec.type ())
+        {
+          case SHT_SYMTAB:
+          case SHT_REL:
+          case SHT_RELA:
+          case SHT_GROUP:
+            continue;
+          case SHT_STRTAB:
+            if ((s == shstrndx) || (s == symstrtab))
+              continue;
+            break;
+          default:
+            break;
+        }
+
+        if (discard[s])
+          continue;
+
+        reloc_index::iterator ni = out.section_names.find (sec.name ());
+
+        if (ni == out.section_names.end ())
+        {
+          reloc_section os;
+
+          os.name = sec.name ();
+          ::memset (&os.shdr, 0, sizeof (os.shdr));
+          os.shdr.sh_type = sec.type ();
+          os.shdr.sh_flags = sec.flags () & ~SHF_GROUP;
+          os.shdr.sh_entsize = sec.entry_size ();
+          os.link = -1;
+          os.rela = false;
+
+          out.section_names[os.name] = out.sections.size ();
+          out.sections.push_back (os);
+          ni = out.section_names.find (os.name);
+        }
+        else
+        {
+          reloc_section& os = out.sections[ni->second];
+
+          /*
+           * Processor specific sections such as the ARM attributes describe
+           * the object and cannot be concatenated.
+           */
+          if ((sec.type () >= SHT_LOPROC) && (sec.type () <= SHT_HIPROC) &&
+              ((sec.flags () & SHF_ALLOC) == 0))
+            continue;
+
+          if (os.shdr.sh_type != sec.type ())
+          {
+            if ((os.shdr.sh_type == SHT_NOBITS) &&
+                (sec.type () == SHT_PROGBITS))
+            {
+              os.shdr.sh_type = SHT_PROGBITS;
+              os.data.resize (os.shdr.sh_size, 0);
+            }
+            else if ((os.shdr.sh_type != SHT_PROGBITS) ||
+                     (sec.type () != SHT_NOBITS))
+              throw rld::error ("Section type mismatch: " + sec.name (),
+                                "relocatable: " + obj.name ().full ());
+          }
+
+          const elf::elf_xword merge = SHF_MERGE | SHF_STRINGS;
+          elf::elf_xword       keep = os.shdr.sh_flags & sec.flags () & merge;
+
+          os.shdr.sh_flags =
+            ((os.shdr.sh_flags | sec.flags ()) & ~(merge | SHF_GROUP)) | keep;
+
+          if (os.shdr.sh_entsize != sec.entry_size ())
+          {
+            os.shdr.sh_entsize = 0;
+            os.shdr.sh_flags &= ~merge;
+          }
+        }
+
+        reloc_section& os = out.sections[ni->second];
+        elf::elf_addr  offset = align_offset (os.shdr.sh_size, sec.alignment ());
+
+        if (sec.alignment () > os.shdr.sh_addralign)
+          os.shdr.sh_addralign = sec.alignment ();
+
+        if (os.shdr.sh_type != SHT_NOBITS)
+        {
+          os.data.resize (offset + sec.size (), 0);
+          if ((sec.type () != SHT_NOBITS) && (sec.size () != 0) &&
+              !obj.seek_read (sec.offset (), &os.data[offset], sec.size ()))
+            throw rld::error ("Section read failed: " + sec.name (),
+                              "relocatable: " + obj.name ().full ());
+        }
+
+        os.shdr.sh_size = offset + sec.size ();
+
+        out_sec[s] = ni->second;
+        sec_offset[s] = offset;
+      }
+
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        elf::section& sec = secs[s];
+        if ((out_sec[s] >= 0) && ((sec.flags () & SHF_LINK_ORDER) != 0) &&
+            (sec.link () < shnum) && (out_sec[sec.link ()] >= 0))
+          out.sections[out_sec[s]].link = out_sec[sec.link ()];
+      }
+
+      /*
+       * Add the symbols. A section symbol is the output section's symbol and
+       * the offset of the input section. A global in a discarded section is
+       * a reference to the definition linked.
+       */
+      std::vector < reloc_symref >  sym_map;
+      std::vector < elf::elf_addr > sym_offset;
+
+      if (symtab != 0)
+      {
+        elf::section& sec = secs[symtab];
+        int           syms = sec.entries ();
+
+        sym_map.resize (syms);
+        sym_offset.resize (syms, 0);
+
+        for (int s = 1; s < syms; ++s)
+        {
+          elf::elf_sym esym;
+
+          if (!::gelf_getsym (sec.data (), s, &esym))
+            throw rld::error (::elf_errmsg (-1),
+                              "relocatable:gelf_getsym: " + obj.name ().full ());
+
+          reloc_symbol sym;
+          bool         dropped = false;
+
+          sym.name = elf.get_string (sec.link (), esym.st_name);
+          sym.esym = esym;
+          sym.section = -1;
+          sym.object = obj.name ().full ();
+
+          if ((esym.st_shndx != SHN_UNDEF) && (esym.st_shndx < SHN_LORESERVE))
+          {
+            if ((esym.st_shndx >= shnum) || (out_sec[esym.st_shndx] < 0))
+              dropped = true;
+            else
+            {
+              sym.section = out_sec[esym.st_shndx];
+              sym.esym.st_value += sec_offset[esym.st_shndx];
+            }
+          }
+
+          if (GELF_ST_TYPE (esym.st_info) == STT_SECTION)
+          {
+            if (sym.section >= 0)
+            {
+              sym_map[s] = reloc_symref (reloc_symref::ref_section,
+                                         sym.section);
+              sym_offset[s] = sec_offset[esym.st_shndx];
+            }
+          }
+          else if (GELF_ST_BIND (esym.st_info) == STB_LOCAL)
+          {
+            if (!dropped)
+            {
+              sym_map[s] = reloc_symref (reloc_symref::ref_local,
+                                         out.locals.size ());
+              out.locals.push_back (sym);
+            }
+          }
+          else
+          {
+            if (dropped)
+            {
+              sym.esym.st_shndx = SHN_UNDEF;
+              sym.esym.st_value = 0;
+              sym.esym.st_size = 0;
+            }
+            sym_map[s] = reloc_symref (reloc_symref::ref_global,
+                                       reloc_merge_symbol (out, sym));
+          }
+        }
+      }
+
+      /*
+       * Move the relocation records to the output sections and symbols.
+       */
+      for (size_t s = 1; s < shnum; ++s)
+      {
+        elf::section& sec = secs[s];
+
+        if ((sec.type () != SHT_REL) && (sec.type () != SHT_RELA))
+          continue;
+
+        size_t target = sec.info ();
+
+        if ((target >= shnum) || (out_sec[target] < 0))
+          continue;
+
+        reloc_section& os = out.sections[out_sec[target]];
+        bool           rela = sec.type () == SHT_RELA;
+        int            rels = sec.entries ();
+
+        if (os.relocs.empty ())
+          os.rela = rela;
+        else if (os.rela != rela)
+          throw rld::error ("REL and RELA records mixed: " + os.name,
+                            "relocatable: " + obj.name ().full ());
+
+        for (int r = 0; r < rels; ++r)
+        {
+          reloc_record   rec;
+          elf::elf_xword info;
+
+          if (rela)
+          {
+            elf::elf_rela erela;
+
+            if (!::gelf_getrela (sec.data (), r, &erela))
+              throw rld::error (::elf_errmsg (-1),
+                                "relocatable:gelf_getrela: " + obj.name ().full ());
+
+            rec.offset = erela.r_offset;
+            rec.addend = erela.r_addend;
+            info = erela.r_info;
+          }
+          else
+          {
+            elf::elf_rel erel;
+
+            if (!::gelf_getrel (sec.data (), r, &erel))
+              throw rld::error (::elf_errmsg (-1),
+                                "relocatable:gelf_getrel: " + obj.name ().full ());
+
+            rec.offset = erel.r_offset;
+            rec.addend = 0;
+            info = erel.r_info;
+          }
+
+          size_t symbol = GELF_R_SYM (info);
+
+          if ((symbol != 0) && (symbol >= sym_map.size ()))
+            throw rld::error ("Invalid relocation symbol: " + sec.name (),
+                              "relocatable: " + obj.name ().full ());
+
+          rec.offset += sec_offset[target];
+          rec.type = GELF_R_TYPE (info);
+
+          if (symbol != 0)
+          {
+            rec.symbol = sym_map[symbol];
+
+            if ((rec.symbol.type == reloc_symref::ref_section) &&
+                (sym_offset[symbol] != 0))
+            {
+              if (rela)
+                rec.addend += sym_offset[symbol];
+              else
+                rec.symbol = reloc_anchor (out,
+                                           rec.symbol.index,
+                                           sym_offset[symbol]);
+            }
+          }
+
+          os.relocs.push_back (rec);
+        }
+      }
+    }
+
+    /**
+     * Add a string to the string table returning its offset.
+     */
+    static elf::elf_word
+    reloc_string (std::string&       strtab,
+                  reloc_index&       strings,
+                  const std::string& str)
+    {
+      if (str.empty ())
+        return 0;
+
+      reloc_index::iterator si = strings.find (str);
+
+      if (si == strings.end ())
+      {
+        si = strings.insert (std::make_pair (str, strtab.size ())).first;
+        strtab += str;
+        strtab += '\0';
+      }
+
+      return si->second;
+    }
+
+    /**
+     * Put a symbol in the output symbol table.
+     */
+    static void
+    reloc_put_symbol (elf::section&       symtab,
+                      size_t              index,
+                      const reloc_symbol& sym,
+                      std::string&        strtab,
+                      reloc_index&        strings)
+    {
+      elf::elf_sym esym = sym.esym;
+
+      esym.st_name = reloc_string (strtab, strings, sym.name);
+      if (sym.section >= 0)
+        esym.st_shndx = sym.section + 1;
+
+      if (!::gelf_update_sym (symtab.data (), index, &esym))
+        throw rld::error (::elf_errmsg (-1), "relocatable:gelf_update_sym");
+    }
+
+    /**
+     * Write the relocatable output. The sections are the output sections,
+     * their relocation sections, the symbol table and the string table.
+     */
+    static void
+    reloc_write (reloc_output& out, files::object& obj)
+    {
+      elf::file&   elf = obj.elf ();
+      const bool   class64 = elf::object_class () == ELFCLASS64;
+      const size_t sections = out.sections.size ();
+      size_t       rel_sections = 0;
+
+      elf.set_header (ET_REL,
+                      elf::object_class (),
+                      elf::object_machine_type (),
+                      elf::object_datatype (),
+                      out.flags);
+
+      for (size_t s = 0; s < sections; ++s)
+        if (!out.sections[s].relocs.empty ())
+          ++rel_sections;
+
+      const size_t first_local = sections + 1;
+      const size_t first_global = first_local + out.locals.size ();
+      const size_t symbols = first_global + out.globals.size ();
+      const int    symtab_index = sections + rel_sections + 1;
+      const int    strtab_index = symtab_index + 1;
+
+      for (size_t s = 0; s < sections; ++s)
+      {
+        reloc_section& os = out.sections[s];
+        elf::section   sec (elf,
+                            s + 1,
+                            os.name,
+                            os.shdr.sh_type,
+                            os.shdr.sh_addralign,
+                            os.shdr.sh_flags,
+                            0,
+                            0,
+                            os.shdr.sh_size,
+                            os.link < 0 ? 0 : os.link + 1,
+                            0,
+                            os.shdr.sh_entsize);
+
+        if (os.shdr.sh_type != SHT_NOBITS)
+          sec.add_data (ELF_T_BYTE,
+                        os.shdr.sh_addralign ? os.shdr.sh_addralign : 1,
+                        os.data.size (),
+                        os.data.empty () ? 0 : &os.data[0]);
+
+        elf.add (sec);
+      }
+
+      /*
+       * The buffers are held until the file is written.
+       */
+      std::list < std::vector < uint8_t > > buffers;
+      int                                   index = sections + 1;
+
+      for (size_t s = 0; s < sections; ++s)
+      {
+        reloc_section& os = out.sections[s];
+
+        if (os.relocs.empty ())
+          continue;
+
+        elf::elf_type  type = os.rela ? ELF_T_RELA : ELF_T_REL;
+        elf::elf_xword entsize =
+          ::gelf_fsize (elf.get_elf (), type, 1, EV_CURRENT);
+        elf::elf_xword size = entsize * os.relocs.size ();
+        elf::section   sec (elf,
+                            index,
+                            (os.rela ? ".rela" : ".rel") + os.name,
+                            os.rela ? SHT_RELA : SHT_REL,
+                            class64 ? 8 : 4,
+                            SHF_INFO_LINK,
+                            0,
+                            0,
+                            size,
+                            symtab_index,
+                            s + 1,
+                            entsize);
+
+        buffers.push_back (std::vector < uint8_t > (size));
+        sec.add_data (type, class64 ? 8 : 4, size, &buffers.back ()[0]);
+
+        for (size_t r = 0; r < os.relocs.size (); ++r)
+        {
+          const reloc_record& rec = os.relocs[r];
+          size_t              symbol = 0;
+
+          switch (rec.symbol.type)
+          {
+            case reloc_symref::ref_section:
+              symbol = rec.symbol.index + 1;
+              break;
+            case reloc_symref::ref_local:
+              symbol = first_local + rec.symbol.index;
+              break;
+            case reloc_symref::ref_global:
+              symbol = first_global + rec.symbol.index;
+              break;
+            default:
+              break;
+          }
+
+          bool ok;
+
+          if (os.rela)
+          {
+            elf::elf_rela erela;
+            erela.r_offset = rec.offset;
+            erela.r_info = GELF_R_INFO (symbol, rec.type);
+            erela.r_addend = rec.addend;
+            ok = ::gelf_update_rela (sec.data (), r, &erela);
+          }
+          else
+          {
+            elf::elf_rel erel;
+            erel.r_offset = rec.offset;
+            erel.r_info = GELF_R_INFO (symbol, rec.type);
+            ok = ::gelf_update_rel (sec.data (), r, &erel);
+          }
+
+          if (!ok)
+            throw rld::error (::elf_errmsg (-1),
+                              "relocatable:gelf_update_rel: " + os.name);
+        }
+
+        elf.add (sec);
+        ++index;
+      }
+
+      /*
+       * The symbol table is the null symbol, the section symbols, the local
+       * symbols and the global symbols.
+       */
+      std::string    strtab (1, '\0');
+      reloc_index    strings;
+      elf::elf_xword entsize =
+        ::gelf_fsize (elf.get_elf (), ELF_T_SYM, 1, EV_CURRENT);
+      elf::elf_xword size = entsize * symbols;
+      elf::section   symtab (elf,
+                             symtab_index,
+                             ".symtab",
+                             SHT_SYMTAB,
+                             class64 ? 8 : 4,
+                             0,
+                             0,
+                             0,
+                             size,
+                             strtab_index,
+                             first_global,
+                             entsize);
+
+      buffers.push_back (std::vector < uint8_t > (size));
+      symtab.add_data (ELF_T_SYM, class64 ? 8 : 4, size, &buffers.back ()[0]);
+
+      elf::elf_sym esym;
+
+      ::memset (&esym, 0, sizeof (esym));
+      if (!::gelf_update_sym (symtab.data (), 0, &esym))
+        throw rld::error (::elf_errmsg (-1), "relocatable:gelf_update_sym");
+
+      for (size_t s = 0; s < sections; ++s)
+      {
+        esym.st_info = GELF_ST_INFO (STB_LOCAL, STT_SECTION);
+        esym.st_shndx = s + 1;
+        if (!::gelf_update_sym (symtab.data (), s + 1, &esym))
+          throw rld::error (::elf_errmsg (-1), "relocatable:gelf_update_sym");
+      }
+
+      for (size_t l = 0; l < out.locals.size (); ++l)
+        reloc_put_symbol (symtab, first_local + l, out.locals[l], strtab, strings);
+
+      for (size_t g = 0; g < out.globals.size (); ++g)
+        reloc_put_symbol (symtab, first_global + g, out.globals[g], strtab, strings);
+
+      elf.add (symtab);
+
+      elf::section strsec (elf,
+                           strtab_index,
+                           ".strtab",
+                           SHT_STRTAB,
+                           1,
+                           0,
+                           0,
+                           0,
+                           strtab.size ());
+
+      strsec.add_data (ELF_T_BYTE, 1, strtab.size (), (void*) strtab.c_str ());
+
+      elf.add (strsec);
+
+      elf.write ();
+    }
+
+    void
+    relocatable (const std::string&        name,
+                 const files::object_list& dependents,
+                 const files::cache&       cache)
+    {
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "outputter:relocatable: " << name << std::endl;
+
+      files::object_list          dep_copy (dependents);
+      files::object_list          objects;
+      std::set < files::object* > linked;
+      reloc_output                out;
+
+      cache.get_objects (objects);
+      objects.merge (dep_copy);
+
+      /*
+       * The objects are linked in order so remove the duplicates without
+       * sorting.
+       */
+      for (files::object_list::iterator oi = objects.begin ();
+           oi != objects.end ();
+           ++oi)
+      {
+        files::object& obj = *(*oi);
+
+        if (!linked.insert (&obj).second)
+          continue;
+
+        obj.open ();
+
+        try
+        {
+          obj.begin ();
+          try
+          {
+            reloc_object (out, obj, linked.size () == 1);
+          }
+          catch (...)
+          {
+            obj.end ();
+            throw;
+          }
+          obj.end ();
+        }
+        catch (...)
+        {
+          obj.close ();
+          throw;
+        }
+
+        obj.close ();
+      }
+
+      files::object reloc (name);
+
+      reloc.open (true);
+
+      try
+      {
+        reloc.begin ();
+        try
+        {
+          reloc_write (out, reloc);
+        }
+        catch (...)
+        {
+          reloc.end ();
+          throw;
+        }
+        reloc.end ();
+      }
+      catch (...)
+      {
+        reloc.close ();
+        throw;
+      }
+
+      reloc.close ();
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+      {
+        size_t relocs = 0;
+        for (size_t s = 0; s < out.sections.size (); ++s)
+          relocs += out.sections[s].relocs.size ();
+        std::cout << "outputter:relocatable: objects: " << linked.size ()
+                  << " sections: " << out.sections.size ()
+                  << " locals: " << out.locals.size ()
+                  << " globals: " << out.globals.size ()
+                  << " relocs: " << relocs << std::endl;
+      }
+    }
+
     bool in_archive (files::object* object)
     {
       if (object->get_archive ())
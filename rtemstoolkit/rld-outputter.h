@@ -31,6 +31,21 @@ namespace rld
 {
   namespace outputter
   {
+    /**
+     * Strip the debug and other sections the target does not load from the
+     * objects in an ELF application and write them to a debug object for
+     * each object in a debug directory.
+     */
+    extern bool strip_debug;
+
+    /**
+     * The debug directory. The default is the output file with '.debug'
+     * appended. The debug objects are ELF files in the directory's
+     * '.build-id' tree so a debugger given the directory as its debug file
+     * directory finds them by the build-id of the loaded object.
+     */
+    extern std::string debug_dir;
+
     /**
      * Output the object file list as a string.
      *
@@ -55,12 +70,14 @@ namespace rld
      * @param dependents The list of dependent object files
      * @param cache The file cache for the link. Includes the object list
      *              the user requested.
+     * @param thin Output a GNU thin archive that references the object files.
      */
     void archive (const std::string&        name,
                   const std::string&        entry,
                   const std::string&        exit,
                   const files::object_list& dependents,
-                  const files::cache&       cache);
+                  const files::cache&       cache,
+                  bool                      thin = false);
 
     void archivera (const std::string&        name,
                     const files::object_list& dependents,
@@ -85,7 +102,10 @@ namespace rld
                  const files::cache&       cache);
 
     /**
-     * Output the object files in an archive with the metadata.
+     * Output the object files in an archive with the metadata. If stripping
+     * the debug sections each object is split into the object the target
+     * loads and the object's debug sections in the debug file. The objects
+     * in each file have the same GNU build-id note.
      *
      * @param name The name of the script.
      * @param entry The name of the entry point symbol.
@@ -100,6 +120,21 @@ namespace rld
                           const files::object_list& dependents,
                           const files::cache&       cache);
 
+    /**
+     * Output the object files as a single relocatable ELF object, a partial
+     * link. The like named sections are concatenated, the symbol tables are
+     * merged and the relocation records are moved to the merged sections
+     * and symbols. The sections of a COMDAT group are linked once.
+     *
+     * @param name The name of the relocatable object.
+     * @param dependents The list of dependent object files
+     * @param cache The file cache for the link. Includes the object list
+     *              the user requested.
+     */
+    void relocatable (const std::string&        name,
+                      const files::object_list& dependents,
+                      const files::cache&       cache);
+
     /**
      * Output the object files in an archive with the metadata.
      *
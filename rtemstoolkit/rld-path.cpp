@@ -215,6 +215,26 @@ namespace rld
       }
     }
 
+    void
+    mkdir (const std::string& path)
+    {
+      if (path.empty () || check_directory (path))
+        return;
+
+      size_t b = path.find_last_of (RLD_PATH_SEPARATOR);
+      if ((b != std::string::npos) && (b > 0))
+        mkdir (path.substr (0, b));
+
+      int r;
+#if _WIN32
+      r = ::mkdir (path.c_str ());
+#else
+      r = ::mkdir (path.c_str (), S_IRWXU | S_IRWXG | S_IRWXO);
+#endif
+      if ((r < 0) && !check_directory (path))
+        throw rld::error (::strerror (errno), "mkdir: " + path);
+    }
+
     void
     get_system_path (paths& paths)
     {
@@ -144,6 +144,13 @@ namespace rld
      */
     void unlink (const std::string& path, bool not_present_error = false);
 
+    /**
+     * Make the directory and any parent directories that are not present.
+     *
+     * @param path The path of the directory to make.
+     */
+    void mkdir (const std::string& path);
+
     /**
      * Return the system path as a set of strings.
      *
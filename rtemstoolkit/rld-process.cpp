@@ -57,6 +57,7 @@
 #endif
 
 #include <iostream>
+#include <map>
 
 #include "rld.h"
 #include "rld-process.h"
@@ -401,6 +402,44 @@ namespace rld
       return execute (pname, args, outname, errname);
     }
 
+    /**
+     * Convert the wait status of a process to a status.
+     */
+    static status
+    decode_status (int s, const std::string& pname)
+    {
+      status _status;
+
+      if (rld::verbose (RLD_VERBOSE_TRACE))
+        std::cout << "execute: status: ";
+
+      if (WIFEXITED (s))
+      {
+        _status.type = status::normal;
+        _status.code = WEXITSTATUS (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << _status.code << std::endl;
+      }
+      else if (WIFSIGNALED (s))
+      {
+        _status.type = status::signal;
+        _status.code = WTERMSIG (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << "signal: " << _status.code << std::endl;
+      }
+      else if (WIFSTOPPED (s))
+      {
+        _status.type = status::stopped;
+        _status.code = WSTOPSIG (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << "stopped: " << _status.code << std::endl;
+      }
+      else
+        throw rld::error ("execute: " + pname, "unknown status returned");
+
+      return _status;
+    }
+
     status
     execute (const std::string&   pname,
              const arg_container& args,
@@ -440,36 +479,257 @@ namespace rld
       else if (err)
         throw rld::error ("execute: " + args[0], ::strerror (err));
 
-      status _status;
+      return decode_status (s, args[0]);
+    }
 
-      if (rld::verbose (RLD_VERBOSE_TRACE))
-        std::cout << "execute: status: ";
+#if !__WIN32__
+    /**
+     * Redirect a file descriptor of a job to a file.
+     */
+    static bool
+    redirect_job_file (const std::string& name, int fd)
+    {
+      int nfd = ::open (name.c_str (),
+                        O_WRONLY | O_CREAT | O_TRUNC | OPEN_FLAGS,
+                        CREATE_MODE);
+      if (nfd < 0)
+        return false;
+      if (nfd != fd)
+      {
+        if (::dup2 (nfd, fd) < 0)
+          return false;
+        ::close (nfd);
+      }
+      return true;
+    }
 
-      if (WIFEXITED (s))
+    /**
+     * Start a job and return its process id. A pipe that is closed when the
+     * program is executed returns the error of a job that fails to start.
+     */
+    static pid_t
+    start_job (const job& job_)
+    {
+      const char** cargs = new const char* [job_.args.size () + 1];
+
+      for (size_t a = 0; a < job_.args.size (); ++a)
+        cargs[a] = job_.args[a].c_str ();
+      cargs[job_.args.size ()] = 0;
+
+      int fds[2];
+
+      if (::pipe (fds) < 0)
       {
-        _status.type = status::normal;
-        _status.code = WEXITSTATUS (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << _status.code << std::endl;
+        delete [] cargs;
+        throw rld::error ("execute: " + job_.args[0], ::strerror (errno));
       }
-      else if (WIFSIGNALED (s))
+
+      ::fcntl (fds[1], F_SETFD, FD_CLOEXEC);
+
+      pid_t pid = ::fork ();
+
+      if (pid == 0)
       {
-        _status.type = status::signal;
-        _status.code = WTERMSIG (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << "signal: " << _status.code << std::endl;
+        ::close (fds[0]);
+        if (redirect_job_file (job_.outname, STDOUT_FILENO) &&
+            redirect_job_file (job_.errname, STDERR_FILENO))
+          ::execvp (cargs[0], (char* const*) cargs);
+        int     err = errno;
+        ssize_t w = ::write (fds[1], &err, sizeof (err));
+        (void) w;
+        ::_exit (127);
       }
-      else if (WIFSTOPPED (s))
+
+      int err = pid < 0 ? errno : 0;
+
+      delete [] cargs;
+      ::close (fds[1]);
+
+      if (pid > 0)
       {
-        _status.type = status::stopped;
-        _status.code = WSTOPSIG (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << "stopped: " << _status.code << std::endl;
+        ssize_t r;
+        do
+          r = ::read (fds[0], &err, sizeof (err));
+        while ((r < 0) && (errno == EINTR));
+        if (r == sizeof (err))
+          ::waitpid (pid, 0, 0);
+        else
+          err = 0;
       }
-      else
-        throw rld::error ("execute: " + args[0], "unknown status returned");
 
-      return _status;
+      ::close (fds[0]);
+
+      if (err)
+        throw rld::error ("execute: " + job_.args[0], ::strerror (err));
+
+      return pid;
+    }
+#endif
+
+    void
+    execute (const std::string& pname,
+             jobs&              jobs_,
+             size_t             concurrent)
+    {
+      if (concurrent == 0)
+        concurrent = 1;
+
+#if __WIN32__
+      /*
+       * A pex object can only wait for all its processes and there is no
+       * portable wait for any process on Windows. Start a batch of jobs then
+       * wait for the batch to finish. Each job has its own pex object so the
+       * processes run at the same time.
+       */
+      for (size_t first = 0; first < jobs_.size (); first += concurrent)
+      {
+        size_t last = first + concurrent;
+        if (last > jobs_.size ())
+          last = jobs_.size ();
+
+        std::vector < pex_obj* > pexs;
+        std::string              serr;
+        std::string              swhat;
+
+        for (size_t j = first; j < last; ++j)
+        {
+          job& job_ = jobs_[j];
+
+          if (rld::verbose (RLD_VERBOSE_TRACE))
+          {
+            std::cout << "execute: job " << j << ": ";
+            for (size_t a = 0; a < job_.args.size (); ++a)
+              std::cout << job_.args[a] << ' ';
+            std::cout << std::endl;
+          }
+
+          const char** cargs = new const char* [job_.args.size () + 1];
+
+          for (size_t a = 0; a < job_.args.size (); ++a)
+            cargs[a] = job_.args[a].c_str ();
+          cargs[job_.args.size ()] = 0;
+
+          int      err = 0;
+          pex_obj* px = pex_init (0, pname.c_str (), NULL);
+
+          const char* perr = pex_run (px,
+                                      PEX_LAST | PEX_SEARCH,
+                                      job_.args[0].c_str (),
+                                      (char* const*) cargs,
+                                      job_.outname.c_str (),
+                                      job_.errname.c_str (),
+                                      &err);
+
+          delete [] cargs;
+
+          pexs.push_back (px);
+
+          if (perr || err)
+          {
+            swhat = "execute: " + job_.args[0];
+            serr = perr ? perr : ::strerror (err);
+            break;
+          }
+        }
+
+        /*
+         * Wait for all started jobs even if one failed to start.
+         */
+        for (size_t p = 0; p < pexs.size (); ++p)
+        {
+          int s = 0;
+          if (serr.empty ())
+          {
+            if (!pex_get_status (pexs[p], 1, &s))
+            {
+              swhat = "execute: " + jobs_[first + p].args[0];
+              serr = "pex_get_status failed";
+            }
+            else
+              jobs_[first + p].result = decode_status (s, jobs_[first + p].args[0]);
+          }
+          pex_free (pexs[p]);
+        }
+
+        if (!serr.empty ())
+          throw rld::error (swhat, serr);
+      }
+#else
+      /*
+       * Keep up to the concurrent number of jobs running and start the next
+       * job as soon as any job finishes.
+       */
+      typedef std::map < pid_t, size_t > running_jobs;
+
+      running_jobs running;
+      size_t       next = 0;
+      std::string  serr;
+      std::string  swhat;
+
+      (void) pname;
+
+      while (true)
+      {
+        while (serr.empty () &&
+               (next < jobs_.size ()) &&
+               (running.size () < concurrent))
+        {
+          job& job_ = jobs_[next];
+
+          if (rld::verbose (RLD_VERBOSE_TRACE))
+          {
+            std::cout << "execute: job " << next << ": ";
+            for (size_t a = 0; a < job_.args.size (); ++a)
+              std::cout << job_.args[a] << ' ';
+            std::cout << std::endl;
+          }
+
+          try
+          {
+            running[start_job (job_)] = next;
+            ++next;
+          }
+          catch (rld::error& re)
+          {
+            swhat = re.what;
+            serr = re.where;
+          }
+        }
+
+        /*
+         * Wait for all started jobs even if one failed to start.
+         */
+        if (running.empty ())
+          break;
+
+        int   s = 0;
+        pid_t pid = ::waitpid (-1, &s, 0);
+
+        if (pid < 0)
+        {
+          int err = errno;
+          if (err == EINTR)
+            continue;
+          if (serr.empty ())
+          {
+            swhat = "execute: " + jobs_[running.begin ()->second].args[0];
+            serr = ::strerror (err);
+          }
+          break;
+        }
+
+        running_jobs::iterator ri = running.find (pid);
+        if (ri != running.end ())
+        {
+          job& job_ = jobs_[ri->second];
+          running.erase (ri);
+          job_.result = decode_status (s, job_.args[0]);
+        }
+      }
+
+      if (!serr.empty ())
+        throw rld::error (swhat, serr);
+#endif
     }
 
     /*
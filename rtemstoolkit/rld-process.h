@@ -251,6 +251,32 @@ namespace rld
                     const std::string& outname,
                     const std::string& errname);
 
+    /**
+     * A job is a process to execute with the files its stdout and stderr are
+     * captured in. The status is set when the job has finished.
+     */
+    struct job
+    {
+      arg_container args;    //< The program and its arguments.
+      std::string   outname; //< The file stdout is captured in.
+      std::string   errname; //< The file stderr is captured in.
+      status        result;  //< The status of the finished job.
+    };
+
+    /**
+     * A container of jobs.
+     */
+    typedef std::vector < job > jobs;
+
+    /**
+     * Execute the jobs with up to the concurrent number of jobs running at
+     * once. Returns when all jobs have finished. The status of each job is
+     * held in the job.
+     */
+    void execute (const std::string& pname,
+                  jobs&              jobs_,
+                  size_t             concurrent);
+
     /**
      * Parse a command line into arguments. It support quoting.
      */
@@ -30,11 +30,15 @@
 #include <string.h>
 
 #include <algorithm>
+#include <fstream>
 #include <list>
+#include <map>
+#include <set>
 #include <iomanip>
 
 #include <rld.h>
 #include <rld-compression.h>
+#include <rld-crc.h>
 #include <rld-rap.h>
 
 namespace rld
@@ -47,6 +51,31 @@ namespace rld
      */
     bool add_obj_details = true;
 
+    /**
+     * Pack the sections by alignment.
+     */
+    bool pack_sections = false;
+
+    /**
+     * The function order file.
+     */
+    std::string function_order;
+
+    /**
+     * Front code the string table.
+     */
+    bool front_code_strings = false;
+
+    /**
+     * The XIP alignment.
+     */
+    uint32_t xip_alignment = 0;
+
+    /**
+     * Checksum the image.
+     */
+    bool checksum = false;
+
     /**
      * Store the path of object files.
      */
@@ -73,7 +102,7 @@ namespace rld
       uint32_t    offset;    //< The offset in the section to apply the fixup.
       uint32_t    info;      //< The ELF info record.
       uint32_t    addend;    //< The ELF constant addend.
-      std::string symname;   //< The symbol name if there is one.
+      uint32_t    symindex;  //< The symbol's index in the object's symbols.
       uint32_t    symtype;   //< The type of symbol.
       int         symsect;   //< The symbol's RAP section.
       uint32_t    symvalue;  //< The symbol's default value.
@@ -92,14 +121,16 @@ namespace rld
     typedef std::vector < relocation > relocations;
 
     /**
-     * Relocation symname sorter for the relocations container.
+     * Relocation symbol sorter for the relocations container. The relocations
+     * of a section are from one object file so the symbol index groups the
+     * relocations by symbol.
      */
-    class reloc_symname_compare
+    class reloc_symindex_compare
     {
     public:
       bool operator () (const relocation& lhs,
                         const relocation& rhs) const {
-        return lhs.symname < rhs.symname;
+        return lhs.symindex < rhs.symindex;
       }
     };
 
@@ -111,7 +142,7 @@ namespace rld
     public:
       bool operator () (const relocation& lhs,
                         const relocation& rhs) const {
-        if (lhs.symname == rhs.symname)
+        if (lhs.symindex == rhs.symindex)
           return lhs.offset < rhs.offset;
         else return false;
       }
@@ -231,6 +262,28 @@ namespace rld
       void output ();
     };
 
+    /**
+     * The weight of a function in the function order file.
+     */
+    struct function_weight
+    {
+      uint32_t weight;    //< The weight, 0 is cold.
+      uint32_t position;  //< The line in the function order file.
+
+      function_weight (uint32_t weight = 0, uint32_t position = 0);
+    };
+
+    /**
+     * The function weights keyed by function name.
+     */
+    typedef std::map < std::string, function_weight > function_weights;
+
+    /**
+     * The weights of the text sections in an object file keyed by the object
+     * file section index.
+     */
+    typedef std::map < int, function_weight > osecweights;
+
     /**
      * A symbol. This matches the symbol structure 'rtems_rtl_obj_sym_t' in the
      * target code.
@@ -283,6 +336,10 @@ namespace rld
       files::sections symtab;         //< All exported symbols.
       files::sections strtab;         //< All exported strings.
       section         secs[rap_secs]; //< The sections of interest.
+      osecweights     text_weights;   //< The weights of the text sections.
+      std::vector < std::size_t > strtab_offsets; //< The string table offset
+                                      //  of each symbol, found on the symbol's
+                                      //  first reference.
 
       /**
        * The constructor. Need to have an object file to create.
@@ -299,6 +356,22 @@ namespace rld
        */
       sections find (const uint32_t index) const;
 
+      /**
+       * The object file sections that are merged into the RAP section.
+       */
+      files::sections& get_sections (sections sec);
+
+      /**
+       * Weigh the text sections using the weights of the functions they
+       * hold. A section takes the largest weight of its functions.
+       */
+      void weigh_text (const function_weights& weights);
+
+      /**
+       * The name of a symbol in the object file's symbol table.
+       */
+      const std::string& symbol_name (uint32_t symindex) const;
+
       /**
        * The total number of relocations in the object file.
        */
@@ -327,6 +400,29 @@ namespace rld
      */
     typedef std::list < object > objects;
 
+    /**
+     * The placement of an object file section in a RAP section when the
+     * sections are ordered across the object files. The group and weight are
+     * only used when the text is ordered.
+     */
+    struct placement
+    {
+      object*               obj;     //< The object the section is part of.
+      const files::section* fsec;    //< The object file section.
+      int                   group;   //< Hot (0), not listed (1) or cold (2).
+      function_weight       weight;  //< The section's weight.
+
+      /**
+       * The constructor.
+       */
+      placement (object& obj, const files::section& fsec, int group = 1);
+    };
+
+    /**
+     * An ordered container of placements.
+     */
+    typedef std::vector < placement > placements;
+
     /**
      * The RAP image.
      */
@@ -349,6 +445,34 @@ namespace rld
                    const std::string&        init,
                    const std::string&        fini);
 
+      /**
+       * Order the text sections across the objects using the function
+       * weights. The object text sections have an offset of 0 and the object
+       * file section offsets are the offsets in the RAP text section.
+       *
+       * @param weights The function weights.
+       */
+      void order_text (const function_weights& weights);
+
+      /**
+       * Pack the object file sections of a RAP section across the objects so
+       * the sections with the largest alignment are first. The sort is
+       * stable so sections with the same alignment remain in link order.
+       *
+       * @param sec The RAP section to pack.
+       */
+      void pack (sections sec);
+
+      /**
+       * Place the object file sections of a RAP section in the order held in
+       * the section's placements. The object sections have an offset of 0
+       * and the object file section offsets are the offsets in the RAP
+       * section. The relocations are moved to the new offsets.
+       *
+       * @param sec The RAP section to place.
+       */
+      void place (sections sec);
+
       /**
        * Collection the symbols from the object file.
        *
@@ -361,8 +485,10 @@ namespace rld
        * interface.
        *
        * @param comp The compressor.
+       * @param base The file offset of the compressor's output. An XIP image
+       *             uses the base to align the sections in the file.
        */
-      void write (compress::compressor& comp);
+      void write (compress::compressor& comp, uint32_t base);
 
       /**
        * Write the RAP section to the compressed output file given the object files.
@@ -393,11 +519,35 @@ namespace rld
        */
       void write_externals (compress::compressor& comp);
 
+      /**
+       * Write the padding to the XIP file offset of a section.
+       *
+       * @param comp The compressor.
+       * @param base The file offset of the compressor's output.
+       * @param offset The XIP file offset of the section.
+       */
+      void write_xip_padding (compress::compressor& comp,
+                              uint32_t              base,
+                              uint32_t              offset);
+
       /**
        * Write the relocation records for all the object files.
        */
       void write_relocations (compress::compressor& comp);
 
+      /**
+       * Write a relocation record of an object file's RAP section.
+       *
+       * @param comp The compressor.
+       * @param obj The object file the relocation is part of.
+       * @param sec The RAP section of the object file.
+       * @param reloc The relocation to write.
+       */
+      void write_relocation (compress::compressor& comp,
+                             object&               obj,
+                             const section&        sec,
+                             const relocation&     reloc);
+
       /**
        * Write the details of the files.
        */
@@ -424,6 +574,19 @@ namespace rld
        */
       std::size_t find_in_strtab (const std::string& symname);
 
+      /**
+       * Find an object's symbol in the string table. The offset is found once
+       * for each symbol and held by the object.
+       */
+      std::size_t find_in_strtab (object& obj, uint32_t symindex);
+
+      /**
+       * Front code the string table once the strings are collected and set
+       * the string references to the index of the strings.
+       */
+      void front_code_strtab (const std::string& init,
+                              const std::string& fini);
+
     private:
 
       objects     objs;                //< The RAP objects
@@ -436,6 +599,11 @@ namespace rld
       uint32_t    relocs_size;         //< The relocations size.
       uint32_t    init_off;            //< The strtab offset to the init label.
       uint32_t    fini_off;            //< The strtab offset to the fini label.
+      placements  sec_order[rap_secs]; //< The section order if ordered.
+      std::map < std::string, uint32_t > strings; //< The index of each
+                                       //  string if front coded.
+      rld::strings extern_names;       //< The name of each external if
+                                       //  front coded.
     };
 
     const char*
@@ -477,7 +645,7 @@ namespace rld
       : offset (reloc.offset + offset),
         info (reloc.info),
         addend (reloc.addend),
-        symname (reloc.symname),
+        symindex (reloc.symindex),
         symtype (reloc.symtype),
         symsect (reloc.symsect),
         symvalue (reloc.symvalue),
@@ -743,7 +911,7 @@ namespace rld
 
       std::stable_sort (sec.relocs.begin (),
                         sec.relocs.end (),
-                        reloc_symname_compare ());
+                        reloc_symindex_compare ());
       std::stable_sort (sec.relocs.begin (),
                         sec.relocs.end (),
                         reloc_offset_compare ());
@@ -752,6 +920,108 @@ namespace rld
         sec.rela = fsec.rela;
     }
 
+    function_weight::function_weight (uint32_t weight, uint32_t position)
+      : weight (weight),
+        position (position)
+    {
+    }
+
+    /**
+     * Load the function order file.
+     */
+    static void
+    load_function_order (const std::string& path, function_weights& weights)
+    {
+      std::ifstream in (path.c_str ());
+
+      if (!in.is_open ())
+        throw rld::error ("Cannot open: " + path, "rap::function-order");
+
+      std::string line;
+      uint32_t    position = 0;
+
+      while (std::getline (in, line))
+      {
+        ++position;
+
+        std::string::size_type comment = line.find ('#');
+        if (comment != std::string::npos)
+          line = line.substr (0, comment);
+
+        rld::strings fields;
+        rld::split (fields, line, ' ');
+
+        if (fields.empty ())
+          continue;
+
+        if (fields.size () > 2)
+          throw rld::error ("Invalid line " + rld::to_string (position) +
+                            ": " + path,
+                            "rap::function-order");
+
+        uint32_t weight = 1;
+
+        if (fields.size () == 2)
+        {
+          char* end = 0;
+          weight = ::strtoul (fields[1].c_str (), &end, 0);
+          if (*end != '\0')
+            throw rld::error ("Invalid weight on line " +
+                              rld::to_string (position) + ": " + path,
+                              "rap::function-order");
+        }
+
+        if (weights.find (fields[0]) == weights.end ())
+          weights[fields[0]] = function_weight (weight, position);
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "rap:function-order: " << path
+                  << ": functions: " << weights.size () << std::endl;
+    }
+
+    /**
+     * Order the text placements, hot first with the highest weight first then
+     * the sections not listed and then the cold sections. The sort is stable
+     * so the link order is kept within the groups. If the sections are packed
+     * the sections not listed and the cold sections are ordered with the
+     * largest alignment first.
+     */
+    class text_placement_compare
+    {
+    public:
+      bool operator () (const placement& lhs,
+                        const placement& rhs) const {
+        if (lhs.group != rhs.group)
+          return lhs.group < rhs.group;
+        if (lhs.group == 0)
+        {
+          if (lhs.weight.weight != rhs.weight.weight)
+            return lhs.weight.weight > rhs.weight.weight;
+          return lhs.weight.position < rhs.weight.position;
+        }
+        if (pack_sections)
+          return lhs.fsec->alignment > rhs.fsec->alignment;
+        return false;
+      }
+    };
+
+    /**
+     * Order the placements with the largest alignment first.
+     */
+    static bool
+    placement_align_compare (const placement& lhs, const placement& rhs)
+    {
+      return lhs.fsec->alignment > rhs.fsec->alignment;
+    }
+
+    placement::placement (object& obj, const files::section& fsec, int group)
+      : obj (&obj),
+        fsec (&fsec),
+        group (group)
+    {
+    }
+
     external::external (const uint32_t name,
                         const sections sec,
                         const uint32_t value,
@@ -783,14 +1053,15 @@ namespace rld
       /*
        * Get the relocation records. Collect the various section types from the
        * object file into the RAP sections. Merge those sections into the RAP
-       * sections.
+       * sections. The image only holds allocated sections so the relocation
+       * records of the debug sections are not loaded.
        */
 
       obj.open ();
       try
       {
         obj.begin ();
-        obj.load_relocations ();
+        obj.load_relocations (true);
         obj.end ();
       }
       catch (...)
@@ -832,12 +1103,20 @@ namespace rld
         data (orig.data),
         bss (orig.bss),
         symtab (orig.symtab),
-        strtab (orig.strtab)
+        strtab (orig.strtab),
+        text_weights (orig.text_weights),
+        strtab_offsets (orig.strtab_offsets)
     {
       for (int s = 0; s < rap_secs; ++s)
         secs[s] = orig.secs[s];
     }
 
+    const std::string&
+    object::symbol_name (uint32_t symindex) const
+    {
+      return obj.elf ().get_symbol (symindex).name ();
+    }
+
     sections
     object::find (const uint32_t index) const
     {
@@ -871,6 +1150,83 @@ namespace rld
                         "' not found: " + obj.name ().full (), "rap::object");
     }
 
+    files::sections&
+    object::get_sections (sections sec)
+    {
+      switch (sec)
+      {
+        case rap_text:
+          return text;
+        case rap_const:
+          return const_;
+        case rap_ctor:
+          return ctor;
+        case rap_dtor:
+          return dtor;
+        case rap_data:
+          return data;
+        case rap_bss:
+          return bss;
+        default:
+          break;
+      }
+      throw rld::error ("Invalid section '" + rld::to_string (sec) +
+                        "': " + obj.name ().full (), "rap::object");
+    }
+
+    void
+    object::weigh_text (const function_weights& weights)
+    {
+      symbols::pointers syms;
+
+      obj.open ();
+      try
+      {
+        obj.begin ();
+        obj.elf ().get_symbols (syms, false, true, true, true);
+
+        for (symbols::pointers::const_iterator si = syms.begin ();
+             si != syms.end ();
+             ++si)
+        {
+          const symbols::symbol& sym = *(*si);
+
+          if (sym.type () != STT_FUNC)
+            continue;
+
+          function_weights::const_iterator wi = weights.find (sym.name ());
+
+          if ((wi != weights.end ()) &&
+              files::find (text, sym.section_index ()))
+          {
+            const function_weight& fw = (*wi).second;
+            osecweights::iterator  owi = text_weights.find (sym.section_index ());
+
+            if (owi == text_weights.end ())
+            {
+              text_weights[sym.section_index ()] = fw;
+            }
+            else
+            {
+              function_weight& sw = (*owi).second;
+              if (fw.weight > sw.weight)
+                sw.weight = fw.weight;
+              if (fw.position < sw.position)
+                sw.position = fw.position;
+            }
+          }
+        }
+
+        obj.end ();
+      }
+      catch (...)
+      {
+        obj.close ();
+        throw;
+      }
+      obj.close ();
+    }
+
     uint32_t
     object::get_relocations () const
     {
@@ -964,6 +1320,42 @@ namespace rld
               sec_rela[s] = true;
           }
         }
+      }
+
+      /*
+       * Order the text sections and pack the sections across the object
+       * files once the sections have been laid out in link order and before
+       * the symbols are collected. The constructor and destructor tables are
+       * not packed as their order is the order the constructors and
+       * destructors are called. The link order sizes are held so the saving
+       * can be reported.
+       */
+      uint32_t linked_size[rap_secs];
+
+      for (int s = 0; s < rap_secs; ++s)
+        linked_size[s] = sec_size[s];
+
+      if (!function_order.empty ())
+      {
+        function_weights weights;
+        load_function_order (function_order, weights);
+        order_text (weights);
+      }
+
+      if (pack_sections)
+      {
+        if (function_order.empty ())
+          pack (rap_text);
+        pack (rap_const);
+        pack (rap_data);
+        pack (rap_bss);
+      }
+
+      for (objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+      {
+        object& obj = *oi;
 
         collect_symbols (obj);
 
@@ -973,13 +1365,39 @@ namespace rld
           obj.output ();
       }
 
-      init_off = strtab.size () + 1;
-      strtab += '\0';
-      strtab += init;
+      if (pack_sections && (rld::verbose () >= RLD_VERBOSE_INFO))
+      {
+        const int packed[] = { rap_text, rap_const, rap_data, rap_bss };
+        uint32_t  total = 0;
+
+        std::cout << "rap::layout: packing saved:";
+
+        for (int p = 0; p < 4; ++p)
+        {
+          int     s = packed[p];
+          int32_t saved = linked_size[s] - sec_size[s];
+          total += saved;
+
+          std::cout << ' ' << section_names[s] << ':' << saved;
+        }
+
+        std::cout << " total:" << (int32_t) total << std::endl;
+      }
+
+      if (front_code_strings)
+      {
+        front_code_strtab (init, fini);
+      }
+      else
+      {
+        init_off = strtab.size () + 1;
+        strtab += '\0';
+        strtab += init;
 
-      fini_off = strtab.size () + 1;
-      strtab += '\0';
-      strtab += fini;
+        fini_off = strtab.size () + 1;
+        strtab += '\0';
+        strtab += fini;
+      }
 
       if (rld::verbose () >= RLD_VERBOSE_INFO)
       {
@@ -1001,73 +1419,236 @@ namespace rld
     }
 
     void
-    image::collect_symbols (object& obj)
+    image::order_text (const function_weights& weights)
     {
-      symbols::pointers& esyms = obj.obj.external_symbols ();
-      for (symbols::pointers::const_iterator ei = esyms.begin ();
-           ei != esyms.end ();
-           ++ei)
+      placements& order = sec_order[rap_text];
+
+      order.clear ();
+
+      for (objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
       {
-        const symbols::symbol& sym = *(*ei);
+        object& obj = *oi;
 
-        if ((sym.type () == STT_OBJECT) || (sym.type () == STT_FUNC) || (sym.type () == STT_NOTYPE))
+        obj.weigh_text (weights);
+
+        for (files::sections::const_iterator fsi = obj.text.begin ();
+             fsi != obj.text.end ();
+             ++fsi)
         {
-          if ((sym.binding () == STB_GLOBAL) || (sym.binding () == STB_WEAK))
-          {
-            int         symsec = sym.section_index ();
+          const files::section&       fsec = *fsi;
+          osecweights::const_iterator owi = obj.text_weights.find (fsec.index);
+          placement                   tp (obj, fsec);
 
-            /* Ignore section index 0 */
-            if (symsec == 0)
-              continue;
-            /* Ignore sparc common section */
-            if ((elf::object_machine_type () == EM_SPARC) && (symsec == 65522))
-              continue;
+          if (owi != obj.text_weights.end ())
+          {
+            tp.weight = (*owi).second;
+            tp.group = tp.weight.weight ? 0 : 2;
+          }
 
-            sections    rap_sec = obj.find (symsec);
-            section&    sec = obj.secs[rap_sec];
-            std::size_t name;
+          order.push_back (tp);
+        }
+      }
 
-            /*
-             * See if the name is already in the string table.
-             */
-            name = find_in_strtab (sym.name ());
+      std::stable_sort (order.begin (),
+                        order.end (),
+                        text_placement_compare ());
 
-            if (name == std::string::npos)
-            {
-              name = strtab.size () + 1;
-              strtab += '\0';
-              strtab += sym.name ();
-            }
+      place (rap_text);
 
-            /*
-             * The symbol's value is the symbols value plus the offset of the
-             * object file's section offset in the RAP section.
-             */
-            externs.push_back (external (name,
-                                         rap_sec,
-                                         sec.offset + sec.osecs[symsec].offset +
-                                         sym.value (),
-                                         sym.info ()));
+      uint32_t hot = 0;
+      uint32_t cold = 0;
 
-            symtab_size += external::rap_size;
-          }
-        }
+      for (placements::const_iterator tpi = order.begin ();
+           tpi != order.end ();
+           ++tpi)
+      {
+        const placement& tp = *tpi;
+        if (tp.group == 0)
+          hot += tp.fsec->size;
+        else if (tp.group == 2)
+          cold += tp.fsec->size;
       }
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "rap:order-text: sections: " << order.size ()
+                  << " hot: " << hot
+                  << " cold: " << cold
+                  << " size: " << sec_size[rap_text] << std::endl;
     }
 
     void
-    image::write (compress::compressor& comp)
+    image::pack (sections sec)
     {
-      /*
-       * Start with the machine type so the target can check the applicatiion
-       * is ok and can be loaded. Add the init and fini labels to the string
-       * table and add the references to the string table next. Follow this
-       * with the section details then the string table and symbol table then
-       * finally the relocation records.
-       */
+      placements& order = sec_order[sec];
 
-      if (rld::verbose () >= RLD_VERBOSE_INFO)
-        std::cout << "rap:output: machine=" << comp.transferred () << std::endl;
+      order.clear ();
+
+      for (objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+      {
+        object&          obj = *oi;
+        files::sections& fsecs = obj.get_sections (sec);
+
+        for (files::sections::const_iterator fsi = fsecs.begin ();
+             fsi != fsecs.end ();
+             ++fsi)
+          order.push_back (placement (obj, *fsi));
+      }
+
+      std::stable_sort (order.begin (), order.end (), placement_align_compare);
+
+      place (sec);
+    }
+
+    void
+    image::place (sections sec)
+    {
+      const placements& order = sec_order[sec];
+      uint32_t          offset = 0;
+      uint32_t          align = 0;
+
+      for (objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+      {
+        section& osec = (*oi).secs[sec];
+        osec.offset = 0;
+        osec.relocs.clear ();
+      }
+
+      for (placements::const_iterator pi = order.begin ();
+           pi != order.end ();
+           ++pi)
+      {
+        const placement&      p = *pi;
+        const files::section& fsec = *p.fsec;
+        section&              osec = p.obj->secs[sec];
+
+        offset = align_offset (offset, 0, fsec.alignment);
+
+        osec.osecs[fsec.index].offset = offset;
+
+        for (files::relocations::const_iterator fri = fsec.relocs.begin ();
+             fri != fsec.relocs.end ();
+             ++fri)
+          osec.relocs.push_back (relocation (*fri, offset));
+
+        if (fsec.alignment > align)
+          align = fsec.alignment;
+
+        if (rld::verbose () >= RLD_VERBOSE_TRACE)
+          std::cout << "rap:place: " << section_names[sec]
+                    << ": " << offset
+                    << ' ' << fsec.name
+                    << " size=" << fsec.size
+                    << " align=" << fsec.alignment
+                    << " group=" << p.group
+                    << " weight=" << p.weight.weight
+                    << ' ' << p.obj->obj.name ().full () << std::endl;
+
+        offset += fsec.size;
+      }
+
+      for (objects::iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+      {
+        section& osec = (*oi).secs[sec];
+        std::stable_sort (osec.relocs.begin (),
+                          osec.relocs.end (),
+                          reloc_symindex_compare ());
+        std::stable_sort (osec.relocs.begin (),
+                          osec.relocs.end (),
+                          reloc_offset_compare ());
+      }
+
+      sec_size[sec] = offset;
+      if (!order.empty ())
+        sec_align[sec] = align;
+    }
+
+    void
+    image::collect_symbols (object& obj)
+    {
+      symbols::pointers& esyms = obj.obj.external_symbols ();
+      for (symbols::pointers::const_iterator ei = esyms.begin ();
+           ei != esyms.end ();
+           ++ei)
+      {
+        const symbols::symbol& sym = *(*ei);
+
+        if ((sym.type () == STT_OBJECT) || (sym.type () == STT_FUNC) || (sym.type () == STT_NOTYPE))
+        {
+          if ((sym.binding () == STB_GLOBAL) || (sym.binding () == STB_WEAK))
+          {
+            int         symsec = sym.section_index ();
+
+            /* Ignore section index 0 */
+            if (symsec == 0)
+              continue;
+            /* Ignore sparc common section */
+            if ((elf::object_machine_type () == EM_SPARC) && (symsec == 65522))
+              continue;
+
+            sections    rap_sec = obj.find (symsec);
+            section&    sec = obj.secs[rap_sec];
+            std::size_t name;
+
+            /*
+             * A front coded table is built once all the strings are known and
+             * the name is set then. See if the name is already in a plain
+             * string table.
+             */
+            if (front_code_strings)
+            {
+              strings[sym.name ()] = 0;
+              extern_names.push_back (sym.name ());
+              name = 0;
+            }
+            else
+            {
+              name = find_in_strtab (sym.name ());
+
+              if (name == std::string::npos)
+              {
+                name = strtab.size () + 1;
+                strtab += '\0';
+                strtab += sym.name ();
+              }
+            }
+
+            /*
+             * The symbol's value is the symbols value plus the offset of the
+             * object file's section offset in the RAP section.
+             */
+            externs.push_back (external (name,
+                                         rap_sec,
+                                         sec.offset + sec.osecs[symsec].offset +
+                                         sym.value (),
+                                         sym.info ()));
+
+            symtab_size += external::rap_size;
+          }
+        }
+      }
+    }
+
+    void
+    image::write (compress::compressor& comp, uint32_t base)
+    {
+      /*
+       * Start with the machine type so the target can check the applicatiion
+       * is ok and can be loaded. Add the init and fini labels to the string
+       * table and add the references to the string table next. Follow this
+       * with the section details then the string table and symbol table then
+       * finally the relocation records.
+       */
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "rap:output: machine=" << comp.transferred () << std::endl;
 
       comp << elf::object_machine_type ()
            << elf::object_datatype ()
@@ -1081,10 +1662,16 @@ namespace rld
       if (rld::verbose () >= RLD_VERBOSE_INFO)
         std::cout << "rap:output: header=" << comp.transferred () << std::endl;
 
+      /*
+       * A plain string table is terminated when written.
+       */
+      const uint32_t strtab_size =
+        strtab.size () + (front_code_strings ? 0 : 1);
+
       comp << init_off
            << fini_off
            << symtab_size
-           << (uint32_t) strtab.size () + 1
+           << strtab_size
            << (uint32_t) 0;
 
       /*
@@ -1106,10 +1693,46 @@ namespace rld
         comp << sec_size[s]
              << sec_align[s];
 
+      /*
+       * The XIP details are the alignment, the flags and the file offsets of
+       * the text and const sections. The offsets follow the details.
+       */
+      uint32_t text_off = 0;
+      uint32_t const_off = 0;
+
+      if (xip_alignment)
+      {
+        if ((sec_align[rap_text] > xip_alignment) ||
+            (sec_align[rap_const] > xip_alignment))
+          throw rld::error ("Section alignment greater than the XIP alignment",
+                            "rap::write");
+
+        const uint32_t xip_flags =
+          front_code_strings ? RAP_XIP_FRONT_CODED : 0;
+        const uint32_t xip_size = 4 * sizeof (uint32_t);
+
+        text_off = align_offset (base + comp.transferred (), xip_size,
+                                 xip_alignment);
+        const_off = align_offset (text_off, sec_size[rap_text],
+                                  xip_alignment);
+
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "rap:xip: align=" << xip_alignment
+                    << " text=" << text_off
+                    << " const=" << const_off << std::endl;
+
+        comp << xip_alignment
+             << xip_flags
+             << text_off
+             << const_off;
+      }
+
       /*
        * Output the sections from each object file.
        */
+      write_xip_padding (comp, base, text_off);
       write (comp, rap_text);
+      write_xip_padding (comp, base, const_off);
       write (comp, rap_const);
       write (comp, rap_ctor);
       write (comp, rap_dtor);
@@ -1118,7 +1741,8 @@ namespace rld
       if (rld::verbose () >= RLD_VERBOSE_INFO)
         std::cout << "rap:output: strtab=" << comp.transferred () << std::endl;
 
-      strtab += '\0';
+      if (!front_code_strings)
+        strtab += '\0';
       comp << strtab;
 
       if (rld::verbose () >= RLD_VERBOSE_INFO)
@@ -1201,8 +1825,31 @@ namespace rld
     {
       uint32_t image_offset = comp.transferred ();
 
-      std::for_each (objs.begin (), objs.end (),
-                     section_writer (*this, comp, sec));
+      if (!sec_order[sec].empty ())
+      {
+        uint32_t offset = 0;
+
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "rap:output: " << section_names[sec]
+                    << ": offset=" << comp.transferred ()
+                    << " size=" << section_size (sec)
+                    << " ordered" << std::endl;
+
+        for (placements::const_iterator pi = sec_order[sec].begin ();
+             pi != sec_order[sec].end ();
+             ++pi)
+        {
+          const placement& p = *pi;
+          files::sections  fsecs;
+          fsecs.push_back (*p.fsec);
+          write (comp, p.obj->obj, fsecs, offset);
+        }
+      }
+      else
+      {
+        std::for_each (objs.begin (), objs.end (),
+                       section_writer (*this, comp, sec));
+      }
 
       uint32_t written = comp.transferred () - image_offset;
 
@@ -1277,6 +1924,24 @@ namespace rld
       obj.close ();
     }
 
+    void
+    image::write_xip_padding (compress::compressor& comp,
+                              uint32_t              base,
+                              uint32_t              offset)
+    {
+      if (xip_alignment)
+      {
+        uint32_t at = base + comp.transferred ();
+
+        if (at > offset)
+          throw rld::error ("XIP section offset passed", "rap::write");
+
+        char zero = '\0';
+        for (; at < offset; ++at)
+          comp.write (&zero, 1);
+      }
+    }
+
     void
     image::write_externals (compress::compressor& comp)
     {
@@ -1289,7 +1954,10 @@ namespace rld
 
         if (rld::verbose () >= RLD_VERBOSE_TRACE)
           std::cout << "rap:externs: " << count
-                    << " name=" << &strtab[ext.name] << " (" << ext.name << ')'
+                    << " name="
+                    << (front_code_strings ?
+                        extern_names[count].c_str () : &strtab[ext.name])
+                    << " (" << ext.name << ')'
                     << " section=" << section_names[ext.sec]
                     << " data=" << ext.data
                     << " value=0x" << std::hex << ext.value << std::dec
@@ -1305,15 +1973,63 @@ namespace rld
       }
     }
 
+    /**
+     * Is the relocation resolved when an XIP image is installed? The symbol
+     * is local and in the text or const section so its address is known once
+     * the image is placed in flash and the relocation does not need writable
+     * memory.
+     */
+    static bool
+    xip_resolved (const object& obj, const relocation& reloc)
+    {
+      if ((reloc.symtype == STT_SECTION) || (reloc.symbinding == STB_LOCAL))
+      {
+        int rap_symsect = obj.find (reloc.symsect);
+        return (rap_symsect == rap_text) || (rap_symsect == rap_const);
+      }
+      return false;
+    }
+
     void
     image::write_relocations (compress::compressor& comp)
     {
       for (int s = 0; s < rap_secs; ++s)
       {
         uint32_t count = get_relocations (s);
-        uint32_t sr = 0;
+        uint32_t resolved = 0;
+        bool     xip = ((xip_alignment != 0) &&
+                        ((s == rap_text) || (s == rap_const)));
         uint32_t header;
 
+        /*
+         * An XIP section's relocations resolved at install time are written
+         * first followed by the relocations needing writable memory.
+         */
+        if (xip)
+        {
+          for (objects::const_iterator oi = objs.begin ();
+               oi != objs.end ();
+               ++oi)
+          {
+            const object&      obj = *oi;
+            const relocations& relocs = obj.secs[s].relocs;
+            for (relocations::const_iterator ri = relocs.begin ();
+                 ri != relocs.end ();
+                 ++ri)
+            {
+              if (xip_resolved (obj, *ri))
+                ++resolved;
+            }
+          }
+
+          if (rld::verbose () >= RLD_VERBOSE_INFO)
+            std::cout << "rap:xip: " << section_names[s]
+                      << ": relocs=" << count
+                      << " resolved=" << resolved
+                      << " writable=" << count - resolved
+                      << std::endl;
+        }
+
         if (rld::verbose () >= RLD_VERBOSE_TRACE)
           std::cout << "rap:relocation: section:" << section_names[s]
                     << " relocs=" << count
@@ -1325,124 +2041,136 @@ namespace rld
 
         comp << header;
 
-        for (objects::iterator oi = objs.begin ();
-             oi != objs.end ();
-             ++oi)
-        {
-          object&      obj = *oi;
-          section&     sec = obj.secs[s];
-          relocations& relocs = sec.relocs;
-          uint32_t     rc = 0;
+        if (xip_alignment)
+          comp << resolved;
 
-          if (rld::verbose () >= RLD_VERBOSE_TRACE)
-            std::cout << " relocs=" << sec.relocs.size ()
-                      << " sec.offset=" << sec.offset
-                      << " sec.size=" << sec.size ()
-                      << " sec.align=" << sec.alignment ()
-                      << "  " << obj.obj.name ().full ()  << std::endl;
-
-          for (relocations::const_iterator ri = relocs.begin ();
-               ri != relocs.end ();
-               ++ri, ++sr, ++rc)
+        for (int pass = xip ? 0 : 1; pass < 2; ++pass)
+        {
+          for (objects::iterator oi = objs.begin ();
+               oi != objs.end ();
+               ++oi)
           {
-            const relocation& reloc = *ri;
-            uint32_t          info = GELF_R_TYPE (reloc.info);
-            uint32_t          offset;
-            uint32_t          addend = reloc.addend;
-            bool              write_addend = sec.rela;
-            bool              write_symname = false;
-
-            offset = sec.offset + reloc.offset;
+            object&            obj = *oi;
+            const section&     sec = obj.secs[s];
+            const relocations& relocs = sec.relocs;
 
-            if ((reloc.symtype == STT_SECTION) || (reloc.symbinding == STB_LOCAL))
+            if (rld::verbose () >= RLD_VERBOSE_TRACE)
+              std::cout << " relocs=" << sec.relocs.size ()
+                        << " sec.offset=" << sec.offset
+                        << " sec.size=" << sec.size ()
+                        << " sec.align=" << sec.alignment ()
+                        << "  " << obj.obj.name ().full ()  << std::endl;
+
+            for (relocations::const_iterator ri = relocs.begin ();
+                 ri != relocs.end ();
+                 ++ri)
             {
-              int rap_symsect = obj.find (reloc.symsect);
-
-              /*
-               * Bit 31 clear, bits 30:8 RAP section index.
-               */
-              info |= rap_symsect << 8;
-
-              addend += (obj.secs[rap_symsect].offset +
-                         obj.secs[rap_symsect].osecs[reloc.symsect].offset +
-                         reloc.symvalue);
-
-              write_addend = true;
-
-              if (rld::verbose () >= RLD_VERBOSE_TRACE)
-                std::cout << "  " << std::setw (2) << sr
-                          << '/' << std::setw (2) << rc
-                          <<":  rsym: sect=" << section_names[rap_symsect]
-                          << " rap_symsect=" << rap_symsect
-                          << " sec.offset=" << obj.secs[rap_symsect].offset
-                          << " sec.osecs=" << obj.secs[rap_symsect].osecs[reloc.symsect].offset
-                          << " (" << obj.obj.get_section (reloc.symsect).name << ')'
-                          << " reloc.symsect=" << reloc.symsect
-                          << " reloc.symvalue=" << reloc.symvalue
-                          << " reloc.addend=" << reloc.addend
-                          << " addend=" << addend
-                          << std::endl;
+              const relocation& reloc = *ri;
+
+              if (!xip || (xip_resolved (obj, reloc) == (pass == 0)))
+                write_relocation (comp, obj, sec, reloc);
             }
-            else
-            {
-              /*
-               * Bit 31 must be set. Bit 30 determines the type of string and
-               * bits 29:8 the strtab offset or the size of the appended
-               * string.
-               */
+          }
+        }
+      }
+    }
 
-              info |= RAP_RELOC_STRING;
+    void
+    image::write_relocation (compress::compressor& comp,
+                             object&               obj,
+                             const section&        sec,
+                             const relocation&     reloc)
+    {
+      uint32_t info = GELF_R_TYPE (reloc.info);
+      uint32_t offset;
+      uint32_t addend = reloc.addend;
+      bool     write_addend = sec.rela;
+      bool     write_symname = false;
 
-              std::size_t size = find_in_strtab (reloc.symname);
+      offset = sec.offset + reloc.offset;
 
-              if (size == std::string::npos)
-              {
-                /*
-                 * Bit 30 clear, the size of the symbol name.
-                 */
-                info |= reloc.symname.size () << 8;
-                write_symname = true;
-              }
-              else
-              {
-                /*
-                 * Bit 30 set, the offset in the strtab.
-                 */
-                info |= RAP_RELOC_STRING_EMBED | (size << 8);
-              }
-            }
+      if ((reloc.symtype == STT_SECTION) || (reloc.symbinding == STB_LOCAL))
+      {
+        int rap_symsect = obj.find (reloc.symsect);
 
-            if (rld::verbose () >= RLD_VERBOSE_TRACE)
-            {
-              std::cout << "  " << std::setw (2) << sr << '/'
-                        << std::setw (2) << rc
-                        << std::hex << ": reloc: info=0x" << info << std::dec
-                        << " offset=" << offset;
-              if (write_addend)
-                std::cout << " addend=" << addend;
-              if ((info & RAP_RELOC_STRING) != 0)
-              {
-                std::cout << " symname=" << reloc.symname;
-                if (write_symname)
-                  std::cout << " (appended)";
-              }
-              std::cout << std::hex
-                        << " reloc.info=0x" << reloc.info << std::dec
-                        << " reloc.offset=" << reloc.offset
-                        << " reloc.symtype=" << reloc.symtype
-                        << std::endl;
-            }
+        /*
+         * Bit 31 clear, bits 30:8 RAP section index.
+         */
+        info |= rap_symsect << 8;
 
-            comp << info << offset;
+        addend += (obj.secs[rap_symsect].offset +
+                   obj.secs[rap_symsect].osecs[reloc.symsect].offset +
+                   reloc.symvalue);
 
-            if (write_addend)
-              comp << addend;
+        write_addend = true;
 
-            if (write_symname)
-              comp << reloc.symname;
-          }
+        if (rld::verbose () >= RLD_VERBOSE_TRACE)
+          std::cout << "  rsym: sect=" << section_names[rap_symsect]
+                    << " rap_symsect=" << rap_symsect
+                    << " sec.offset=" << obj.secs[rap_symsect].offset
+                    << " sec.osecs=" << obj.secs[rap_symsect].osecs[reloc.symsect].offset
+                    << " (" << obj.obj.get_section (reloc.symsect).name << ')'
+                    << " reloc.symsect=" << reloc.symsect
+                    << " reloc.symvalue=" << reloc.symvalue
+                    << " reloc.addend=" << reloc.addend
+                    << " addend=" << addend
+                    << std::endl;
+      }
+      else
+      {
+        /*
+         * Bit 31 must be set. Bit 30 determines the type of string and
+         * bits 29:8 the strtab offset or the size of the appended
+         * string.
+         */
+
+        info |= RAP_RELOC_STRING;
+
+        std::size_t size = find_in_strtab (obj, reloc.symindex);
+
+        if (size == std::string::npos)
+        {
+          /*
+           * Bit 30 clear, the size of the symbol name.
+           */
+          info |= obj.symbol_name (reloc.symindex).size () << 8;
+          write_symname = true;
         }
+        else
+        {
+          /*
+           * Bit 30 set, the offset in the strtab.
+           */
+          info |= RAP_RELOC_STRING_EMBED | (size << 8);
+        }
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_TRACE)
+      {
+        std::cout << std::hex << "  reloc: info=0x" << info << std::dec
+                  << " offset=" << offset;
+        if (write_addend)
+          std::cout << " addend=" << addend;
+        if ((info & RAP_RELOC_STRING) != 0)
+        {
+          std::cout << " symname=" << obj.symbol_name (reloc.symindex);
+          if (write_symname)
+            std::cout << " (appended)";
+        }
+        std::cout << std::hex
+                  << " reloc.info=0x" << reloc.info << std::dec
+                  << " reloc.offset=" << reloc.offset
+                  << " reloc.symtype=" << reloc.symtype
+                  << std::endl;
       }
+
+      comp << info << offset;
+
+      if (write_addend)
+        comp << addend;
+
+      if (write_symname)
+        comp << obj.symbol_name (reloc.symindex);
     }
 
     void image::write_details (compress::compressor& comp)
@@ -1588,12 +2316,15 @@ namespace rld
         sec_size[s] = 0;
         sec_align[s] = 0;
         sec_rela[s] = false;
+        sec_order[s].clear ();
       }
       symtab_size = 0;
       strtab.clear ();
       relocs_size = 0;
       init_off = 0;
       fini_off = 0;
+      strings.clear ();
+      extern_names.clear ();
     }
 
     uint32_t
@@ -1605,9 +2336,34 @@ namespace rld
       return sec_size[sec];
     }
 
+    std::size_t
+    image::find_in_strtab (object& obj, uint32_t symindex)
+    {
+      static const std::size_t unknown = std::string::npos - 1;
+
+      if (symindex >= obj.strtab_offsets.size ())
+        obj.strtab_offsets.resize (symindex + 1, unknown);
+
+      std::size_t& offset = obj.strtab_offsets[symindex];
+
+      if (offset == unknown)
+        offset = find_in_strtab (obj.symbol_name (symindex));
+
+      return offset;
+    }
+
     std::size_t
     image::find_in_strtab (const std::string& symname)
     {
+      if (front_code_strings)
+      {
+        std::map < std::string, uint32_t >::const_iterator si =
+          strings.find (symname);
+        if (si == strings.end ())
+          return std::string::npos;
+        return (*si).second;
+      }
+
       std::size_t pos = 0;
       while (pos < strtab.size ())
       {
@@ -1621,6 +2377,58 @@ namespace rld
       return std::string::npos;
     }
 
+    void
+    image::front_code_strtab (const std::string& init,
+                              const std::string& fini)
+    {
+      strings[init] = 0;
+      strings[fini] = 0;
+
+      /*
+       * The map is sorted so the index of a string is its position.
+       */
+      rld::strings sorted;
+      uint32_t     index = 0;
+
+      for (std::map < std::string, uint32_t >::iterator si = strings.begin ();
+           si != strings.end ();
+           ++si, ++index)
+      {
+        (*si).second = index;
+        sorted.push_back ((*si).first);
+      }
+
+      front_code (sorted, strtab);
+
+      init_off = strings[init];
+      fini_off = strings[fini];
+
+      externals                    coded;
+      rld::strings::const_iterator ni = extern_names.begin ();
+
+      for (externals::const_iterator ei = externs.begin ();
+           ei != externs.end ();
+           ++ei, ++ni)
+      {
+        const external& ext = *ei;
+        coded.push_back (external (strings[*ni], ext.sec, ext.value, ext.data));
+      }
+
+      externs.swap (coded);
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+      {
+        size_t plain = 1;
+        for (rld::strings::const_iterator si = sorted.begin ();
+             si != sorted.end ();
+             ++si)
+          plain += (*si).size () + 1;
+        std::cout << "rap:strings: front coded: " << sorted.size ()
+                  << " size: " << strtab.size ()
+                  << " plain: " << plain << std::endl;
+      }
+    }
+
     void
     write (files::image&             app,
            const std::string&        init,
@@ -1631,14 +2439,29 @@ namespace rld
     {
       std::string header;
 
-      header = "RAP,00000000,0002,LZ77,00000000\n";
+      /*
+       * An XIP image is not compressed so the sections can be used where the
+       * image is held.
+       */
+      header = "RAP,00000000,000";
+      if (xip_alignment)
+        header += rld::to_string (RAP_VERSION_XIP);
+      else
+        header += rld::to_string (front_code_strings ?
+                                  RAP_VERSION_FRONT_CODED : RAP_VERSION);
+      if (xip_alignment)
+        header += ",NONE";
+      else
+        header += checksum ? ",LZ7C" : ",LZ77";
+      header += ",00000000\n";
       app.write (header.c_str (), header.size ());
 
-      compress::compressor compressor (app, 2 * 1024);
+      compress::compressor compressor (app, 2 * 1024, true,
+                                       xip_alignment == 0, checksum);
       image                rap;
 
       rap.layout (app_objects, init, fini);
-      rap.write (compressor);
+      rap.write (compressor, header.size ());
 
       compressor.flush ();
 
@@ -1649,6 +2472,16 @@ namespace rld
 
       header.replace (4, 8, length.str ());
 
+      if (checksum)
+      {
+        std::ostringstream crc;
+
+        crc << std::hex << std::setfill ('0') << std::setw (8)
+            << compressor.crc ();
+
+        header.replace (header.size () - 9, 8, crc.str ());
+      }
+
       app.seek (0);
       app.write (header.c_str (), header.size ());
 
@@ -1661,8 +2494,432 @@ namespace rld
                   << ", size: " << compressor.compressed ()
                   << ", compression: " << pcent << '.' << premand << '%'
                   << std::endl;
+        if (checksum)
+          std::cout << "rap: checksum: crc32c="
+                    << header.substr (header.size () - 9, 8)
+                    << " (" << crc::crc32c_method () << ')' << std::endl;
+      }
+    }
+
+    /**
+     * Read a 32bit value from a RAP table in the RAP byte order.
+     */
+    static uint32_t
+    get_uint32 (const uint8_t* data)
+    {
+      return (((uint32_t) data[0]) << 24) | (((uint32_t) data[1]) << 16) |
+        (((uint32_t) data[2]) << 8) | data[3];
+    }
+
+    /**
+     * Append a 32bit value to a RAP table in the RAP byte order.
+     */
+    static void
+    put_uint32 (std::string& table, uint32_t value)
+    {
+      table += (char) (value >> 24);
+      table += (char) (value >> 16);
+      table += (char) (value >> 8);
+      table += (char) value;
+    }
+
+    void
+    front_code (const rld::strings& strings, std::string& table)
+    {
+      const uint32_t blocks =
+        (strings.size () + RAP_STRINGS_BLOCK - 1) / RAP_STRINGS_BLOCK;
+
+      std::string data;
+
+      table.clear ();
+
+      put_uint32 (table, strings.size ());
+      put_uint32 (table, RAP_STRINGS_BLOCK);
+
+      for (size_t s = 0; s < strings.size (); ++s)
+      {
+        const std::string& str = strings[s];
+        size_t             prefix = 0;
+
+        if ((s % RAP_STRINGS_BLOCK) == 0)
+        {
+          put_uint32 (table, (2 + blocks) * sizeof (uint32_t) + data.size ());
+        }
+        else
+        {
+          const std::string& last = strings[s - 1];
+          if (str <= last)
+            throw rld::error ("Strings not sorted or not unique: " + str,
+                              "rap:front-code");
+          while ((prefix < str.size ()) && (prefix < last.size ()) &&
+                 (str[prefix] == last[prefix]))
+            ++prefix;
+          size_t length = prefix;
+          do
+          {
+            uint8_t byte = length & 0x7f;
+            length >>= 7;
+            if (length != 0)
+              byte |= 0x80;
+            data += (char) byte;
+          } while (length != 0);
+        }
+
+        data.append (str, prefix, std::string::npos);
+        data += '\0';
+      }
+
+      table += data;
+    }
+
+    string_table::string_table ()
+      : front_coded (false),
+        plain_size (0)
+    {
+    }
+
+    void
+    string_table::load (const uint8_t* data, uint32_t size, bool front_coded_)
+    {
+      front_coded = front_coded_;
+      strings.clear ();
+      offsets.clear ();
+      plain_size = 0;
+
+      if (!front_coded)
+      {
+        strings.assign (data, data + size);
+        strings.push_back ('\0');
+        plain_size = size;
+        for (uint32_t offset = 0; offset < size; )
+        {
+          offsets.push_back (offset);
+          offset += ::strlen (&strings[offset]) + 1;
+        }
+        return;
+      }
+
+      if (size < (2 * sizeof (uint32_t)))
+        throw rld::error ("Front coded table too small", "rap:strings");
+
+      const uint32_t count = get_uint32 (data);
+      const uint32_t block = get_uint32 (data + sizeof (uint32_t));
+
+      if (count == 0)
+        return;
+
+      if (block == 0)
+        throw rld::error ("Invalid front coded block size", "rap:strings");
+
+      const uint32_t blocks = ((count - 1) / block) + 1;
+
+      if (((2 + blocks) * sizeof (uint32_t)) > size)
+        throw rld::error ("Front coded table too small", "rap:strings");
+
+      std::string last;
+
+      offsets.reserve (count);
+
+      for (uint32_t b = 0; b < blocks; ++b)
+      {
+        uint32_t pos = get_uint32 (data + ((2 + b) * sizeof (uint32_t)));
+
+        for (uint32_t s = b * block; (s < count) && (s < ((b + 1) * block)); ++s)
+        {
+          size_t prefix = 0;
+
+          if (s != (b * block))
+          {
+            int shift = 0;
+            while (true)
+            {
+              if ((pos >= size) || (shift > 28))
+                throw rld::error ("Invalid front coded prefix", "rap:strings");
+              uint8_t byte = data[pos++];
+              prefix |= (size_t) (byte & 0x7f) << shift;
+              shift += 7;
+              if ((byte & 0x80) == 0)
+                break;
+            }
+            if (prefix > last.size ())
+              throw rld::error ("Invalid front coded prefix", "rap:strings");
+          }
+
+          const uint8_t* suffix = data + pos;
+          const uint8_t* end = (const uint8_t*) ::memchr (suffix, '\0', size - pos);
+
+          if (!end)
+            throw rld::error ("Front coded string not terminated", "rap:strings");
+
+          last.erase (prefix);
+          last.append ((const char*) suffix, end - suffix);
+          pos += (end - suffix) + 1;
+
+          offsets.push_back (strings.size ());
+          strings.insert (strings.end (), last.begin (), last.end ());
+          strings.push_back ('\0');
+        }
       }
     }
 
+    const char*
+    string_table::get (uint32_t ref) const
+    {
+      if (front_coded)
+        return ref < offsets.size () ? &strings[offsets[ref]] : 0;
+      return ref < plain_size ? &strings[ref] : 0;
+    }
+
+    size_t
+    string_table::size () const
+    {
+      return offsets.size ();
+    }
+
+    const char*
+    string_table::string (size_t index) const
+    {
+      return &strings[offsets[index]];
+    }
+
+    uint32_t
+    string_table::reference (size_t index) const
+    {
+      return front_coded ? index : offsets[index];
+    }
+
+    void
+    load_externals (const std::string& name, rld::strings& externals)
+    {
+      files::image rap (name);
+
+      rap.open ();
+
+      try
+      {
+        char rhdr[64];
+
+        ::memset (rhdr, 0, sizeof (rhdr));
+        rap.seek_read (0, (uint8_t*) rhdr,
+                       std::min ((size_t) rap.size (), sizeof (rhdr) - 1));
+
+        if (::strncmp (rhdr, "RAP,", 4) != 0)
+          throw rld::error ("Invalid RAP file", "rap:externals: " + name);
+
+        char* eol = ::strchr (rhdr, '\n');
+        if (!eol)
+          throw rld::error ("Cannot parse RAP header", "rap:externals: " + name);
+
+        bool     checksummed = ::strstr (rhdr, ",LZ7C,") != 0;
+        bool     compressed = checksummed || (::strstr (rhdr, ",LZ77,") != 0);
+        uint32_t rap_version = 0;
+
+        const char* version = ::strchr (rhdr + 4, ',');
+        if (version)
+          rap_version = ::strtoul (version + 1, 0, 10);
+
+        bool front_coded = rap_version == RAP_VERSION_FRONT_CODED;
+        bool xip = rap_version == RAP_VERSION_XIP;
+
+        const uint32_t rhdr_len = eol - rhdr + 1;
+
+        rap.seek (rhdr_len);
+
+        compress::compressor comp (rap, 2 * 1024, false,
+                                   compressed, checksummed);
+
+        uint32_t machinetype;
+        uint32_t datatype;
+        uint32_t class_;
+        uint32_t init_off;
+        uint32_t fini_off;
+        uint32_t symtab_size;
+        uint32_t strtab_size;
+        uint32_t relocs_size;
+        uint32_t obj_num;
+
+        comp >> machinetype
+             >> datatype
+             >> class_
+             >> init_off
+             >> fini_off
+             >> symtab_size
+             >> strtab_size
+             >> relocs_size
+             >> obj_num;
+
+        std::vector < uint8_t > skip;
+
+        /*
+         * Skip the object file details.
+         */
+        if (obj_num > 0)
+        {
+          uint32_t rpathlen;
+          uint32_t sec_num = 0;
+          uint32_t size;
+
+          comp >> rpathlen;
+
+          for (uint32_t o = 0; o < obj_num; ++o)
+          {
+            comp >> size;
+            sec_num += size;
+          }
+
+          comp >> size;
+
+          skip.resize (size + (sec_num * 3 * sizeof (uint32_t)));
+          if (!skip.empty () &&
+              (comp.read (&skip[0], skip.size ()) != skip.size ()))
+            throw rld::error ("Reading details failed", "rap:externals: " + name);
+        }
+
+        uint32_t sizes[rap_secs];
+        uint32_t data_size = 0;
+
+        for (int s = 0; s < rap_secs; ++s)
+        {
+          uint32_t alignment;
+          comp >> sizes[s] >> alignment;
+          if (s != rap_bss)
+            data_size += sizes[s];
+        }
+
+        /*
+         * The XIP details and the padding before the text and const sections.
+         */
+        if (xip)
+        {
+          uint32_t xip_align;
+          uint32_t xip_flags;
+          uint32_t text_off;
+          uint32_t const_off;
+
+          comp >> xip_align
+               >> xip_flags
+               >> text_off
+               >> const_off;
+
+          front_coded = (xip_flags & RAP_XIP_FRONT_CODED) != 0;
+
+          uint32_t at = rhdr_len + comp.offset ();
+
+          if ((text_off < at) || (const_off < (text_off + sizes[rap_text])))
+            throw rld::error ("Invalid XIP section offsets",
+                              "rap:externals: " + name);
+
+          data_size += (text_off - at) +
+            (const_off - (text_off + sizes[rap_text]));
+        }
+
+        /*
+         * Skip the section data.
+         */
+        skip.resize (data_size);
+        if (!skip.empty () &&
+            (comp.read (&skip[0], skip.size ()) != skip.size ()))
+          throw rld::error ("Reading section data failed",
+                            "rap:externals: " + name);
+
+        std::vector < uint8_t > strtab (strtab_size + 1, 0);
+        string_table            strings;
+        std::vector < uint8_t > symtab (symtab_size);
+
+        if ((strtab_size != 0) &&
+            (comp.read (&strtab[0], strtab_size) != strtab_size))
+          throw rld::error ("Reading string table failed",
+                            "rap:externals: " + name);
+
+        if ((symtab_size != 0) &&
+            (comp.read (&symtab[0], symtab_size) != symtab_size))
+          throw rld::error ("Reading symbol table failed",
+                            "rap:externals: " + name);
+
+        strings.load (&strtab[0], strtab_size, front_coded);
+
+        /*
+         * The symbols defined in the RAP file.
+         */
+        std::set < std::string > defined;
+
+        for (uint32_t sym = 0;
+             (sym + 3 * sizeof (uint32_t)) <= symtab_size;
+             sym += 3 * sizeof (uint32_t))
+        {
+          const char* str =
+            strings.get (get_uint32 (&symtab[sym + sizeof (uint32_t)]));
+          if (str)
+            defined.insert (str);
+        }
+
+        std::set < std::string > found;
+
+        for (int s = 0; s < rap_secs; ++s)
+        {
+          uint32_t header;
+
+          comp >> header;
+
+          bool     rela = (header & RAP_RELOC_RELA) != 0;
+          uint32_t count = header & ~RAP_RELOC_RELA;
+
+          if (xip)
+          {
+            uint32_t resolved;
+            comp >> resolved;
+          }
+
+          for (uint32_t r = 0; r < count; ++r)
+          {
+            uint32_t info;
+            uint32_t offset;
+            uint32_t addend;
+
+            comp >> info >> offset;
+
+            if (((info & RAP_RELOC_STRING) == 0) || rela)
+              comp >> addend;
+
+            if ((info & RAP_RELOC_STRING) != 0)
+            {
+              std::string symname;
+              uint32_t    value = (info & ~(3UL << 30)) >> 8;
+
+              if ((info & RAP_RELOC_STRING_EMBED) == 0)
+              {
+                symname.resize (value);
+                if (comp.read ((void*) symname.c_str (), value) != value)
+                  throw rld::error ("Reading reloc symbol name failed",
+                                    "rap:externals: " + name);
+              }
+              else if (strings.get (value))
+              {
+                symname = strings.get (value);
+              }
+
+              if (!symname.empty () &&
+                  (defined.find (symname) == defined.end ()) &&
+                  (found.find (symname) == found.end ()))
+              {
+                found.insert (symname);
+                externals.push_back (symname);
+              }
+            }
+          }
+        }
+
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "rap:externals: " << name
+                    << ": " << found.size () << std::endl;
+      }
+      catch (...)
+      {
+        rap.close ();
+        throw;
+      }
+
+      rap.close ();
+    }
   }
 }
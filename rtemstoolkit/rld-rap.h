@@ -25,6 +25,8 @@
 #if !defined (_RLD_RAP_H_)
 #define _RLD_RAP_H_
 
+#include <vector>
+
 #include <rld-files.h>
 
 namespace rld
@@ -41,6 +43,77 @@ namespace rld
       */
      extern std::string rpath;
 
+    /**
+     * Pack the object file sections in each RAP section across the object
+     * files by alignment to reduce the padding. The constructor and
+     * destructor tables are not packed.
+     */
+     extern bool pack_sections;
+
+    /**
+     * The function order file used to order the text sections. Each line
+     * is a function name and an optional weight, the default weight is 1
+     * and text after a '#' is a comment. The text sections holding the
+     * functions with a weight are placed first with the highest weight
+     * first, the sections with functions that are not listed follow in link
+     * order and the sections with functions listed with a weight of 0, the
+     * cold functions, are placed last. The sections are ordered across the
+     * object files so hot functions compiled with -ffunction-sections are
+     * contiguous.
+     */
+    extern std::string function_order;
+
+    /**
+     * Front code the string table. The strings are sorted and each string
+     * after the first string of a block only holds the characters it does not
+     * share with the string before it. Strings are referenced by their index
+     * in the sorted table rather than their offset in the table. The RAP
+     * version is RAP_VERSION_FRONT_CODED.
+     */
+    extern bool front_code_strings;
+
+    /**
+     * The execute in place (XIP) alignment, 0 is off. An XIP image is not
+     * compressed so the text and const sections can be executed and read
+     * where the image is held in memory mapped flash. The sections start at
+     * file offsets aligned to the XIP alignment, for example the flash sector
+     * or MMU page size. The relocation records of the text and const sections
+     * are split so the records resolved when the image is installed in flash
+     * are held before the records that need writable memory. The RAP version
+     * is RAP_VERSION_XIP.
+     */
+    extern uint32_t xip_alignment;
+
+    /**
+     * Checksum the image. The header checksum is the CRC32C of the data after
+     * the header. The compression is LZ7C, LZ77 with each compressed block
+     * followed by the CRC32C of the block so a block can be checked before it
+     * is decompressed. An XIP image is not compressed and only has the header
+     * checksum.
+     */
+    extern bool checksum;
+
+    /**
+     * The RAP versions. The front coded string table is not understood by
+     * loaders of the plain version and the XIP layout is not understood by
+     * loaders of the other versions.
+     */
+    #define RAP_VERSION             2
+    #define RAP_VERSION_FRONT_CODED 3
+    #define RAP_VERSION_XIP         4
+
+    /**
+     * The XIP flags. The XIP version holds the string table format as a flag.
+     */
+    #define RAP_XIP_FRONT_CODED (1UL << 0)
+
+    /**
+     * The number of strings in a front coded block. The first string of a
+     * block is held in full so a string can be found by decoding no more than
+     * a block.
+     */
+    #define RAP_STRINGS_BLOCK 16
+
     /**
      * The RAP relocation bit masks.
      */
@@ -91,6 +164,81 @@ namespace rld
                 const std::string&        fini,
                 const files::object_list& objects,
                 const symbols::table&     symbols);
+
+    /**
+     * Load the names of the external symbols a RAP file references. These are
+     * the symbols referenced by name in the relocation records that are not
+     * in the RAP file's symbol table and are resolved by the run-time loader
+     * from the global symbol table.
+     *
+     * @param name The path of the RAP file.
+     * @param externals The external symbol names are added to the container.
+     */
+    void load_externals (const std::string& name, rld::strings& externals);
+
+    /**
+     * Front code the strings into a RAP string table. The table is the number
+     * of strings, the number of strings in a block and the offset of each
+     * block from the start of the table as 32bit values in the RAP byte order
+     * followed by the blocks. The first string of a block is NUL terminated
+     * and each string after it is the length of the prefix it shares with the
+     * string before it as an unsigned LEB128 value followed by the rest of the
+     * string NUL terminated.
+     *
+     * @param strings The strings, sorted with no duplicates.
+     * @param table The front coded table.
+     */
+    void front_code (const rld::strings& strings, std::string& table);
+
+    /**
+     * A RAP string table. The table is loaded from the plain or the front
+     * coded form and held as NUL terminated strings.
+     */
+    class string_table
+    {
+    public:
+      /**
+       * Construct an empty string table.
+       */
+      string_table ();
+
+      /**
+       * Load the string table.
+       *
+       * @param data The string table in the RAP file.
+       * @param size The size of the string table.
+       * @param front_coded The table is front coded.
+       */
+      void load (const uint8_t* data, uint32_t size, bool front_coded);
+
+      /**
+       * Get the string a RAP reference refers to. The reference is an offset
+       * in a plain table and an index in a front coded table. Returns 0 if the
+       * reference is not valid.
+       */
+      const char* get (uint32_t ref) const;
+
+      /**
+       * The number of strings in the table.
+       */
+      size_t size () const;
+
+      /**
+       * The string at the index in the table.
+       */
+      const char* string (size_t index) const;
+
+      /**
+       * The reference of the string at the index in the table.
+       */
+      uint32_t reference (size_t index) const;
+
+    private:
+      bool                    front_coded; //< The table is front coded.
+      std::vector < char >    strings;     //< The NUL terminated strings.
+      std::vector < uint32_t > offsets;    //< The offset of each string.
+      uint32_t                plain_size;  //< The size of a plain table.
+    };
   }
 }
 
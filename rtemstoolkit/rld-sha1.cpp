@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker SHA-1 hash.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <rld-sha1.h>
+
+namespace rld
+{
+  namespace sha1
+  {
+    static inline uint32_t
+    rotate (uint32_t value, int bits)
+    {
+      return (value << bits) | (value >> (32 - bits));
+    }
+
+    hash::hash ()
+      : length (0),
+        used (0)
+    {
+      state[0] = 0x67452301;
+      state[1] = 0xefcdab89;
+      state[2] = 0x98badcfe;
+      state[3] = 0x10325476;
+      state[4] = 0xc3d2e1f0;
+    }
+
+    void
+    hash::block (const uint8_t* data)
+    {
+      uint32_t w[80];
+
+      for (int i = 0; i < 16; ++i)
+        w[i] = ((uint32_t) data[i * 4] << 24) |
+               ((uint32_t) data[i * 4 + 1] << 16) |
+               ((uint32_t) data[i * 4 + 2] << 8) |
+               (uint32_t) data[i * 4 + 3];
+
+      for (int i = 16; i < 80; ++i)
+        w[i] = rotate (w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+      uint32_t a = state[0];
+      uint32_t b = state[1];
+      uint32_t c = state[2];
+      uint32_t d = state[3];
+      uint32_t e = state[4];
+
+      for (int i = 0; i < 80; ++i)
+      {
+        uint32_t f;
+        uint32_t k;
+
+        if (i < 20)
+        {
+          f = (b & c) | (~b & d);
+          k = 0x5a827999;
+        }
+        else if (i < 40)
+        {
+          f = b ^ c ^ d;
+          k = 0x6ed9eba1;
+        }
+        else if (i < 60)
+        {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8f1bbcdc;
+        }
+        else
+        {
+          f = b ^ c ^ d;
+          k = 0xca62c1d6;
+        }
+
+        uint32_t t = rotate (a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = rotate (b, 30);
+        b = a;
+        a = t;
+      }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+    }
+
+    void
+    hash::update (const void* data, size_t length_)
+    {
+      const uint8_t* in = static_cast < const uint8_t* > (data);
+
+      length += length_;
+
+      if (used)
+      {
+        size_t filling = sizeof (pending) - used;
+        if (filling > length_)
+          filling = length_;
+        ::memcpy (&pending[used], in, filling);
+        used += filling;
+        in += filling;
+        length_ -= filling;
+        if (used < sizeof (pending))
+          return;
+        block (pending);
+        used = 0;
+      }
+
+      while (length_ >= sizeof (pending))
+      {
+        block (in);
+        in += sizeof (pending);
+        length_ -= sizeof (pending);
+      }
+
+      if (length_)
+      {
+        ::memcpy (pending, in, length_);
+        used = length_;
+      }
+    }
+
+    void
+    hash::final (uint8_t digest[digest_size])
+    {
+      const uint64_t bits = length * 8;
+
+      /*
+       * Pad with a one bit and zeros to 56 bytes of a block then append the
+       * length in bits.
+       */
+      pending[used++] = 0x80;
+      if (used > 56)
+      {
+        ::memset (&pending[used], 0, sizeof (pending) - used);
+        block (pending);
+        used = 0;
+      }
+      ::memset (&pending[used], 0, 56 - used);
+      for (int b = 0; b < 8; ++b)
+        pending[56 + b] = (uint8_t) (bits >> ((7 - b) * 8));
+      block (pending);
+      used = 0;
+
+      for (int s = 0; s < 5; ++s)
+      {
+        digest[s * 4] = (uint8_t) (state[s] >> 24);
+        digest[s * 4 + 1] = (uint8_t) (state[s] >> 16);
+        digest[s * 4 + 2] = (uint8_t) (state[s] >> 8);
+        digest[s * 4 + 3] = (uint8_t) state[s];
+      }
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker SHA-1 hash.
+ *
+ * The SHA-1 hash is the GNU build-id the GNU linker generates by default. It
+ * identifies an object and its separate debug object.
+ */
+
+#if !defined (_RLD_SHA1_H_)
+#define _RLD_SHA1_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace rld
+{
+  namespace sha1
+  {
+    /**
+     * The size of a SHA-1 digest in bytes.
+     */
+    const size_t digest_size = 20;
+
+    /**
+     * A SHA-1 hash of data that can be added in parts.
+     */
+    class hash
+    {
+    public:
+      /**
+       * Construct the hash of no data.
+       */
+      hash ();
+
+      /**
+       * Add the data to the hash.
+       *
+       * @param data The data to add.
+       * @param length The length of the data in bytes.
+       */
+      void update (const void* data, size_t length);
+
+      /**
+       * Finish the hash and return the digest. No data can be added once the
+       * hash is finished.
+       *
+       * @param digest The digest of the data.
+       */
+      void final (uint8_t digest[digest_size]);
+
+    private:
+      /**
+       * Hash a 64 byte block.
+       */
+      void block (const uint8_t* data);
+
+      uint32_t state[5];    //< The hash state.
+      uint64_t length;      //< The length of the data in bytes.
+      uint8_t  pending[64]; //< The data waiting for a full block.
+      size_t   used;        //< The bytes in the pending block.
+    };
+  }
+}
+
+#endif
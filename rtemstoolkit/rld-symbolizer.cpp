@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker address symbolizer.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <iomanip>
+
+#include <string.h>
+
+#include <rld.h>
+#include <rld-symbolizer.h>
+
+namespace rld
+{
+  namespace symbolizer
+  {
+    /**
+     * The preference of a symbol's binding when symbols have the same address
+     * and size. Lower is preferred.
+     */
+    static int
+    bind_order (uint8_t bind)
+    {
+      switch (bind)
+      {
+        case STB_GLOBAL:
+          return 0;
+        case STB_WEAK:
+          return 1;
+        default:
+          break;
+      }
+      return 2;
+    }
+
+    /**
+     * Order the symbols by address, the largest first so an enclosing symbol
+     * is before the symbols it contains, then functions before objects and
+     * then by binding.
+     */
+    class symbol_order
+    {
+    public:
+      symbol_order (const std::vector < symbol >& syms)
+        : syms (syms) {
+      }
+
+      bool operator () (uint32_t l, uint32_t r) const {
+        const symbol& ls = syms[l];
+        const symbol& rs = syms[r];
+        if (ls.value != rs.value)
+          return ls.value < rs.value;
+        if (ls.size != rs.size)
+          return ls.size > rs.size;
+        if (ls.type != rs.type)
+          return ls.type == STT_FUNC;
+        return bind_order (ls.bind) < bind_order (rs.bind);
+      }
+
+    private:
+      const std::vector < symbol >& syms;
+    };
+
+    /**
+     * A symbol being flattened into ranges.
+     */
+    struct open_symbol
+    {
+      address  end;
+      uint32_t sym;
+
+      open_symbol (address end, uint32_t sym)
+        : end (end),
+          sym (sym) {
+      }
+    };
+
+    location::location ()
+      : name (0),
+        value (0),
+        offset (0)
+    {
+    }
+
+    symbolizer::symbolizer ()
+      : last (0)
+    {
+    }
+
+    void
+    symbolizer::load (elf::file& file)
+    {
+      elf::sections symbol_secs;
+
+      file.get_sections (symbol_secs, SHT_SYMTAB);
+
+      /*
+       * ARM Thumb function addresses have bit 0 set.
+       */
+      const address mask =
+        file.machinetype () == EM_ARM ? ~((address) 1) : ~((address) 0);
+
+      size_t loaded = 0;
+
+      for (elf::sections::iterator si = symbol_secs.begin ();
+           si != symbol_secs.end ();
+           ++si)
+      {
+        elf::section& sec = *(*si);
+        int           syms = sec.entries ();
+
+        for (int s = 0; s < syms; ++s)
+        {
+          elf::elf_sym esym;
+
+          if (!::gelf_getsym (sec.data (), s, &esym))
+            throw rld::error (::elf_errmsg (-1),
+                              "symbolizer:gelf_getsym: " + file.name ());
+
+          int stype = GELF_ST_TYPE (esym.st_info);
+
+          if (((stype != STT_FUNC) && (stype != STT_OBJECT)) ||
+              (esym.st_shndx == SHN_UNDEF) ||
+              (esym.st_shndx == SHN_COMMON) ||
+              (esym.st_name == 0))
+            continue;
+
+          const char* name = ::elf_strptr (file.get_elf (),
+                                           sec.link (),
+                                           esym.st_name);
+          if (!name || (*name == '\0'))
+            continue;
+
+          symbol sym;
+
+          sym.value = esym.st_value;
+          if (stype == STT_FUNC)
+            sym.value &= mask;
+          sym.size = esym.st_size;
+          sym.name = names.size ();
+          sym.shndx = esym.st_shndx;
+          sym.type = stype;
+          sym.bind = GELF_ST_BIND (esym.st_info);
+
+          names.insert (names.end (), name, name + ::strlen (name) + 1);
+          symbols.push_back (sym);
+
+          ++loaded;
+        }
+      }
+
+      build ();
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "symbolizer: " << file.name ()
+                  << ": symbols: " << loaded
+                  << " ranges: " << ranges.size ()
+                  << std::endl;
+    }
+
+    void
+    symbolizer::build ()
+    {
+      std::vector < uint32_t > order (symbols.size ());
+
+      for (uint32_t s = 0; s < order.size (); ++s)
+        order[s] = s;
+
+      std::sort (order.begin (), order.end (), symbol_order (symbols));
+
+      ranges.clear ();
+      last = 0;
+
+      std::vector < open_symbol > open;
+      address                     cursor = 0;
+
+      for (size_t o = 0; o < order.size (); ++o)
+      {
+        const symbol& sym = symbols[order[o]];
+
+        /*
+         * Aliases have the same address and size as the symbol before them.
+         */
+        if (o > 0)
+        {
+          const symbol& prev = symbols[order[o - 1]];
+          if ((prev.value == sym.value) && (prev.size == sym.size))
+            continue;
+        }
+
+        address end = sym.value + sym.size;
+
+        /*
+         * A symbol with no size extends to the next symbol at a higher address
+         * in the same section.
+         */
+        if (sym.size == 0)
+        {
+          end = sym.value + 1;
+          for (size_t n = o + 1; n < order.size (); ++n)
+          {
+            const symbol& next = symbols[order[n]];
+            if (next.value > sym.value)
+            {
+              if (next.shndx == sym.shndx)
+                end = next.value;
+              break;
+            }
+          }
+        }
+
+        /*
+         * Close the open symbols that end before this symbol starts.
+         */
+        while (!open.empty () && (open.back ().end <= sym.value))
+        {
+          if (cursor < open.back ().end)
+          {
+            range r = { cursor, open.back ().end, open.back ().sym };
+            ranges.push_back (r);
+            cursor = open.back ().end;
+          }
+          open.pop_back ();
+        }
+
+        if (!open.empty () && (cursor < sym.value))
+        {
+          range r = { cursor, sym.value, open.back ().sym };
+          ranges.push_back (r);
+        }
+
+        cursor = sym.value;
+        open.push_back (open_symbol (end, order[o]));
+      }
+
+      while (!open.empty ())
+      {
+        if (cursor < open.back ().end)
+        {
+          range r = { cursor, open.back ().end, open.back ().sym };
+          ranges.push_back (r);
+          cursor = open.back ().end;
+        }
+        open.pop_back ();
+      }
+    }
+
+    void
+    symbolizer::set (const range& r, address addr, location& loc) const
+    {
+      const symbol& sym = symbols[r.sym];
+      loc.name = &names[sym.name];
+      loc.value = sym.value;
+      loc.offset = addr - sym.value;
+    }
+
+    bool
+    symbolizer::lookup (address addr, location& loc) const
+    {
+      if (ranges.empty ())
+      {
+        loc = location ();
+        return false;
+      }
+
+      /*
+       * Check the last range found and the one after it.
+       */
+      if (last < ranges.size ())
+      {
+        const range& r = ranges[last];
+        if ((addr >= r.start) && (addr < r.end))
+        {
+          set (r, addr, loc);
+          return true;
+        }
+        if ((addr >= r.end) && ((last + 1) < ranges.size ()))
+        {
+          const range& n = ranges[last + 1];
+          if ((addr >= n.start) && (addr < n.end))
+          {
+            ++last;
+            set (n, addr, loc);
+            return true;
+          }
+        }
+      }
+
+      /*
+       * Find the first range that starts after the address, the range before
+       * it could hold the address.
+       */
+      size_t low = 0;
+      size_t high = ranges.size ();
+
+      while (low < high)
+      {
+        size_t mid = low + ((high - low) / 2);
+        if (ranges[mid].start <= addr)
+          low = mid + 1;
+        else
+          high = mid;
+      }
+
+      if ((low > 0) && (addr < ranges[low - 1].end))
+      {
+        last = low - 1;
+        set (ranges[last], addr, loc);
+        return true;
+      }
+
+      loc = location ();
+      return false;
+    }
+
+    size_t
+    symbolizer::lookup (const addresses& addrs, locations& locs) const
+    {
+      size_t found = 0;
+
+      locs.resize (addrs.size ());
+
+      bool sorted = true;
+      for (size_t a = 1; sorted && (a < addrs.size ()); ++a)
+        if (addrs[a] < addrs[a - 1])
+          sorted = false;
+
+      if (!sorted)
+      {
+        for (size_t a = 0; a < addrs.size (); ++a)
+          if (lookup (addrs[a], locs[a]))
+            ++found;
+        return found;
+      }
+
+      /*
+       * Merge the sorted addresses with the sorted ranges.
+       */
+      size_t r = 0;
+
+      for (size_t a = 0; a < addrs.size (); ++a)
+      {
+        while ((r < ranges.size ()) && (ranges[r].end <= addrs[a]))
+          ++r;
+        if ((r < ranges.size ()) && (addrs[a] >= ranges[r].start))
+        {
+          set (ranges[r], addrs[a], locs[a]);
+          ++found;
+        }
+        else
+        {
+          locs[a] = location ();
+        }
+      }
+
+      return found;
+    }
+
+    size_t
+    symbolizer::symbol_count () const
+    {
+      return symbols.size ();
+    }
+
+    size_t
+    symbolizer::range_count () const
+    {
+      return ranges.size ();
+    }
+
+    void
+    symbolizer::output (std::ostream& out) const
+    {
+      out << "Symbolizer: symbols: " << symbols.size ()
+          << " ranges: " << ranges.size () << std::endl;
+
+      for (range_table::const_iterator ri = ranges.begin ();
+           ri != ranges.end ();
+           ++ri)
+      {
+        const range&  r = *ri;
+        const symbol& sym = symbols[r.sym];
+        out << std::hex << std::setfill ('0')
+            << " 0x" << std::setw (8) << r.start
+            << " 0x" << std::setw (8) << r.end
+            << std::dec << std::setfill (' ')
+            << ' ' << &names[sym.name];
+        if (r.start != sym.value)
+          out << "+0x" << std::hex << r.start - sym.value << std::dec;
+        out << std::endl;
+      }
+    }
+  }
+}
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker address symbolizer.
+ *
+ * The symbolizer translates addresses to a symbol and an offset. The function
+ * and object symbols of an executable are loaded in one pass over the ELF
+ * symbol tables and flattened into a sorted table of address ranges that do
+ * not overlap. A range refers to the innermost symbol covering it so nested
+ * or overlapping symbols resolve to the most specific symbol. Symbols with no
+ * size extend to the next symbol in the same section.
+ */
+
+#if !defined (_RLD_SYMBOLIZER_H_)
+#define _RLD_SYMBOLIZER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <rld-elf.h>
+
+namespace rld
+{
+  namespace symbolizer
+  {
+    /**
+     * Use a local type for the address.
+     */
+    typedef elf::elf_addr address;
+
+    /**
+     * A symbol held by the symbolizer.
+     */
+    struct symbol
+    {
+      address  value;   //< The symbol's address.
+      address  size;    //< The symbol's size.
+      uint32_t name;    //< The offset of the name in the names.
+      uint16_t shndx;   //< The section index.
+      uint8_t  type;    //< The ELF symbol type.
+      uint8_t  bind;    //< The ELF symbol binding.
+    };
+
+    /**
+     * An address range of a symbol. The ranges are sorted and do not
+     * overlap.
+     */
+    struct range
+    {
+      address  start;   //< The start of the range.
+      address  end;     //< The end of the range, one past the last address.
+      uint32_t sym;     //< The index of the symbol.
+    };
+
+    /**
+     * The result of a lookup.
+     */
+    struct location
+    {
+      const char* name;     //< The symbol name, 0 if not found.
+      address     value;    //< The symbol's address.
+      address     offset;   //< The offset of the address in the symbol.
+
+      location ();
+    };
+
+    /**
+     * Containers of addresses and locations for batch lookups.
+     */
+    typedef std::vector < address > addresses;
+    typedef std::vector < location > locations;
+
+    /**
+     * The symbolizer.
+     */
+    class symbolizer
+    {
+    public:
+      /**
+       * Construct an empty symbolizer.
+       */
+      symbolizer ();
+
+      /**
+       * Load the function and object symbols of the ELF file. The file can be
+       * loaded more than once to add the symbols of other files, for example
+       * dynamically loaded objects.
+       *
+       * @param file The ELF file.
+       */
+      void load (elf::file& file);
+
+      /**
+       * Look up an address. The last range found is remembered and checked
+       * first so a stream of addresses with locality is quicker.
+       *
+       * @param addr The address to look up.
+       * @param loc The location of the address.
+       * @retval true The address is in a symbol.
+       * @retval false The address is not in a symbol.
+       */
+      bool lookup (address addr, location& loc) const;
+
+      /**
+       * Look up a batch of addresses. The locations are in the order of the
+       * addresses. Sorted addresses are looked up with a single pass over the
+       * ranges.
+       *
+       * @param addrs The addresses to look up.
+       * @param locs The locations of the addresses.
+       * @return size_t The number of addresses found.
+       */
+      size_t lookup (const addresses& addrs, locations& locs) const;
+
+      /**
+       * The number of symbols.
+       */
+      size_t symbol_count () const;
+
+      /**
+       * The number of address ranges.
+       */
+      size_t range_count () const;
+
+      /**
+       * Output the ranges.
+       */
+      void output (std::ostream& out) const;
+
+    private:
+
+      /**
+       * Build the ranges from the symbols.
+       */
+      void build ();
+
+      /**
+       * Set the location from a range.
+       */
+      void set (const range& r, address addr, location& loc) const;
+
+      typedef std::vector < symbol > symbol_table;
+      typedef std::vector < range > range_table;
+
+      symbol_table      symbols;  //< The symbols.
+      range_table       ranges;   //< The sorted address ranges.
+      std::vector<char> names;    //< The symbol names.
+      mutable size_t    last;     //< The last range found.
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,632 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker symbol index files.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#include <rld.h>
+#include <rld-symindex.h>
+
+#if !defined (O_BINARY)
+#define O_BINARY 0
+#endif
+
+namespace rld
+{
+  namespace symindex
+  {
+    /**
+     * The magic string at the start of the file.
+     */
+    static const char magic[8] = { 'R', 'L', 'D', 'S', 'Y', 'M', 'I', 'X' };
+
+    /**
+     * Align to 8 bytes.
+     */
+    static uint64_t
+    align8 (uint64_t offset)
+    {
+      return (offset + 7) & ~((uint64_t) 7);
+    }
+
+    /**
+     * Get the size and modification time of a file.
+     */
+    static bool
+    file_stat (const std::string& path, uint64_t& size, uint64_t& mtime)
+    {
+      struct stat sb;
+      if (::stat (path.c_str (), &sb) != 0)
+        return false;
+      size = sb.st_size;
+      mtime = sb.st_mtime;
+      return true;
+    }
+
+    uint32_t
+    hash (const char* name)
+    {
+      /*
+       * FNV-1a.
+       */
+      uint32_t h = 2166136261U;
+      while (*name != '\0')
+      {
+        h ^= (uint8_t) *name++;
+        h *= 16777619U;
+      }
+      return h;
+    }
+
+    const std::string
+    index_path (const std::string& path)
+    {
+      return path + extension;
+    }
+
+    /**
+     * The string table being written. Strings are shared.
+     */
+    class string_table
+    {
+    public:
+      string_table ()
+      {
+        /*
+         * Offset 0 is the empty string.
+         */
+        strings += '\0';
+      }
+
+      uint32_t add (const std::string& str)
+      {
+        if (str.empty ())
+          return 0;
+        offsets::iterator oi = offsets_.find (str);
+        if (oi != offsets_.end ())
+          return (*oi).second;
+        uint32_t offset = strings.size ();
+        strings += str;
+        strings += '\0';
+        offsets_[str] = offset;
+        return offset;
+      }
+
+      std::string strings;
+
+    private:
+      typedef std::map < std::string, uint32_t > offsets;
+      offsets offsets_;
+    };
+
+    size_t
+    write (const std::string& path, const std::string& output)
+    {
+      const std::string out_path = output.empty () ? index_path (path) : output;
+
+      header hdr;
+
+      ::memset (&hdr, 0, sizeof (hdr));
+
+      if (!file_stat (path, hdr.source_size, hdr.source_mtime))
+        throw rld::error (::strerror (errno), "symindex:stat: " + path);
+
+      std::vector < member > members;
+      std::vector < symbol > syms;
+      string_table           strtab;
+
+      files::cache cache;
+
+      try
+      {
+        cache.open ();
+        cache.add (path);
+
+        files::objects& objs = cache.get_objects ();
+
+        for (files::objects::iterator oi = objs.begin ();
+             oi != objs.end ();
+             ++oi)
+        {
+          files::object& obj = *((*oi).second);
+
+          if (rld::verbose () >= RLD_VERBOSE_DETAILS)
+            std::cout << "symindex:write: " << obj.name ().full () << std::endl;
+
+          member mem;
+
+          ::memset (&mem, 0, sizeof (mem));
+
+          mem.offset = obj.get_archive () ? obj.name ().offset () : 0;
+          mem.size = obj.name ().size ();
+          /*
+           * The object files in a thin archive are named relative to the
+           * archive so the index matches however the archive is found.
+           */
+          if (obj.get_archive () && obj.get_archive ()->is_thin ())
+            mem.name =
+              strtab.add (obj.get_archive ()->member_name (obj.name ().oname ()));
+          else
+            mem.name = strtab.add (obj.name ().oname ());
+          mem.sym_first = syms.size ();
+
+          obj.open ();
+
+          try
+          {
+            obj.begin ();
+
+            /*
+             * The defined symbols then the unresolved symbols. These are the
+             * symbols the object file loads into a symbol table.
+             */
+            symbols::pointers defined;
+            symbols::pointers undefined;
+
+            obj.elf ().get_symbols (defined, false, true, true, true);
+            obj.elf ().get_symbols (undefined, true, false, false, false);
+
+            defined.insert (defined.end (), undefined.begin (), undefined.end ());
+
+            for (symbols::pointers::iterator si = defined.begin ();
+                 si != defined.end ();
+                 ++si)
+            {
+              const symbols::symbol& sym = *(*si);
+              const elf::elf_sym&    esym = sym.esym ();
+              symbol                 isym;
+
+              ::memset (&isym, 0, sizeof (isym));
+
+              isym.value = esym.st_value;
+              isym.size = esym.st_size;
+              isym.name = strtab.add (sym.name ());
+              isym.member = members.size ();
+              isym.index = sym.index ();
+              isym.hash = hash (sym.name ().c_str ());
+              isym.next = no_entry;
+              isym.shndx = esym.st_shndx;
+              isym.info = esym.st_info;
+              isym.other = esym.st_other;
+
+              syms.push_back (isym);
+            }
+
+            obj.end ();
+          }
+          catch (...)
+          {
+            obj.close ();
+            throw;
+          }
+
+          obj.close ();
+
+          mem.sym_count = syms.size () - mem.sym_first;
+
+          members.push_back (mem);
+        }
+
+        cache.archives_end ();
+        cache.close ();
+      }
+      catch (...)
+      {
+        cache.archives_end ();
+        cache.close ();
+        throw;
+      }
+
+      /*
+       * Build the hash table of the defined symbols. Size the table to have
+       * about two symbols in each chain.
+       */
+      uint32_t bucket_count = (syms.size () / 2) + 1;
+
+      std::vector < uint32_t > buckets (bucket_count, no_entry);
+
+      for (size_t s = syms.size (); s > 0; --s)
+      {
+        symbol& isym = syms[s - 1];
+        if (isym.shndx != SHN_UNDEF)
+        {
+          uint32_t b = isym.hash % bucket_count;
+          isym.next = buckets[b];
+          buckets[b] = s - 1;
+        }
+      }
+
+      ::memcpy (hdr.magic, magic, sizeof (hdr.magic));
+      hdr.version = version;
+      hdr.byte_order = byte_order;
+      hdr.member_count = members.size ();
+      hdr.symbol_count = syms.size ();
+      hdr.bucket_count = bucket_count;
+      hdr.strings_size = strtab.strings.size ();
+      hdr.members_off = align8 (sizeof (header));
+      hdr.symbols_off = align8 (hdr.members_off + (members.size () * sizeof (member)));
+      hdr.buckets_off = align8 (hdr.symbols_off + (syms.size () * sizeof (symbol)));
+      hdr.strings_off = hdr.buckets_off + (bucket_count * sizeof (uint32_t));
+
+      /*
+       * Write to a temporary name and rename so a reader never sees a
+       * partially written index.
+       */
+      const std::string tmp_path = out_path + ".tmp";
+
+      std::ofstream out (tmp_path.c_str (),
+                         std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      if (!out.is_open ())
+        throw rld::error ("cannot open", "symindex:write: " + tmp_path);
+
+      out.write ((const char*) &hdr, sizeof (hdr));
+      if (!members.empty ())
+      {
+        out.seekp (hdr.members_off);
+        out.write ((const char*) &members[0], members.size () * sizeof (member));
+      }
+      if (!syms.empty ())
+      {
+        out.seekp (hdr.symbols_off);
+        out.write ((const char*) &syms[0], syms.size () * sizeof (symbol));
+      }
+      out.seekp (hdr.buckets_off);
+      out.write ((const char*) &buckets[0], buckets.size () * sizeof (uint32_t));
+      out.write (strtab.strings.data (), strtab.strings.size ());
+
+      if (!out.good ())
+      {
+        out.close ();
+        ::unlink (tmp_path.c_str ());
+        throw rld::error ("write failed", "symindex:write: " + tmp_path);
+      }
+
+      out.close ();
+
+      if (::rename (tmp_path.c_str (), out_path.c_str ()) < 0)
+      {
+        ::unlink (tmp_path.c_str ());
+        throw rld::error (::strerror (errno), "symindex:rename: " + out_path);
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "symindex:write: " << out_path
+                  << ": members:" << members.size ()
+                  << " symbols:" << syms.size ()
+                  << " buckets:" << bucket_count
+                  << " strings:" << strtab.strings.size ()
+                  << std::endl;
+
+      return syms.size ();
+    }
+
+    index::index ()
+      : base (0),
+        size (0),
+        mapped (false)
+    {
+    }
+
+    index::~index ()
+    {
+      close ();
+    }
+
+    bool
+    index::load (const std::string& path)
+    {
+      const std::string ipath = index_path (path);
+
+      uint64_t src_size;
+      uint64_t src_mtime;
+      uint64_t idx_size;
+      uint64_t idx_mtime;
+
+      if (!file_stat (ipath, idx_size, idx_mtime))
+        return false;
+
+      if (!file_stat (path, src_size, src_mtime))
+        return false;
+
+      if (idx_mtime < src_mtime)
+      {
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "symindex:load: out of date: " << ipath << std::endl;
+        return false;
+      }
+
+      try
+      {
+        open (ipath);
+      }
+      catch (const rld::error& re)
+      {
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "symindex:load: ignored: " << re.where
+                    << ": " << re.what << std::endl;
+        return false;
+      }
+
+      if ((head ().source_size != src_size) ||
+          (head ().source_mtime != src_mtime))
+      {
+        if (rld::verbose () >= RLD_VERBOSE_INFO)
+          std::cout << "symindex:load: indexed file changed: " << ipath << std::endl;
+        close ();
+        return false;
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "symindex:load: " << ipath
+                  << ": members:" << head ().member_count
+                  << " symbols:" << head ().symbol_count
+                  << std::endl;
+
+      return true;
+    }
+
+    void
+    index::open (const std::string& path)
+    {
+      close ();
+
+      int fd = ::open (path.c_str (), O_RDONLY | O_BINARY);
+      if (fd < 0)
+        throw rld::error (::strerror (errno), "symindex:open: " + path);
+
+      struct stat sb;
+      if (::fstat (fd, &sb) < 0)
+      {
+        ::close (fd);
+        throw rld::error (::strerror (errno), "symindex:stat: " + path);
+      }
+
+      size = sb.st_size;
+
+      if (size < sizeof (header))
+      {
+        ::close (fd);
+        throw rld::error ("too small", "symindex:open: " + path);
+      }
+
+#if HAVE_MMAP
+      void* m = ::mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (m == MAP_FAILED)
+      {
+        ::close (fd);
+        throw rld::error (::strerror (errno), "symindex:mmap: " + path);
+      }
+      base = static_cast < const uint8_t* > (m);
+      mapped = true;
+#else
+      uint8_t* data = new uint8_t[size];
+      size_t   have = 0;
+      while (have < size)
+      {
+        ssize_t r = ::read (fd, data + have, size - have);
+        if (r <= 0)
+        {
+          delete [] data;
+          ::close (fd);
+          throw rld::error ("read failed", "symindex:read: " + path);
+        }
+        have += r;
+      }
+      base = data;
+      mapped = false;
+#endif
+
+      ::close (fd);
+
+      try
+      {
+        check (path);
+      }
+      catch (...)
+      {
+        close ();
+        throw;
+      }
+    }
+
+    void
+    index::close ()
+    {
+      if (base)
+      {
+#if HAVE_MMAP
+        if (mapped)
+          ::munmap (const_cast < uint8_t* > (base), size);
+        else
+#endif
+          delete [] base;
+        base = 0;
+        size = 0;
+        mapped = false;
+      }
+    }
+
+    bool
+    index::is_loaded () const
+    {
+      return base != 0;
+    }
+
+    const header&
+    index::head () const
+    {
+      if (!base)
+        throw rld::error ("not loaded", "symindex:head");
+      return *reinterpret_cast < const header* > (base);
+    }
+
+    const member&
+    index::get_member (uint32_t m) const
+    {
+      if (m >= head ().member_count)
+        throw rld::error ("invalid member: " + rld::to_string (m),
+                          "symindex:get-member");
+      const member* members =
+        reinterpret_cast < const member* > (base + head ().members_off);
+      return members[m];
+    }
+
+    const symbol&
+    index::get_symbol (uint32_t s) const
+    {
+      if (s >= head ().symbol_count)
+        throw rld::error ("invalid symbol: " + rld::to_string (s),
+                          "symindex:get-symbol");
+      const symbol* syms =
+        reinterpret_cast < const symbol* > (base + head ().symbols_off);
+      return syms[s];
+    }
+
+    const char*
+    index::get_string (uint32_t offset) const
+    {
+      if (offset >= head ().strings_size)
+        throw rld::error ("invalid string: " + rld::to_string (offset),
+                          "symindex:get-string");
+      return reinterpret_cast < const char* > (base + head ().strings_off + offset);
+    }
+
+    const symbol*
+    index::find (const std::string& name) const
+    {
+      const header&   hdr = head ();
+      const uint32_t* buckets =
+        reinterpret_cast < const uint32_t* > (base + hdr.buckets_off);
+      const uint32_t  h = hash (name.c_str ());
+      uint32_t        s = buckets[h % hdr.bucket_count];
+
+      while (s != no_entry)
+      {
+        const symbol& isym = get_symbol (s);
+        if ((isym.hash == h) && (name == get_string (isym.name)))
+          return &isym;
+        s = isym.next;
+      }
+
+      return 0;
+    }
+
+    void
+    index::load_symbols (uint32_t m, symbols::bucket& syms) const
+    {
+      const member& mem = get_member (m);
+
+      for (uint32_t s = mem.sym_first; s < (mem.sym_first + mem.sym_count); ++s)
+      {
+        const symbol& isym = get_symbol (s);
+        elf::elf_sym  esym;
+
+        ::memset (&esym, 0, sizeof (esym));
+
+        esym.st_value = isym.value;
+        esym.st_size = isym.size;
+        esym.st_info = isym.info;
+        esym.st_other = isym.other;
+        esym.st_shndx = isym.shndx;
+
+        syms.push_back (symbols::symbol (isym.index,
+                                         get_string (isym.name),
+                                         esym));
+      }
+    }
+
+    void
+    index::check (const std::string& path)
+    {
+      const header& hdr = head ();
+
+      if (::memcmp (hdr.magic, magic, sizeof (magic)) != 0)
+        throw rld::error ("invalid magic", "symindex:check: " + path);
+      if (hdr.byte_order != byte_order)
+        throw rld::error ("invalid byte order", "symindex:check: " + path);
+      if (hdr.version != version)
+        throw rld::error ("unsupported version: " + rld::to_string (hdr.version),
+                          "symindex:check: " + path);
+      if ((hdr.bucket_count == 0) ||
+          ((hdr.members_off + ((uint64_t) hdr.member_count * sizeof (member))) > size) ||
+          ((hdr.symbols_off + ((uint64_t) hdr.symbol_count * sizeof (symbol))) > size) ||
+          ((hdr.buckets_off + ((uint64_t) hdr.bucket_count * sizeof (uint32_t))) > size) ||
+          ((hdr.strings_off + hdr.strings_size) > size) ||
+          (hdr.strings_size == 0) ||
+          (base[hdr.strings_off + hdr.strings_size - 1] != '\0'))
+        throw rld::error ("invalid layout", "symindex:check: " + path);
+    }
+
+    void
+    index::output (std::ostream& out) const
+    {
+      const header& hdr = head ();
+
+      out << "Symbol Index:" << std::endl
+          << " Version      : " << hdr.version << std::endl
+          << " Indexed size : " << hdr.source_size << std::endl
+          << " Members      : " << hdr.member_count << std::endl
+          << " Symbols      : " << hdr.symbol_count << std::endl
+          << " Buckets      : " << hdr.bucket_count << std::endl
+          << " Strings      : " << hdr.strings_size << std::endl;
+
+      for (uint32_t m = 0; m < hdr.member_count; ++m)
+      {
+        const member& mem = get_member (m);
+        symbols::bucket syms;
+
+        out << ' ' << get_string (mem.name)
+            << " @" << mem.offset
+            << " (" << mem.size << ')' << std::endl;
+
+        load_symbols (m, syms);
+
+        for (symbols::bucket::const_iterator si = syms.begin ();
+             si != syms.end ();
+             ++si)
+        {
+          out << "  ";
+          (*si).output (out);
+          out << std::endl;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2016, Chris Johns <chrisj@rtems.org>
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief RTEMS Linker symbol index files.
+ *
+ * A symbol index is a precompiled copy of the symbols the linker loads from
+ * an ELF file or an archive of ELF files. The index is written next to the
+ * file it indexes and is mapped into memory when read so a link against a
+ * base image or library that has not changed does not need to parse the ELF
+ * symbol tables of every object file.
+ *
+ * The index holds a table of the object files (members), a table of symbols
+ * grouped by member and a hash table of the defined symbol names. All values
+ * are in the host's byte order and the header records the byte order, the
+ * version and the size and modification time of the indexed file.
+ */
+
+#if !defined (_RLD_SYMINDEX_H_)
+#define _RLD_SYMINDEX_H_
+
+#include <string>
+
+#include <rld-files.h>
+#include <rld-symbols.h>
+
+namespace rld
+{
+  namespace symindex
+  {
+    /**
+     * The index file format version.
+     */
+    const uint32_t version = 1;
+
+    /**
+     * The file extension appended to the indexed file's name.
+     */
+    const char* const extension = ".symidx";
+
+    /**
+     * The value used to check the byte order.
+     */
+    const uint32_t byte_order = 0x01020304;
+
+    /**
+     * The value of an empty hash bucket or the end of a hash chain.
+     */
+    const uint32_t no_entry = 0xffffffff;
+
+    /**
+     * The index file header.
+     */
+    struct header
+    {
+      char     magic[8];      //< The magic string 'RLDSYMIX'.
+      uint32_t version;       //< The format version.
+      uint32_t byte_order;    //< The byte order check value.
+      uint32_t member_count;  //< The number of object file members.
+      uint32_t symbol_count;  //< The number of symbols.
+      uint32_t bucket_count;  //< The number of hash buckets.
+      uint32_t strings_size;  //< The size of the string table.
+      uint64_t members_off;   //< The offset of the member table.
+      uint64_t symbols_off;   //< The offset of the symbol table.
+      uint64_t buckets_off;   //< The offset of the hash buckets.
+      uint64_t strings_off;   //< The offset of the string table.
+      uint64_t source_size;   //< The size of the indexed file.
+      uint64_t source_mtime;  //< The modification time of the indexed file.
+    };
+
+    /**
+     * An object file in the indexed file. If the indexed file is an archive
+     * the offset and size locate the object file in the archive.
+     */
+    struct member
+    {
+      uint64_t offset;        //< The offset in the archive.
+      uint64_t size;          //< The size of the object file.
+      uint32_t name;          //< The object file name in the string table.
+      uint32_t sym_first;     //< The first symbol of this member.
+      uint32_t sym_count;     //< The number of symbols in this member.
+      uint32_t padding;       //< Keep the size a multiple of 8.
+    };
+
+    /**
+     * A symbol. The ELF fields of the symbol are held so a symbol can be
+     * constructed without the ELF file.
+     */
+    struct symbol
+    {
+      uint64_t value;         //< The ELF symbol value.
+      uint64_t size;          //< The ELF symbol size.
+      uint32_t name;          //< The symbol name in the string table.
+      uint32_t member;        //< The member index.
+      uint32_t index;         //< The symbol's index in the ELF symtab.
+      uint32_t hash;          //< The hash of the name.
+      uint32_t next;          //< The next symbol in the hash chain.
+      uint16_t shndx;         //< The ELF section index.
+      uint8_t  info;          //< The ELF symbol info.
+      uint8_t  other;         //< The ELF symbol other field.
+    };
+
+    /**
+     * Hash a symbol name.
+     */
+    uint32_t hash (const char* name);
+
+    /**
+     * Return the path of the index file for the file.
+     *
+     * @param path The path of the file being indexed.
+     */
+    const std::string index_path (const std::string& path);
+
+    /**
+     * Write the index for the ELF file or archive to the index path.
+     *
+     * @param path The ELF file or archive to index.
+     * @param output The index file to write. If empty the index path of the
+     *               file is used.
+     * @return size_t The number of symbols written.
+     */
+    size_t write (const std::string& path, const std::string& output = "");
+
+    /**
+     * A symbol index mapped into memory.
+     */
+    class index
+    {
+    public:
+      /**
+       * Construct an index.
+       */
+      index ();
+
+      /**
+       * Unmap the index if loaded.
+       */
+      ~index ();
+
+      /**
+       * Load the index of the file if the index exists, is valid and is
+       * newer than the file.
+       *
+       * @param path The path of the indexed file.
+       * @retval true The index is loaded.
+       * @retval false No usable index exists.
+       */
+      bool load (const std::string& path);
+
+      /**
+       * Load the index file without checking it against the indexed file.
+       * Throws an error if the file is not a valid index.
+       *
+       * @param path The path of the index file.
+       */
+      void open (const std::string& path);
+
+      /**
+       * Unmap the index.
+       */
+      void close ();
+
+      /**
+       * Is the index loaded ?
+       */
+      bool is_loaded () const;
+
+      /**
+       * The index header.
+       */
+      const header& head () const;
+
+      /**
+       * Return the member given its index.
+       */
+      const member& get_member (uint32_t m) const;
+
+      /**
+       * Return the symbol given its index.
+       */
+      const symbol& get_symbol (uint32_t s) const;
+
+      /**
+       * Return a string from the string table.
+       */
+      const char* get_string (uint32_t offset) const;
+
+      /**
+       * Find a defined symbol by name using the hash table. Returns 0 if not
+       * found.
+       */
+      const symbol* find (const std::string& name) const;
+
+      /**
+       * Construct the symbols of a member into the bucket.
+       *
+       * @param m The member index.
+       * @param syms The bucket the symbols are added too.
+       */
+      void load_symbols (uint32_t m, symbols::bucket& syms) const;
+
+      /**
+       * Output the index.
+       */
+      void output (std::ostream& out) const;
+
+    private:
+
+      /**
+       * Cannot copy an index.
+       */
+      index (const index& orig);
+
+      /**
+       * Validate the index after it has been read.
+       */
+      void check (const std::string& path);
+
+      const uint8_t* base;    //< The base of the index.
+      size_t         size;    //< The size of the index.
+      bool           mapped;  //< The index is mapped else it is allocated.
+    };
+  }
+}
+
+#endif
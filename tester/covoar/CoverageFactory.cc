@@ -11,8 +11,11 @@
 #include <string.h>
 
 #include "CoverageFactory.h"
+#include "CoverageReaderDrcov.h"
+#include "CoverageReaderGmon.h"
 #include "CoverageReaderQEMU.h"
 #include "CoverageReaderRTEMS.h"
+#include "CoverageReaderRTLD.h"
 #include "CoverageWriterRTEMS.h"
 #include "CoverageReaderSkyeye.h"
 #include "CoverageWriterSkyeye.h"
@@ -23,12 +26,21 @@ Coverage::CoverageFormats_t Coverage::CoverageFormatToEnum(
   const char* const format
 )
 {
+  if (!strcmp( format, "drcov" ))
+    return COVERAGE_FORMAT_DRCOV;
+
+  if (!strcmp( format, "gmon" ))
+    return COVERAGE_FORMAT_GMON;
+
   if (!strcmp( format, "QEMU" ))
     return COVERAGE_FORMAT_QEMU;
 
   if (!strcmp( format, "RTEMS" ))
     return COVERAGE_FORMAT_RTEMS;
 
+  if (!strcmp( format, "RTLD" ))
+    return COVERAGE_FORMAT_RTLD;
+
   if (!strcmp( format, "Skyeye" ))
     return COVERAGE_FORMAT_SKYEYE;
 
@@ -38,7 +50,7 @@ Coverage::CoverageFormats_t Coverage::CoverageFormatToEnum(
   fprintf(
     stderr,
     "ERROR: %s is an unknown coverage format "
-    "(supported formats - QEMU, RTEMS, Skyeye and TSIM)\n",
+    "(supported formats - drcov, gmon, QEMU, RTEMS, RTLD, Skyeye and TSIM)\n",
     format
   );
   exit( 1 );
@@ -49,10 +61,16 @@ Coverage::CoverageReaderBase* Coverage::CreateCoverageReader(
 )
 {
   switch (format) {
+    case COVERAGE_FORMAT_DRCOV:
+      return new Coverage::CoverageReaderDrcov();
+    case COVERAGE_FORMAT_GMON:
+      return new Coverage::CoverageReaderGmon();
     case COVERAGE_FORMAT_QEMU:
       return new Coverage::CoverageReaderQEMU();
     case COVERAGE_FORMAT_RTEMS:
       return new Coverage::CoverageReaderRTEMS();
+    case COVERAGE_FORMAT_RTLD:
+      return new Coverage::CoverageReaderRTLD();
     case COVERAGE_FORMAT_SKYEYE:
       return new Coverage::CoverageReaderSkyeye();
     case COVERAGE_FORMAT_TSIM:
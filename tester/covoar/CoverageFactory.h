@@ -18,8 +18,11 @@ namespace Coverage {
    *  This type defines the coverage file formats that are supported.
    */
   typedef enum {
+    COVERAGE_FORMAT_DRCOV,
+    COVERAGE_FORMAT_GMON,
     COVERAGE_FORMAT_QEMU,
     COVERAGE_FORMAT_RTEMS,
+    COVERAGE_FORMAT_RTLD,
     COVERAGE_FORMAT_SKYEYE,
     COVERAGE_FORMAT_TSIM
   } CoverageFormats_t;
@@ -201,6 +201,35 @@ namespace Coverage {
     Info[ offset ].wasExecuted += 1;
   }
 
+  uint32_t CoverageMapBase::setBlockWasExecuted(
+    uint32_t address,
+    uint32_t size
+  )
+  {
+    AddressRange_t range;
+    uint32_t       offset;
+    uint32_t       count;
+    uint32_t       a;
+
+    if (getRange( address, &range ) != true)
+      return 0;
+
+    offset = address - range.lowAddress;
+    if (offset >= Size)
+      return 0;
+
+    count = range.highAddress - address + 1;
+    if (count > Size - offset)
+      count = Size - offset;
+    if (size < count)
+      count = size;
+
+    for (a = 0; a < count; a++)
+      Info[ offset + a ].wasExecuted += 1;
+
+    return count;
+  }
+
   void CoverageMapBase::sumWasExecuted( uint32_t address, uint32_t addition)
   {
     uint32_t offset;
@@ -186,6 +186,19 @@ namespace Coverage {
      */
     virtual void setWasExecuted( uint32_t address );
 
+    /*!
+     *  This method increments the counter of each address in a block
+     *  of executed addresses. The block is marked up to the end of the
+     *  address range holding the first address.
+     *
+     *  @param[in] address specifies the first address which was executed
+     *  @param[in] size specifies the number of addresses executed
+     *
+     *  @return Returns the number of addresses marked. Zero is returned
+     *   if the first address is not in the map.
+     */
+    uint32_t setBlockWasExecuted( uint32_t address, uint32_t size );
+
     /*!
      *  This method returns a boolean which indicates if the instruction
      *  at the specified address was executed.
@@ -0,0 +1,393 @@
+/*! @file CoverageReaderDrcov.cc
+ *  @brief CoverageReaderDrcov Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  reading the drcov basic block coverage data files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "app_common.h"
+#include "CoverageReaderDrcov.h"
+#include "CoverageMap.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*!
+   *  The size of a basic block entry in the basic block table.
+   */
+  #define DRCOV_BB_SIZE 8
+
+  /*!
+   *  The number of basic block entries read at a time.
+   */
+  #define DRCOV_BB_ENTRIES 1024
+
+  /*!
+   *  This type defines a module in the module table.
+   */
+  typedef struct {
+    uint32_t base;
+    bool     used;
+  } drcovModule_t;
+
+  /*!
+   *  This method returns the file name of a path.
+   */
+  static const char* baseName( const char* path )
+  {
+    const char* name = path;
+    const char* p;
+
+    for (p = path; *p != '\0'; p++) {
+      if ((*p == '/') || (*p == '\\'))
+        name = p + 1;
+    }
+    return name;
+  }
+
+  /*!
+   *  This method removes the white space from the start and end of a
+   *  string.
+   */
+  static std::string trim( const std::string& s )
+  {
+    size_t first = s.find_first_not_of( " \t\r\n" );
+    size_t last = s.find_last_not_of( " \t\r\n" );
+
+    if (first == std::string::npos)
+      return "";
+    return s.substr( first, last - first + 1 );
+  }
+
+  /*!
+   *  This method splits a line of the module table into the columns. The
+   *  last column is the path and it is the rest of the line.
+   */
+  static bool splitColumns(
+    const char*               line,
+    size_t                    columns,
+    std::vector<std::string>& fields
+  )
+  {
+    const char* start = line;
+    const char* comma;
+
+    fields.clear();
+    while (fields.size() < (columns - 1)) {
+      comma = strchr( start, ',' );
+      if (!comma)
+        return false;
+      fields.push_back( trim( std::string( start, comma - start ) ) );
+      start = comma + 1;
+    }
+    fields.push_back( trim( start ) );
+    return true;
+  }
+
+  /*!
+   *  This method returns true if the module path is the executable or one
+   *  of the executable's modules.
+   */
+  static bool isAnalyzed(
+    const char* const     path,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    const char*                   name = baseName( path );
+    ExecutableInfo::modules_t&    modules = executableInformation->getModules();
+    ExecutableInfo::modules_t::iterator mitr;
+
+    if (!strcmp( name, baseName( executableInformation->getFileName().c_str() ) ))
+      return true;
+
+    for (mitr = modules.begin(); mitr != modules.end(); mitr++) {
+      if (!strcmp( name, baseName( (*mitr)->getLibraryName().c_str() ) ))
+        return true;
+    }
+    return false;
+  }
+
+  CoverageReaderDrcov::CoverageReaderDrcov()
+  {
+  }
+
+  CoverageReaderDrcov::~CoverageReaderDrcov()
+  {
+  }
+
+  void CoverageReaderDrcov::processFile(
+    const char* const     file,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    CoverageMapBase*            aCoverageMap;
+    FILE*                       coverageFile;
+    char*                       cStatus;
+    const char*                 value;
+    std::vector<std::string>    columns;
+    std::vector<std::string>    fields;
+    std::vector<drcovModule_t>  modules;
+    drcovModule_t               module;
+    size_t                      idColumn;
+    size_t                      baseColumn;
+    size_t                      pathColumn;
+    unsigned long               count;
+    unsigned long               blocks;
+    unsigned long               skipped;
+    unsigned long long          base;
+    uint8_t                     entries[DRCOV_BB_ENTRIES * DRCOV_BB_SIZE];
+    size_t                      numEntries;
+    size_t                      e;
+    size_t                      m;
+
+    //
+    // Open the coverage file and check the version.
+    //
+    coverageFile = fopen( file, "rb" );
+    if (!coverageFile) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderDrcov::processFile - Unable to open %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, coverageFile );
+    if ((cStatus == NULL) ||
+        (strncmp( inputBuffer, "DRCOV VERSION:", 14 ) != 0)) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderDrcov::processFile - "
+        "%s is not a drcov coverage file\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    //
+    // Find the module table. The flavor and any other header lines are
+    // skipped.
+    //
+    while (1) {
+      cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, coverageFile );
+      if (cStatus == NULL) {
+        fprintf(
+          stderr,
+          "ERROR: CoverageReaderDrcov::processFile - "
+          "no module table in %s\n",
+          file
+        );
+        exit( -1 );
+      }
+      if (strncmp( inputBuffer, "Module Table:", 13 ) == 0)
+        break;
+    }
+
+    //
+    // The table is 'Module Table: version N, count N' or 'Module Table: N'.
+    //
+    value = strstr( inputBuffer, "count" );
+    if (value)
+      value += 5;
+    else
+      value = inputBuffer + 13;
+    count = strtoul( value, NULL, 10 );
+
+    //
+    // The columns of the module table. The columns are fixed if the table
+    // has no columns line.
+    //
+    columns.push_back( "id" );
+    columns.push_back( "base" );
+    columns.push_back( "end" );
+    columns.push_back( "entry" );
+    columns.push_back( "path" );
+
+    cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, coverageFile );
+    if (cStatus && (strncmp( inputBuffer, "Columns:", 8 ) == 0)) {
+      value = inputBuffer + 8;
+      columns.clear();
+      while (1) {
+        const char* comma = strchr( value, ',' );
+        if (!comma) {
+          columns.push_back( trim( value ) );
+          break;
+        }
+        columns.push_back( trim( std::string( value, comma - value ) ) );
+        value = comma + 1;
+      }
+      cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, coverageFile );
+    }
+
+    idColumn = baseColumn = pathColumn = columns.size();
+    for (m = 0; m < columns.size(); m++) {
+      if (columns[ m ] == "id")
+        idColumn = m;
+      else if ((columns[ m ] == "base") || (columns[ m ] == "start"))
+        baseColumn = m;
+      else if (columns[ m ] == "path")
+        pathColumn = m;
+    }
+
+    if ((idColumn == columns.size()) ||
+        (baseColumn == columns.size()) ||
+        (pathColumn != (columns.size() - 1))) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderDrcov::processFile - "
+        "unsupported module table columns in %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    //
+    // Load the modules. The modules being analyzed are matched by the file
+    // name. A single module is the executable.
+    //
+    modules.resize( count );
+    for (m = 0; m < count; m++) {
+      unsigned long id;
+
+      if ((cStatus == NULL) ||
+          !splitColumns( inputBuffer, columns.size(), fields )) {
+        fprintf(
+          stderr,
+          "ERROR: CoverageReaderDrcov::processFile - "
+          "invalid module table in %s\n",
+          file
+        );
+        exit( -1 );
+      }
+
+      id = strtoul( fields[ idColumn ].c_str(), NULL, 10 );
+      base = strtoull( fields[ baseColumn ].c_str(), NULL, 0 );
+
+      if (id >= count) {
+        fprintf(
+          stderr,
+          "ERROR: CoverageReaderDrcov::processFile - "
+          "invalid module id %lu in %s\n",
+          id,
+          file
+        );
+        exit( -1 );
+      }
+
+      module.base = (uint32_t) base;
+      module.used = (count == 1) ||
+        isAnalyzed( fields[ pathColumn ].c_str(), executableInformation );
+
+      if (module.used && (base > 0xffffffffULL)) {
+        if (Verbose)
+          fprintf(
+            stderr,
+            "CoverageReaderDrcov::processFile - "
+            "%s is above 4G and is skipped\n",
+            fields[ pathColumn ].c_str()
+          );
+        module.used = false;
+      }
+
+      if (Verbose && !module.used)
+        fprintf(
+          stderr,
+          "CoverageReaderDrcov::processFile - %s is not analyzed\n",
+          fields[ pathColumn ].c_str()
+        );
+
+      modules[ id ] = module;
+
+      cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, coverageFile );
+    }
+
+    //
+    // The basic block table follows the 'BB Table: N bbs' line.
+    //
+    if ((cStatus == NULL) ||
+        (strncmp( inputBuffer, "BB Table:", 9 ) != 0)) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderDrcov::processFile - "
+        "no basic block table in %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    blocks = strtoul( inputBuffer + 9, NULL, 10 );
+    skipped = 0;
+
+    //
+    // Mark each basic block of a module being analyzed as executed. A
+    // block is marked in bulk and a block crossing into the next symbol
+    // is marked in the next symbol's coverage map.
+    //
+    while (blocks) {
+      numEntries = blocks < DRCOV_BB_ENTRIES ? blocks : DRCOV_BB_ENTRIES;
+
+      if (fread( entries, DRCOV_BB_SIZE, numEntries, coverageFile ) !=
+          numEntries) {
+        fprintf(
+          stderr,
+          "ERROR: CoverageReaderDrcov::processFile - "
+          "Unable to read the basic blocks from %s\n",
+          file
+        );
+        exit( -1 );
+      }
+
+      for (e = 0; e < numEntries; e++) {
+        const uint8_t* entry = &entries[ e * DRCOV_BB_SIZE ];
+        uint32_t       start;
+        uint32_t       size;
+        uint32_t       id;
+        uint32_t       address;
+        uint32_t       marked;
+
+        start = entry[0] | (entry[1] << 8) | (entry[2] << 16) |
+                ((uint32_t) entry[3] << 24);
+        size = entry[4] | (entry[5] << 8);
+        id = entry[6] | (entry[7] << 8);
+
+        if ((id >= modules.size()) || !modules[ id ].used) {
+          skipped++;
+          continue;
+        }
+
+        address = modules[ id ].base + start;
+
+        while (size) {
+          aCoverageMap = executableInformation->getCoverageMap( address );
+          marked = 0;
+          if (aCoverageMap)
+            marked = aCoverageMap->setBlockWasExecuted( address, size );
+          if (marked == 0)
+            marked = 1;
+          address += marked;
+          size -= marked;
+        }
+      }
+
+      blocks -= numEntries;
+    }
+
+    fclose( coverageFile );
+
+    if (Verbose && skipped)
+      fprintf(
+        stderr,
+        "CoverageReaderDrcov::processFile - %s: %lu blocks not analyzed\n",
+        file,
+        skipped
+      );
+  }
+}
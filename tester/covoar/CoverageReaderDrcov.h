@@ -0,0 +1,58 @@
+/*! @file CoverageReaderDrcov.h
+ *  @brief CoverageReaderDrcov Specification
+ *
+ *  This file contains the specification of the CoverageReaderDrcov class.
+ */
+
+#ifndef __COVERAGE_READER_DRCOV_H__
+#define __COVERAGE_READER_DRCOV_H__
+
+#include "CoverageReaderBase.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*! @class CoverageReaderDrcov
+   *
+   *  This class implements the functionality which reads a coverage file
+   *  in the drcov format written by DynamoRIO and the simulators and
+   *  binary translators that follow it.  The file is a text header with
+   *  a table of the modules that were loaded followed by a binary table
+   *  of the basic blocks executed.  Each basic block is the offset of the
+   *  block from the base of its module, the size of the block and the
+   *  module's id.  A module is matched to the executable or one of its
+   *  modules by the file name with the path removed.  If the module table
+   *  only has one module it is the executable.  The module table columns
+   *  are found by name so the checksum and timestamp columns DynamoRIO
+   *  writes are skipped, the path must be the last column.  A basic block
+   *  that runs into the next symbol is marked in each symbol it covers.
+   *  The basic block table is in little endian byte order.
+@verbatim
+DRCOV VERSION: 2
+DRCOV FLAVOR: drcov
+Module Table: version 2, count 1
+Columns: id, base, end, entry, path
+  0, 0x40000000, 0x40020000, 0x40000000, /path/to/ticker.exe
+BB Table: 2 bbs
+uint32_t start; uint16_t size; uint16_t id;  for each basic block
+@endverbatim
+   */
+  class CoverageReaderDrcov : public CoverageReaderBase {
+
+  public:
+
+    /* Inherit documentation from base class. */
+    CoverageReaderDrcov();
+
+    /* Inherit documentation from base class. */
+    virtual ~CoverageReaderDrcov();
+
+    /* Inherit documentation from base class. */
+    void processFile(
+      const char* const     file,
+      ExecutableInfo* const executableInformation
+    );
+  };
+
+}
+#endif
@@ -0,0 +1,330 @@
+/*! @file CoverageReaderGmon.cc
+ *  @brief CoverageReaderGmon Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  reading the gprof gmon.out sampled profiles.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "app_common.h"
+#include "CoverageReaderGmon.h"
+#include "CoverageMap.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*!
+   *  The values in the header of a gmon.out file.
+   */
+  #define GMON_COOKIE   "gmon"
+  #define GMON_VERSION  1
+
+  /*!
+   *  The tags of the records in a gmon.out file.
+   */
+  #define GMON_TAG_TIME_HIST 0
+  #define GMON_TAG_CG_ARC    1
+  #define GMON_TAG_BB_COUNT  2
+
+  /*!
+   *  This type defines a gmon.out file being read.
+   */
+  typedef struct {
+    FILE*       file;
+    const char* name;
+    bool        bigEndian;
+  } gmonFile_t;
+
+  /*!
+   *  This method reads bytes from the file and exits on an error.
+   */
+  static void readBytes( gmonFile_t& gmon, void* buffer, size_t size )
+  {
+    if (fread( buffer, size, 1, gmon.file ) != 1) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderGmon::processFile - "
+        "Unable to read the profile from %s\n",
+        gmon.name
+      );
+      exit( -1 );
+    }
+  }
+
+  /*!
+   *  This method reads a 32 bit value in the file's byte order.
+   */
+  static uint32_t read32( gmonFile_t& gmon )
+  {
+    uint8_t b[4];
+
+    readBytes( gmon, b, sizeof(b) );
+    if (gmon.bigEndian)
+      return ((uint32_t) b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+    return ((uint32_t) b[3] << 24) | (b[2] << 16) | (b[1] << 8) | b[0];
+  }
+
+  /*!
+   *  This method returns the symbol holding the address in the
+   *  executable or one of its modules.
+   */
+  static std::string findSymbol(
+    uint32_t              address,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    ExecutableInfo::modules_t&          modules =
+      executableInformation->getModules();
+    ExecutableInfo::modules_t::iterator mitr;
+    std::string                         symbol;
+
+    symbol = executableInformation->getSymbolTable()->getSymbol( address );
+    for (mitr = modules.begin();
+         symbol.empty() && (mitr != modules.end());
+         mitr++) {
+      symbol = (*mitr)->getSymbolTable()->getSymbol( address );
+    }
+    return symbol;
+  }
+
+  /*!
+   *  This method adds the samples to each byte of the instruction
+   *  starting at the address.
+   */
+  static void sampleInstruction(
+    CoverageMapBase* aCoverageMap,
+    uint32_t         address,
+    uint32_t         samples
+  )
+  {
+    uint32_t offset;
+
+    do {
+      aCoverageMap->sumWasExecuted( address, samples );
+      address++;
+    } while (aCoverageMap->determineOffset( address, &offset ) &&
+             !aCoverageMap->isStartOfInstruction( address ));
+  }
+
+  /*!
+   *  This method shares the samples of a histogram bucket between the
+   *  instructions starting in the bucket. If no instruction starts in
+   *  the bucket the instruction holding the bucket is sampled.
+   *
+   *  @return Returns false if the bucket is not in a coverage map.
+   */
+  static bool sampleBucket(
+    uint32_t              low,
+    uint32_t              high,
+    uint32_t              samples,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    CoverageMapBase*       aCoverageMap;
+    std::vector<uint32_t>  starts;
+    std::vector<uint32_t>::size_type s;
+    uint32_t               address;
+    uint32_t               share;
+    uint32_t               extra;
+
+    for (address = low; address < high; address++) {
+      aCoverageMap = executableInformation->getCoverageMap( address );
+      if (aCoverageMap && aCoverageMap->isStartOfInstruction( address ))
+        starts.push_back( address );
+    }
+
+    if (starts.empty()) {
+      aCoverageMap = executableInformation->getCoverageMap( low );
+      if (!aCoverageMap ||
+          !aCoverageMap->getBeginningOfInstruction( low, &address ))
+        return false;
+      sampleInstruction( aCoverageMap, address, samples );
+      return true;
+    }
+
+    share = samples / starts.size();
+    extra = samples % starts.size();
+
+    for (s = 0; s < starts.size(); s++) {
+      uint32_t count = share + (s < extra ? 1 : 0);
+      if (count) {
+        aCoverageMap = executableInformation->getCoverageMap( starts[ s ] );
+        sampleInstruction( aCoverageMap, starts[ s ], count );
+      }
+    }
+    return true;
+  }
+
+  CoverageReaderGmon::CoverageReaderGmon()
+  {
+  }
+
+  CoverageReaderGmon::~CoverageReaderGmon()
+  {
+  }
+
+  void CoverageReaderGmon::processFile(
+    const char* const     file,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    gmonFile_t             gmon;
+    uint8_t                header[20];
+    int                    tag;
+    uint32_t               lowPC;
+    uint32_t               highPC;
+    uint32_t               histSize;
+    std::vector<uint8_t>   bins;
+    char                   dimension[16];
+    uint32_t               b;
+    uint64_t               range;
+    uint32_t               low;
+    uint32_t               high;
+    uint32_t               samples;
+    uint32_t               unmatched;
+    uint32_t               fromPC;
+    uint32_t               selfPC;
+    uint32_t               count;
+    SymbolInformation*     symbolInfo;
+    std::string            symbol;
+
+    //
+    // Open the profile and read the header.
+    //
+    gmon.name = file;
+    gmon.file = fopen( file, "rb" );
+    if (!gmon.file) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderGmon::processFile - Unable to open %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    //
+    // The version is in the target's byte order so it gives the byte
+    // order of the file.
+    //
+    readBytes( gmon, header, sizeof(header) );
+    gmon.bigEndian = (header[4] == 0) && (header[7] == GMON_VERSION);
+
+    if ((memcmp( header, GMON_COOKIE, 4 ) != 0) ||
+        (!gmon.bigEndian &&
+         ((header[4] != GMON_VERSION) || (header[7] != 0)))) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderGmon::processFile - "
+        "%s is not a gmon.out version %d profile\n",
+        file,
+        GMON_VERSION
+      );
+      exit( -1 );
+    }
+
+    unmatched = 0;
+
+    while ((tag = fgetc( gmon.file )) != EOF) {
+      switch (tag) {
+
+        //
+        // Share each bucket's samples between its instructions.
+        //
+        case GMON_TAG_TIME_HIST:
+          lowPC = read32( gmon );
+          highPC = read32( gmon );
+          histSize = read32( gmon );
+          read32( gmon );
+          readBytes( gmon, dimension, 16 );
+
+          range = highPC - lowPC;
+
+          bins.resize( histSize * 2 );
+          if (histSize)
+            readBytes( gmon, &bins[0], bins.size() );
+
+          for (b = 0; b < histSize; b++) {
+            if (gmon.bigEndian)
+              samples = (bins[ b * 2 ] << 8) | bins[ b * 2 + 1 ];
+            else
+              samples = (bins[ b * 2 + 1 ] << 8) | bins[ b * 2 ];
+
+            if (samples) {
+              low = lowPC + (uint32_t) ((range * b) / histSize);
+              high = lowPC + (uint32_t) ((range * (b + 1)) / histSize);
+              if (high == low)
+                high = low + 1;
+
+              if (!sampleBucket( low, high, samples, executableInformation ))
+                unmatched += samples;
+            }
+          }
+          break;
+
+        //
+        // Add the count to the calls of the symbol called.
+        //
+        case GMON_TAG_CG_ARC:
+          fromPC = read32( gmon );
+          selfPC = read32( gmon );
+          count = read32( gmon );
+
+          symbol = findSymbol( selfPC, executableInformation );
+          symbolInfo = symbol.empty() ? NULL : SymbolsToAnalyze->find( symbol );
+          if (symbolInfo)
+            symbolInfo->stats.calls += count;
+          else if (Verbose)
+            fprintf(
+              stderr,
+              "CoverageReaderGmon::processFile - "
+              "call arc 0x%08x -> 0x%08x is not a desired symbol\n",
+              fromPC,
+              selfPC
+            );
+          break;
+
+        case GMON_TAG_BB_COUNT:
+          count = read32( gmon );
+          if (Verbose)
+            fprintf(
+              stderr,
+              "CoverageReaderGmon::processFile - "
+              "%u basic block counts skipped\n",
+              count
+            );
+          while (count--) {
+            read32( gmon );
+            read32( gmon );
+          }
+          break;
+
+        default:
+          fprintf(
+            stderr,
+            "ERROR: CoverageReaderGmon::processFile - "
+            "invalid record tag %d in %s\n",
+            tag,
+            file
+          );
+          exit( -1 );
+      }
+    }
+
+    fclose( gmon.file );
+
+    if (Verbose && unmatched)
+      fprintf(
+        stderr,
+        "CoverageReaderGmon::processFile - "
+        "%s: %u samples not in a desired symbol\n",
+        file,
+        unmatched
+      );
+  }
+}
@@ -0,0 +1,57 @@
+/*! @file CoverageReaderGmon.h
+ *  @brief CoverageReaderGmon Specification
+ *
+ *  This file contains the specification of the CoverageReaderGmon class.
+ */
+
+#ifndef __COVERAGE_READER_GMON_H__
+#define __COVERAGE_READER_GMON_H__
+
+#include "CoverageReaderBase.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*! @class CoverageReaderGmon
+   *
+   *  This class implements the functionality which reads a gprof
+   *  gmon.out profile produced by a target's profiling timer.  The PC
+   *  histogram is statistical so an instruction is only marked as
+   *  executed if it was sampled and the execution count of each
+   *  instruction is its number of samples.  The samples of a histogram
+   *  bucket are shared between the instructions that start in the
+   *  bucket.  The count of each call arc is added to the calls of the
+   *  symbol called.  Basic block count records are skipped.  The file is
+   *  in the target's byte order and the addresses are 32 bits.
+@verbatim
+char     cookie[4]     "gmon"
+uint32_t version       1
+char     spare[12]
+records                each record starts with a tag byte
+
+tag 0 histogram        uint32_t low_pc, high_pc, hist_size, prof_rate
+                       char dimen[15], dimen_abbrev
+                       uint16_t bins[hist_size]
+tag 1 call arc         uint32_t from_pc, self_pc, count
+tag 2 basic blocks     uint32_t ncounts, { uint32_t addr, count }[ncounts]
+@endverbatim
+   */
+  class CoverageReaderGmon : public CoverageReaderBase {
+
+  public:
+
+    /* Inherit documentation from base class. */
+    CoverageReaderGmon();
+
+    /* Inherit documentation from base class. */
+    virtual ~CoverageReaderGmon();
+
+    /* Inherit documentation from base class. */
+    void processFile(
+      const char* const     file,
+      ExecutableInfo* const executableInformation
+    );
+  };
+
+}
+#endif
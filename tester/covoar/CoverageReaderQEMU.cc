@@ -115,8 +115,9 @@ namespace Coverage {
       if (num_entries == 0)
         break;
 
-      // Get the coverage map for each entry.  Note that the map is
-      // the same for each entry in the coverage map
+      // Get the coverage map for each entry. The executable's address
+      // index holds the coverage maps of the executable and all its
+      // modules so the entry is attributed to the module it is in.
       for (int count=0; count<num_entries; count++) {
 
         entry = &entries[count];
@@ -129,11 +130,18 @@ namespace Coverage {
         if (!aCoverageMap)
           continue;
 
-        // Set was executed for each TRACE_OP_BLOCK
+        // Set was executed for each TRACE_OP_BLOCK. A block can fall
+        // through into the next symbol so look up each address, the
+        // index checks the last range found first.
         if (entry->op & TRACE_OP_BLOCK) {
          for (i=0; i<entry->size; i++) {
-            aCoverageMap->setWasExecuted( entry->pc + i );
+            aCoverageMap =
+              executableInformation->getCoverageMap( entry->pc + i );
+            if (aCoverageMap)
+              aCoverageMap->setWasExecuted( entry->pc + i );
           }
+          if (!aCoverageMap)
+            continue;
         }
 
         // Determine if additional branch information is available.
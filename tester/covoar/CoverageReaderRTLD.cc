@@ -0,0 +1,155 @@
+/*! @file CoverageReaderRTLD.cc
+ *  @brief CoverageReaderRTLD Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  reading the rtems-tld function coverage data files.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "app_common.h"
+#include "CoverageReaderRTLD.h"
+#include "CoverageMap.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*!
+   *  The values in the header of a rtems-tld coverage file.
+   */
+  #define RTLD_COVERAGE_MAGIC   0x52434f56
+  #define RTLD_COVERAGE_VERSION 1
+
+  static uint32_t swap32( uint32_t value )
+  {
+    return ((value & 0xff) << 24) | ((value & 0xff00) << 8) |
+           ((value >> 8) & 0xff00) | ((value >> 24) & 0xff);
+  }
+
+  CoverageReaderRTLD::CoverageReaderRTLD()
+  {
+  }
+
+  CoverageReaderRTLD::~CoverageReaderRTLD()
+  {
+  }
+
+  void CoverageReaderRTLD::processFile(
+    const char* const     file,
+    ExecutableInfo* const executableInformation
+  )
+  {
+    CoverageMapBase*                    aCoverageMap;
+    FILE*                               coverageFile;
+    uint32_t                            header[4];
+    std::vector<uint8_t>                hits;
+    std::vector<char>                   names;
+    const char*                         name;
+    uint32_t                            count;
+    uint32_t                            f;
+    uint32_t                            i;
+    SymbolTable::symbolInfo*            info;
+    SymbolTable::symbolInfoIterator_t   sitr;
+
+    //
+    // Open the coverage file and read the header.
+    //
+    coverageFile = fopen( file, "rb" );
+    if (!coverageFile) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderRTLD::processFile - Unable to open %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    if (fread( header, sizeof(header), 1, coverageFile ) != 1) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderRTLD::processFile - "
+        "Unable to read header from %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    //
+    // The file is in the target's byte order.
+    //
+    if (header[0] == swap32( RTLD_COVERAGE_MAGIC )) {
+      for (i = 0; i < 4; i++)
+        header[i] = swap32( header[i] );
+    }
+
+    if ((header[0] != RTLD_COVERAGE_MAGIC) ||
+        (header[1] != RTLD_COVERAGE_VERSION)) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderRTLD::processFile - "
+        "%s is not a rtems-tld coverage file\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    count = header[2];
+
+    hits.resize( count );
+    names.resize( header[3] + 1, '\0' );
+
+    if ((count && fread( &hits[0], count, 1, coverageFile ) != 1) ||
+        (header[3] && fread( &names[0], header[3], 1, coverageFile ) != 1)) {
+      fprintf(
+        stderr,
+        "ERROR: CoverageReaderRTLD::processFile - "
+        "Unable to read the coverage data from %s\n",
+        file
+      );
+      exit( -1 );
+    }
+
+    fclose( coverageFile );
+
+    //
+    // Map each function called to its symbols and mark the entry point
+    // as executed.
+    //
+    name = &names[0];
+    for (f = 0; f < count; f++) {
+      if (name >= &names[header[3]]) {
+        fprintf(
+          stderr,
+          "ERROR: CoverageReaderRTLD::processFile - "
+          "%s has fewer names than functions\n",
+          file
+        );
+        exit( -1 );
+      }
+
+      if (hits[f]) {
+        info = executableInformation->getSymbolTable()->getInfo( name );
+        if (info) {
+          for (sitr = info->begin(); sitr != info->end(); sitr++) {
+            aCoverageMap =
+              executableInformation->getCoverageMap( sitr->startingAddress );
+            if (aCoverageMap)
+              aCoverageMap->setWasExecuted( sitr->startingAddress );
+          }
+        } else if (Verbose) {
+          fprintf(
+            stderr,
+            "CoverageReaderRTLD::processFile - %s is not a desired symbol\n",
+            name
+          );
+        }
+      }
+
+      name += strlen( name ) + 1;
+    }
+  }
+}
@@ -0,0 +1,50 @@
+/*! @file CoverageReaderRTLD.h
+ *  @brief CoverageReaderRTLD Specification
+ *
+ *  This file contains the specification of the CoverageReaderRTLD class.
+ */
+
+#ifndef __COVERAGE_READER_RTLD_H__
+#define __COVERAGE_READER_RTLD_H__
+
+#include "CoverageReaderBase.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*! @class CoverageReaderRTLD
+   *
+   *  This class implements the functionality which reads a function
+   *  coverage file produced by an executable linked with the rtems-tld
+   *  coverage generator.  The file holds a hit flag for each wrapped
+   *  function and the function names in trace index order.  Only the
+   *  entry point of each called function is marked as executed so the
+   *  reports are function-level.
+@verbatim
+uint32_t magic         0x52434f56 ('RCOV') in the target's byte order
+uint32_t version       1
+uint32_t count         number of functions
+uint32_t names_size    size of the names in bytes
+uint8_t  hits[count]   non-zero if the function was called
+char     names[]       count nul terminated function names
+@endverbatim
+   */
+  class CoverageReaderRTLD : public CoverageReaderBase {
+
+  public:
+
+    /* Inherit documentation from base class. */
+    CoverageReaderRTLD();
+
+    /* Inherit documentation from base class. */
+    virtual ~CoverageReaderRTLD();
+
+    /* Inherit documentation from base class. */
+    void processFile(
+      const char* const     file,
+      ExecutableInfo* const executableInformation
+    );
+  };
+
+}
+#endif
@@ -155,6 +155,7 @@ namespace Coverage {
 
       // Increment the total sizeInBytes byt the bytes in the symbol
       stats.sizeInBytes += sitr->second.stats.sizeInBytes;
+      stats.calls += sitr->second.stats.calls;
 
       // Now scan through the coverage map of this symbol.
       endAddress = sitr->second.stats.sizeInBytes - 1;
@@ -168,6 +169,9 @@ namespace Coverage {
           stats.sizeInInstructions++;
           sitr->second.stats.sizeInInstructions++;
 
+          stats.samples += theCoverageMap->getWasExecuted( a );
+          sitr->second.stats.samples += theCoverageMap->getWasExecuted( a );
+
           if (!theCoverageMap->wasExecuted( a ) ) {
             stats.uncoveredInstructions++;
             sitr->second.stats.uncoveredInstructions++;
@@ -77,6 +77,19 @@ namespace Coverage {
      */
     int uncoveredRanges;
 
+    /*!
+     *  This member variable contains the total of the execution counts
+     *  of the instructions. The counts are the samples of a sampled
+     *  profile.
+     */
+    uint32_t samples;
+
+    /*!
+     *  This member variable contains the total number of calls recorded
+     *  in the call arcs of a sampled profile.
+     */
+    uint32_t calls;
+
     /*!
      *  This method returns the percentage of uncovered instructions.
      *
@@ -103,7 +116,9 @@ namespace Coverage {
        sizeInInstructions(0),
        uncoveredBytes(0),
        uncoveredInstructions(0),
-       uncoveredRanges(0)
+       uncoveredRanges(0),
+       samples(0),
+       calls(0)
      {
      }
 
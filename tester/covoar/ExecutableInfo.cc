@@ -6,6 +6,10 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
 
 #include "ExecutableInfo.h"
 #include "app_common.h"
@@ -15,6 +19,14 @@
 
 namespace Coverage {
 
+  bool ExecutableInfo::addressIndexCompare(
+    const ExecutableInfo::addressIndexEntry_t& lhs,
+    const ExecutableInfo::addressIndexEntry_t& rhs
+  )
+  {
+    return lhs.lowAddress < rhs.lowAddress;
+  }
+
   ExecutableInfo::ExecutableInfo(
     const char* const theExecutableName,
     const char* const theLibraryName
@@ -26,14 +38,98 @@ namespace Coverage {
     if (theLibraryName)
       libraryName = theLibraryName;
     theSymbolTable = new SymbolTable();
+    addressIndexDirty = true;
+    lastIndexEntry = 0;
+    owner = NULL;
   }
 
   ExecutableInfo::~ExecutableInfo()
   {
+    modules_t::iterator itr;
+
+    for (itr = modules.begin(); itr != modules.end(); itr++)
+      delete *itr;
     if (theSymbolTable)
       delete theSymbolTable;
   }
 
+  void ExecutableInfo::addModule( ExecutableInfo* const theModule )
+  {
+    theModule->owner = this;
+    modules.push_back( theModule );
+    addressIndexDirty = true;
+  }
+
+  void ExecutableInfo::addToAddressIndex( ExecutableInfo& theInfo )
+  {
+    coverageMaps_t::iterator     itr;
+    SymbolTable::symbolInfo*     symbolInfo;
+    SymbolTable::symbolInfoIterator_t sitr;
+    addressIndexEntry_t          entry;
+
+    for (itr = theInfo.coverageMaps.begin();
+         itr != theInfo.coverageMaps.end();
+         itr++) {
+      symbolInfo = theInfo.theSymbolTable->getInfo( itr->first );
+      if (!symbolInfo)
+        continue;
+      for (sitr = symbolInfo->begin(); sitr != symbolInfo->end(); sitr++) {
+        if (sitr->length == 0)
+          continue;
+        entry.lowAddress = sitr->startingAddress;
+        entry.highAddress = sitr->startingAddress + sitr->length - 1;
+        entry.map = itr->second;
+        addressIndex.push_back( entry );
+      }
+    }
+  }
+
+  void ExecutableInfo::buildAddressIndex( void )
+  {
+    modules_t::iterator      itr;
+    addressIndex_t::iterator aitr;
+    addressIndex_t::iterator last;
+
+    addressIndex.clear();
+    lastIndexEntry = 0;
+
+    addToAddressIndex( *this );
+    for (itr = modules.begin(); itr != modules.end(); itr++)
+      addToAddressIndex( *(*itr) );
+
+    std::stable_sort(
+      addressIndex.begin(), addressIndex.end(), addressIndexCompare
+    );
+
+    // Remove the ranges that overlap a range before them. The modules
+    // should not overlap so report it.
+    last = addressIndex.begin();
+    for (aitr = addressIndex.begin(); aitr != addressIndex.end(); aitr++) {
+      if ((aitr != addressIndex.begin()) &&
+          (aitr->lowAddress <= last->highAddress)) {
+        if (aitr->map != last->map)
+          fprintf(
+            stderr,
+            "WARNING: ExecutableInfo::buildAddressIndex - "
+            "0x%08x-0x%08x overlaps 0x%08x-0x%08x in %s\n",
+            aitr->lowAddress,
+            aitr->highAddress,
+            last->lowAddress,
+            last->highAddress,
+            executableName.c_str()
+          );
+        continue;
+      }
+      if (aitr != addressIndex.begin())
+        last++;
+      *last = *aitr;
+    }
+    if (!addressIndex.empty())
+      addressIndex.erase( last + 1, addressIndex.end() );
+
+    addressIndexDirty = false;
+  }
+
   void ExecutableInfo::dumpCoverageMaps( void ) {
     ExecutableInfo::coverageMaps_t::iterator  itr;
 
@@ -49,22 +145,47 @@ namespace Coverage {
     fprintf( stdout, "libraryName = %s\n", libraryName.c_str());
     fprintf( stdout, "loadAddress = %u\n", loadAddress);
     theSymbolTable->dumpSymbolTable();
+    for (modules_t::iterator itr = modules.begin();
+         itr != modules.end();
+         itr++)
+      (*itr)->dumpExecutableInfo();
   }
 
   CoverageMapBase* ExecutableInfo::getCoverageMap ( uint32_t address )
   {
-    CoverageMapBase*         aCoverageMap = NULL;
-    coverageMaps_t::iterator it;
-    std::string              itsSymbol;
+    size_t low;
+    size_t high;
+    size_t mid;
+
+    if (addressIndexDirty)
+      buildAddressIndex();
 
-    // Obtain the coverage map containing the specified address.
-    itsSymbol = theSymbolTable->getSymbol( address );
-    if (itsSymbol != "") {
-      it = coverageMaps.find( itsSymbol );
-      aCoverageMap = (*it).second;
+    if (addressIndex.empty())
+      return NULL;
+
+    // Check the last range found.
+    if ((address >= addressIndex[ lastIndexEntry ].lowAddress) &&
+        (address <= addressIndex[ lastIndexEntry ].highAddress))
+      return addressIndex[ lastIndexEntry ].map;
+
+    // Find the first range starting after the address. The range before
+    // it may contain the address.
+    low = 0;
+    high = addressIndex.size();
+    while (low < high) {
+      mid = low + ((high - low) / 2);
+      if (addressIndex[ mid ].lowAddress <= address)
+        low = mid + 1;
+      else
+        high = mid;
     }
 
-    return aCoverageMap;
+    if ((low > 0) && (address <= addressIndex[ low - 1 ].highAddress)) {
+      lastIndexEntry = low - 1;
+      return addressIndex[ lastIndexEntry ].map;
+    }
+
+    return NULL;
   }
 
   std::string ExecutableInfo::getFileName ( void ) const
@@ -83,6 +204,11 @@ namespace Coverage {
   }
 
 
+  ExecutableInfo::modules_t& ExecutableInfo::getModules( void )
+  {
+    return modules;
+  }
+
   SymbolTable* ExecutableInfo::getSymbolTable ( void ) const
   {
     return theSymbolTable;
@@ -106,6 +232,9 @@ namespace Coverage {
       theMap = itr->second;
       theMap->Add( lowAddress, highAddress );
     }
+    addressIndexDirty = true;
+    if (owner)
+      owner->addressIndexDirty = true;
     return theMap;
   }
 
@@ -114,12 +243,74 @@ namespace Coverage {
      return (libraryName != "");
   }
 
+  void ExecutableInfo::loadModuleManifest( const char* const manifestName )
+  {
+    FILE*           manifest;
+    char*           cStatus;
+    char*           name;
+    char*           address;
+    char*           end;
+    ExecutableInfo* theModule;
+
+    manifest = fopen( manifestName, "r" );
+    if (!manifest) {
+      fprintf(
+        stderr,
+        "ERROR: ExecutableInfo::loadModuleManifest - Unable to open %s\n",
+        manifestName
+      );
+      exit( -1 );
+    }
+
+    while (1) {
+      cStatus = fgets( inputBuffer, MAX_LINE_LENGTH, manifest );
+      if (cStatus == NULL)
+        break;
+
+      name = strtok( inputBuffer, " \t\r\n" );
+      if ((name == NULL) || (*name == '#'))
+        continue;
+
+      address = strtok( NULL, " \t\r\n" );
+      if (address == NULL) {
+        fprintf(
+          stderr,
+          "ERROR: ExecutableInfo::loadModuleManifest - "
+          "no load address for %s in %s\n",
+          name,
+          manifestName
+        );
+        exit( -1 );
+      }
+
+      theModule = new ExecutableInfo( executableName.c_str(), name );
+      theModule->setLoadAddress( strtoul( address, &end, 16 ) );
+      if (*end != '\0') {
+        fprintf(
+          stderr,
+          "ERROR: ExecutableInfo::loadModuleManifest - "
+          "invalid load address %s for %s in %s\n",
+          address,
+          name,
+          manifestName
+        );
+        exit( -1 );
+      }
+      addModule( theModule );
+    }
+
+    fclose( manifest );
+  }
+
   void ExecutableInfo::mergeCoverage( void ) {
     ExecutableInfo::coverageMaps_t::iterator  itr;
+    modules_t::iterator                       mitr;
 
     for (itr = coverageMaps.begin(); itr != coverageMaps.end(); itr++) {
       SymbolsToAnalyze->mergeCoverageMap( (*itr).first, (*itr).second );
     }
+    for (mitr = modules.begin(); mitr != modules.end(); mitr++)
+      (*mitr)->mergeCoverage();
   }
 
   void ExecutableInfo::setLoadAddress( uint32_t address )
@@ -7,9 +7,11 @@
 #ifndef __EXECUTABLEINFO_H__
 #define __EXECUTABLEINFO_H__
 
+#include <list>
 #include <map>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include "CoverageMapBase.h"
 #include "SymbolTable.h"
@@ -25,6 +27,11 @@ namespace Coverage {
 
   public:
 
+    /*!
+     *  This type defines the modules loaded by an executable.
+     */
+    typedef std::list<ExecutableInfo*> modules_t;
+
     /*!
      *  This method constructs an ExecutableInfo instance.
      *
@@ -41,6 +48,16 @@ namespace Coverage {
      */
     virtual ~ExecutableInfo();
 
+    /*!
+     *  This method adds a module loaded by the executable. The module's
+     *  coverage maps are found by getCoverageMap with the executable's
+     *  so a single pass over the coverage data covers all modules. The
+     *  executable owns the module and deletes it.
+     *
+     *  @param[in] theModule specifies the module's information
+     */
+    void addModule( ExecutableInfo* const theModule );
+
     /*!
      *  This method prints the contents of all coverage maps for
      *  this executable.
@@ -53,8 +70,9 @@ namespace Coverage {
     void dumpExecutableInfo( void );
 
     /*!
-     *  This method returns a pointer to the executable's coverage map
-     *  that contains the specified address.
+     *  This method returns a pointer to the executable's or a module's
+     *  coverage map that contains the specified address. The address is
+     *  found in a sorted index of the address ranges of all coverage maps.
      *
      *  @param[in] address specifies the desired address
      *
@@ -83,6 +101,13 @@ namespace Coverage {
      */
     uint32_t getLoadAddress( void ) const;
 
+    /*!
+     *  This method returns the modules loaded by the executable.
+     *
+     *  @return Returns the modules
+     */
+    modules_t& getModules( void );
+
     /*!
      *  This method returns a pointer to the executable's symbol table.
      *
@@ -116,8 +141,18 @@ namespace Coverage {
     bool hasDynamicLibrary( void );
 
     /*!
-     *  This method merges the coverage maps for this executable into
-     *  the unified coverage map.
+     *  This method loads a manifest of the modules loaded by the
+     *  executable. Each line of the manifest is a module's file name and
+     *  its load address in hex, the format of a .dlinfo file. Blank lines
+     *  and lines starting with '#' are ignored.
+     *
+     *  @param[in] manifestName specifies the name of the manifest
+     */
+    void loadModuleManifest( const char* const manifestName );
+
+    /*!
+     *  This method merges the coverage maps for this executable and its
+     *  modules into the unified coverage map.
      */
     void mergeCoverage( void );
 
@@ -131,12 +166,60 @@ namespace Coverage {
 
   private:
 
+    /*!
+     *  This method adds the address ranges of the coverage maps of an
+     *  executable or module to the address index.
+     */
+    void addToAddressIndex( ExecutableInfo& theInfo );
+
+    /*!
+     *  This type defines an address range of a coverage map.
+     */
+    typedef struct {
+      uint32_t         lowAddress;
+      uint32_t         highAddress;
+      CoverageMapBase* map;
+    } addressIndexEntry_t;
+
+    /*!
+     *  This method orders the address index by the low address.
+     */
+    static bool addressIndexCompare(
+      const addressIndexEntry_t& lhs,
+      const addressIndexEntry_t& rhs
+    );
+
+    /*!
+     *  This method builds the sorted address index.
+     */
+    void buildAddressIndex( void );
+
     /*!
      *  This map associates a symbol with its coverage map.
      */
     typedef std::map<std::string, CoverageMapBase *> coverageMaps_t;
     coverageMaps_t coverageMaps;
 
+    /*!
+     *  This member variable contains the address ranges of the coverage
+     *  maps of the executable and its modules sorted by address. The ranges
+     *  do not overlap.
+     */
+    typedef std::vector<addressIndexEntry_t> addressIndex_t;
+    addressIndex_t addressIndex;
+
+    /*!
+     *  This member variable indicates the address index needs to be
+     *  built because a coverage map or module has been added.
+     */
+    bool addressIndexDirty;
+
+    /*!
+     *  This member variable contains the last entry of the address index
+     *  found. Trace data has locality so it is checked first.
+     */
+    size_t lastIndexEntry;
+
     /*!
      *  This member variable contains the name of the executable.
      */
@@ -154,6 +237,17 @@ namespace Coverage {
      */
     uint32_t loadAddress;
 
+    /*!
+     *  This member variable contains the modules loaded by the executable.
+     */
+    modules_t modules;
+
+    /*!
+     *  This member variable contains a pointer to the executable that
+     *  loaded this module or NULL if this is not a module.
+     */
+    ExecutableInfo* owner;
+
     /*!
      *  This member variable contains a pointer to the symbol table
      *  of the executable or library.
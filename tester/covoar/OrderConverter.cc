@@ -0,0 +1,233 @@
+/*! @file OrderConverter.cc
+ *  @brief Coverage to Function Order Converter
+ *
+ *  This file contains the implementation of a program that reads the
+ *  symbol summary report written by covoar and writes a function order
+ *  file for rtems-ld's --function-order option. Each function's weight is
+ *  the number of bytes of the function executed. Functions that are never
+ *  executed have a weight of 0 and are placed last in the text section.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+char* progname;
+
+/*!
+ *  This type defines the weight of a function.
+ */
+typedef struct {
+  std::string  name;
+  unsigned int weight;
+  unsigned int position;
+} FunctionWeight_t;
+
+typedef std::vector<FunctionWeight_t> FunctionWeights_t;
+
+/*!
+ *  This method orders the functions with the highest weight first, and
+ *  the report order if the weights are equal.
+ */
+static bool FunctionWeightCompare(
+  const FunctionWeight_t& lhs,
+  const FunctionWeight_t& rhs
+)
+{
+  if ( lhs.weight != rhs.weight )
+    return lhs.weight > rhs.weight;
+  return lhs.position < rhs.position;
+}
+
+void usage()
+{
+  fprintf(
+    stderr,
+    "Usage: %s [-v] -s symbolSummary.txt -o orderfile\n",
+    progname
+  );
+  exit(1);
+}
+
+/*!
+ *  This method returns the value of a report line if the line is the
+ *  field.
+ */
+static const char* FieldValue(
+  const char* line,
+  const char* field
+)
+{
+  size_t      length = strlen( field );
+  const char* value;
+
+  if ( strncmp( line, field, length ) != 0 )
+    return NULL;
+
+  value = line + length;
+  while ( *value == ' ' )
+    value++;
+  if ( *value != ':' )
+    return NULL;
+  value++;
+  while ( *value == ' ' )
+    value++;
+
+  return value;
+}
+
+/*!
+ *  This method adds the function being read to the weights.
+ */
+static void AddFunction(
+  FunctionWeights_t& weights,
+  std::string&       name,
+  unsigned int       size,
+  double             uncovered
+)
+{
+  FunctionWeight_t function;
+  double           executed;
+
+  if ( name.empty() )
+    return;
+
+  executed = (size * (100.0 - uncovered)) / 100.0;
+
+  function.name = name;
+  function.position = weights.size();
+  if ( executed <= 0.0 )
+    function.weight = 0;
+  else if ( executed < 1.0 )
+    function.weight = 1;
+  else
+    function.weight = (unsigned int) (executed + 0.5);
+
+  weights.push_back( function );
+
+  name.clear();
+}
+
+int main(
+  int    argc,
+  char** argv
+)
+{
+  int                opt;
+  const char*        summaryFile = NULL;
+  const char*        orderFile = NULL;
+  bool               verbose = false;
+  FILE*              in;
+  FILE*              out;
+  char               line[1024];
+  FunctionWeights_t  weights;
+  std::string        name;
+  unsigned int       size = 0;
+  double             uncovered = 100.0;
+  unsigned int       hot = 0;
+
+  progname = argv[0];
+
+  while ( (opt = getopt( argc, argv, "s:o:v" )) != -1 ) {
+    switch( opt ) {
+      case 's': summaryFile = optarg; break;
+      case 'o': orderFile = optarg;   break;
+      case 'v': verbose = true;       break;
+      default:  usage();
+    }
+  }
+
+  if ( !summaryFile ) {
+    fprintf( stderr, "symbol summary file not specified\n" );
+    usage();
+  }
+  if ( !orderFile ) {
+    fprintf( stderr, "output order file not specified\n" );
+    usage();
+  }
+
+  in = fopen( summaryFile, "r" );
+  if ( !in ) {
+    fprintf(
+      stderr,
+      "ERROR: OrderConverter - Unable to open %s\n",
+      summaryFile
+    );
+    exit(-1);
+  }
+
+  /*
+   *  Each symbol in the summary is a block of fields. The symbol's weight
+   *  is added when the next symbol starts or at the end of the file.
+   */
+  while ( fgets( line, sizeof( line ), in ) ) {
+    const char* value;
+    size_t      length = strlen( line );
+
+    while ( length && ((line[length - 1] == '\n') || (line[length - 1] == '\r')) )
+      line[--length] = '\0';
+
+    if ( (value = FieldValue( line, "Symbol" )) != NULL ) {
+      AddFunction( weights, name, size, uncovered );
+      name = value;
+      size = 0;
+      uncovered = 100.0;
+    } else if ( (value = FieldValue( line, "Total Size in Bytes" )) != NULL ) {
+      size = strtoul( value, NULL, 10 );
+    } else if ( (value = FieldValue( line, "Percentage Uncovered Bytes" )) != NULL ) {
+      uncovered = strtod( value, NULL );
+    }
+  }
+
+  AddFunction( weights, name, size, uncovered );
+
+  fclose( in );
+
+  std::stable_sort( weights.begin(), weights.end(), FunctionWeightCompare );
+
+  out = fopen( orderFile, "w" );
+  if ( !out ) {
+    fprintf(
+      stderr,
+      "ERROR: OrderConverter - Unable to open %s\n",
+      orderFile
+    );
+    exit(-1);
+  }
+
+  fprintf( out, "# Function order generated from %s\n", summaryFile );
+  fprintf( out, "# name weight, a weight of 0 is never executed\n" );
+
+  for ( FunctionWeights_t::iterator it = weights.begin();
+        it != weights.end();
+        it++ ) {
+    fprintf( out, "%s %u\n", it->name.c_str(), it->weight );
+    if ( it->weight )
+      hot++;
+  }
+
+  if ( fclose( out ) != 0 ) {
+    fprintf(
+      stderr,
+      "ERROR: OrderConverter - Unable to write %s\n",
+      orderFile
+    );
+    exit(-1);
+  }
+
+  if ( verbose )
+    fprintf(
+      stderr,
+      "%s: functions: %zu executed: %u\n",
+      orderFile,
+      weights.size(),
+      hot
+    );
+
+  return 0;
+}
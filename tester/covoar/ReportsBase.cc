@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <algorithm>
+#include <vector>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -13,6 +15,7 @@
 
 #include "ReportsText.h"
 #include "ReportsHtml.h"
+#include "ReportsLcov.h"
 
 #if WIN32
 #include <direct.h>
@@ -20,17 +23,17 @@
 
 namespace Coverage {
 
-ReportsBase::ReportsBase( time_t timestamp ):
+ReportsFile::ReportsFile( time_t timestamp ):
   reportExtension_m(""),
   timestamp_m( timestamp )
 {
 }
 
-ReportsBase::~ReportsBase()
+ReportsFile::~ReportsFile()
 {
 }
 
-FILE* ReportsBase::OpenFile(
+FILE* ReportsFile::OpenFile(
   const char* const fileName
 )
 {
@@ -61,6 +64,29 @@ FILE* ReportsBase::OpenFile(
   return aFile;
 }
 
+// Function-level coverage only marks the entry point of each function
+// so note it at the start of the reports that show the instructions.
+static void PutFunctionCoverageNote(
+  FILE* aFile
+)
+{
+  if ( aFile && FunctionCoverageOnly )
+    fprintf(
+      aFile,
+      "Function-level coverage: only the entry point of each called "
+      "function is marked as executed.\n\n"
+    );
+}
+
+ReportsBase::ReportsBase( time_t timestamp ):
+  ReportsFile( timestamp )
+{
+}
+
+ReportsBase::~ReportsBase()
+{
+}
+
 void ReportsBase::WriteIndex(
   const char* const fileName
 )
@@ -71,7 +97,9 @@ FILE* ReportsBase::OpenAnnotatedFile(
   const char* const fileName
 )
 {
-  return OpenFile(fileName);
+  FILE* aFile = OpenFile(fileName);
+  PutFunctionCoverageNote(aFile);
+  return aFile;
 }
 
 FILE* ReportsBase::OpenBranchFile(
@@ -79,14 +107,18 @@ FILE* ReportsBase::OpenBranchFile(
   bool              hasBranches
 )
 {
-  return OpenFile(fileName);
+  FILE* aFile = OpenFile(fileName);
+  PutFunctionCoverageNote(aFile);
+  return aFile;
 }
 
 FILE* ReportsBase::OpenCoverageFile(
   const char* const fileName
 )
 {
-  return OpenFile(fileName);
+  FILE* aFile = OpenFile(fileName);
+  PutFunctionCoverageNote(aFile);
+  return aFile;
 }
 
 FILE* ReportsBase::OpenNoRangeFile(
@@ -111,7 +143,14 @@ FILE* ReportsBase::OpenSymbolSummaryFile(
   return OpenFile(fileName);
 }
 
-void ReportsBase::CloseFile(
+FILE* ReportsBase::OpenHotSpotFile(
+  const char* const fileName
+)
+{
+  return OpenFile(fileName);
+}
+
+void ReportsFile::CloseFile(
   FILE*  aFile
 )
 {
@@ -161,6 +200,13 @@ void  ReportsBase::CloseSymbolSummaryFile(
   CloseFile( aFile );
 }
 
+void  ReportsBase::CloseHotSpotFile(
+  FILE*  aFile
+)
+{
+  CloseFile( aFile );
+}
+
 /*
  *  Write annotated report
  */
@@ -431,6 +477,81 @@ void ReportsBase::WriteSymbolSummaryReport(
   CloseSymbolSummaryFile( report );
 }
 
+/*
+ *  Order the hot spots by the samples with the most samples first.
+ */
+static bool HotSpotCompare(
+  const Coverage::DesiredSymbols::symbolSet_t::iterator& lhs,
+  const Coverage::DesiredSymbols::symbolSet_t::iterator& rhs
+)
+{
+  return lhs->second.stats.samples > rhs->second.stats.samples;
+}
+
+void ReportsBase::WriteHotSpotReport(
+  const char* const fileName
+)
+{
+  typedef std::vector<Coverage::DesiredSymbols::symbolSet_t::iterator>
+    hotSpots_t;
+
+  Coverage::DesiredSymbols::symbolSet_t::iterator                ditr;
+  hotSpots_t                                                     hotSpots;
+  hotSpots_t::iterator                                           hitr;
+  FILE*                                                          report;
+  Coverage::CoverageMapBase*                                     theCoverageMap;
+  std::list<Coverage::ObjdumpProcessor::objdumpLine_t>::iterator itr;
+  const Coverage::ObjdumpProcessor::objdumpLine_t*               hottest;
+  uint32_t                                                       hottestSamples;
+  uint32_t                                                       samples;
+  unsigned int                                                   count;
+
+  // Open the report file.
+  report = OpenHotSpotFile( fileName );
+  if ( !report ) {
+    return;
+  }
+
+  // Find the symbols that were sampled or called.
+  for (ditr = SymbolsToAnalyze->set.begin();
+       ditr != SymbolsToAnalyze->set.end();
+       ditr++) {
+    if (ditr->second.unifiedCoverageMap &&
+        (ditr->second.stats.samples || ditr->second.stats.calls))
+      hotSpots.push_back( ditr );
+  }
+
+  std::stable_sort( hotSpots.begin(), hotSpots.end(), HotSpotCompare );
+
+  // Process each hot spot and find its instruction with the most samples.
+  count = 0;
+  for (hitr = hotSpots.begin(); hitr != hotSpots.end(); hitr++) {
+    ditr = *hitr;
+    theCoverageMap = ditr->second.unifiedCoverageMap;
+    hottest = NULL;
+    hottestSamples = 0;
+
+    for (itr = ditr->second.instructions.begin();
+         itr != ditr->second.instructions.end();
+         itr++) {
+      if (itr->isInstruction) {
+        samples = theCoverageMap->getWasExecuted(
+          itr->address - ditr->second.baseAddress
+        );
+        if (samples > hottestSamples) {
+          hottest = &(*itr);
+          hottestSamples = samples;
+        }
+      }
+    }
+
+    PutHotSpotLine( report, count, ditr, hottest, hottestSamples );
+    count++;
+  }
+
+  CloseHotSpotFile( report );
+}
+
 void  ReportsBase::WriteSummaryReport(
   const char* const fileName
 )
@@ -443,6 +564,8 @@ void  ReportsBase::WriteSummaryReport(
   double                                          percentage;
   Coverage::CoverageMapBase*                      theCoverageMap;
   uint32_t                                        totalBytes = 0;
+  uint32_t                                        totalFunctions = 0;
+  uint32_t                                        notEntered = 0;
   FILE*                                           report;
 
   // Open the report file.
@@ -461,6 +584,10 @@ void  ReportsBase::WriteSummaryReport(
     theCoverageMap = itr->second.unifiedCoverageMap;
     if (theCoverageMap) {
 
+      totalFunctions++;
+      if (!theCoverageMap->wasExecuted( 0 ))
+        notEntered++;
+
       endAddress = itr->second.stats.sizeInBytes - 1;
 
       for (a = 0; a <= endAddress; a++) {
@@ -471,6 +598,23 @@ void  ReportsBase::WriteSummaryReport(
     }
   }
 
+  // Function-level coverage only marks the entry point of each function
+  // so report the functions entered rather than the bytes executed.
+  if (FunctionCoverageOnly) {
+    percentage = (double) notEntered;
+    percentage /= (double) totalFunctions;
+    percentage *= 100.0;
+
+    fprintf( report, "Coverage Level           : function (entry only)\n" );
+    fprintf( report, "Functions Analyzed       : %d\n", totalFunctions );
+    fprintf( report, "Functions Not Entered    : %d\n", notEntered );
+    fprintf( report, "Percentage Entered       : %5.4g\n", 100.0 - percentage );
+    fprintf( report, "Percentage Not Entered   : %5.4g\n", percentage );
+    fprintf( report, "No instruction or branch information available\n" );
+    CloseFile( report );
+    return;
+  }
+
   percentage = (double) notExecuted;
   percentage /= (double) totalBytes;
   percentage *= 100.0;
@@ -574,6 +718,15 @@ void GenerateReports()
         stderr, "Generate %s\n", reportName.c_str()
       );
     reports->WriteSymbolSummaryReport(reportName.c_str() );
+
+    if (SampledCoverage) {
+      reportName = "hotSpots" + reports->ReportExtension();
+      if (Verbose)
+        fprintf(
+          stderr, "Generate %s\n", reportName.c_str()
+        );
+      reports->WriteHotSpotReport(reportName.c_str() );
+    }
   }
 
   for (ritr = reportList.begin(); ritr != reportList.end(); ritr++ ) {
@@ -581,6 +734,17 @@ void GenerateReports()
     delete reports;
   }
 
+  if (LcovTraceFile) {
+    ReportsLcov* lcov = new ReportsLcov(timestamp);
+    reportName = "coverage" + lcov->ReportExtension();
+    if (Verbose)
+      fprintf(
+        stderr, "Generate %s\n", reportName.c_str()
+      );
+    lcov->WriteTraceFile( reportName.c_str() );
+    delete lcov;
+  }
+
   ReportsBase::WriteSummaryReport( "summary.txt" );
 }
 
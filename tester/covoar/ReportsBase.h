@@ -16,12 +16,62 @@
 
 namespace Coverage {
 
+/*!
+ *   This class contains the report files in the output directory.  It is
+ *   the base of the report sets and of the reports that are not part of a
+ *   set such as the lcov tracefile.
+ */
+class ReportsFile {
+
+  public:
+    ReportsFile( time_t timestamp );
+    virtual ~ReportsFile();
+
+    /*!
+     *  This method returns the unique extension for the Report
+     *  type.  If the extension is ".txt" files will be 
+     *  named "annotated.txt", "branch.txt" ......
+     */
+    std::string ReportExtension() { return reportExtension_m; }
+
+  protected:
+
+    /*!
+     *  This member variable contains the extension used for all reports.
+     */
+    std::string reportExtension_m;
+
+    /*!
+     *  This member variable contains the timestamp for the report.
+     */
+    time_t timestamp_m;
+
+    /*!
+     *  This method Opens a report file and verifies that it opened
+     *  correctly.  Upon failure NULL is returned.
+     *
+     *  @param[in] fileName identifies the report file name
+     */
+     static FILE* OpenFile(
+      const char* const fileName
+    );
+
+    /*!
+     *  This method Closes a report file. 
+     *
+     *  @param[in] aFile identifies the report file name
+     */
+    static void CloseFile(
+      FILE*  aFile
+    );
+};
+
 /*!
  *   This class contains the base information to create a report 
  *   set.  The report set may be text based, html based or some
  *   other format to be defined at a future time.
  */
-class ReportsBase {
+class ReportsBase: public ReportsFile {
 
   public:
     ReportsBase( time_t timestamp );
@@ -87,18 +137,21 @@ class ReportsBase {
     );
 
     /*!
-     *  This method produces a sumary report for the overall test run.
+     *  This method produces a report of the symbols of a sampled profile
+     *  with the symbol with the most samples first.
+     *
+     *  @param[in] fileName identifies the report file name
      */
-    static void  WriteSummaryReport(
+    void WriteHotSpotReport(
       const char* const fileName
     );
 
     /*!
-     *  This method returns the unique extension for the Report
-     *  type.  If the extension is ".txt" files will be 
-     *  named "annotated.txt", "branch.txt" ......
+     *  This method produces a sumary report for the overall test run.
      */
-    std::string ReportExtension() { return reportExtension_m; }
+    static void  WriteSummaryReport(
+      const char* const fileName
+    );
 
   protected:
 
@@ -113,26 +166,6 @@ class ReportsBase {
       A_BRANCH_NOT_TAKEN
     } AnnotatedLineState_t;
 
-    /*!
-     *  This member variable contains the extension used for all reports.
-     */
-    std::string reportExtension_m;
-
-    /*!
-     *  This member variable contains the timestamp for the report.
-     */
-    time_t timestamp_m;
-
-    /*!
-     *  This method Opens a report file and verifies that it opened
-     *  correctly.  Upon failure NULL is returned.
-     *
-     *  @param[in] fileName identifies the report file name
-     */
-     static FILE* OpenFile(
-      const char* const fileName
-    );
-
     /*!
      *  This method opens a report file and verifies that it opened.
      *  Then appedns any necessary header information onto the file.
@@ -196,12 +229,13 @@ class ReportsBase {
     );
 
     /*!
-     *  This method Closes a report file. 
+     *  This method opens a report file and verifies that it opened.
+     *  Then appends any necessary header information onto the file.
      *
-     *  @param[in] aFile identifies the report file name
+     *  @param[in] fileName identifies the report file name
      */
-    static void CloseFile(
-      FILE*  aFile
+    virtual FILE* OpenHotSpotFile(
+      const char* const fileName
     );
 
     /*!
@@ -266,6 +300,16 @@ class ReportsBase {
       FILE*  aFile
     );
 
+    /*!
+     *  This method puts any necessary footer information into
+     *  the report then closes the file.
+     *
+     *  @param[in] aFile identifies the report file name
+     */
+    virtual void CloseHotSpotFile(
+      FILE*  aFile
+    );
+
     /*!
      *  This method puts any necessary a line of annotated
      *  data into the file.
@@ -385,6 +429,23 @@ class ReportsBase {
       unsigned int                                    number,
       Coverage::DesiredSymbols::symbolSet_t::iterator symbol
     )=0;
+
+    /*!
+     *  This method method puts a line into the hot spot report.
+     *
+     *  @param[in] report identifies the report file name
+     *  @param[in] number identifies the line number.
+     *  @param[in] symbol is a pointer to the symbol information
+     *  @param[in] hottest is the instruction with the most samples
+     *  @param[in] hottestSamples is the number of samples of hottest
+     */
+    virtual bool PutHotSpotLine(
+      FILE*                                           report,
+      unsigned int                                    number,
+      Coverage::DesiredSymbols::symbolSet_t::iterator symbol,
+      const ObjdumpProcessor::objdumpLine_t*          hottest,
+      uint32_t                                        hottestSamples
+    )=0;
 };
 
 /*!
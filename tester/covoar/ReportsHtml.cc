@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,25 +10,6 @@
 #include "DesiredSymbols.h"
 #include "ObjdumpProcessor.h"
 
-#if 0
-#define TABLE_HEADER_CLASS \
-  " table-autopage:10 table-page-number:pagenum table-page-count:pages "
-#define TABLE_FOOTER \
-   "<tfoot>\n" \
-   "<tr>\n" \
-   "<td class=\"table-page:previous\" " \
-      "style=\"cursor:pointer;\">&lt; &lt; Previous</td>\n" \
-   "<td colspan=\"4\" style=\"text-align:center;\">Page " \
-      "<span id=\"pagenum\"></span>&nbsp;of <span id=\"pages\"></span></td>\n" \
-   "<td class=\"table-page:next\" " \
-     "style=\"cursor:pointer;\">Next &gt; &gt;</td>\n" \
-   "</tr>\n" \
-   "</tfoot>\n"
-#else
-#define TABLE_HEADER_CLASS
-#define TABLE_FOOTER 
-#endif
-
 namespace Coverage {
 
   ReportsHtml::ReportsHtml( time_t timestamp ):
@@ -39,6 +22,20 @@ namespace Coverage {
   {
   }
 
+  // Function-level coverage only marks the entry point of each function
+  // so note it at the start of the index and the instruction reports.
+  static void PutFunctionCoverageNote(
+    FILE* aFile
+  )
+  {
+    if (FunctionCoverageOnly)
+      fprintf(
+        aFile,
+        "<p>Function-level coverage: only the entry point of each called "
+        "function is marked as executed.</p>\n"
+      );
+  }
+
   void ReportsHtml::WriteIndex(
     const char* const fileName
   )
@@ -75,11 +72,14 @@ namespace Coverage {
 
     fprintf(
       aFile,
-      "Coverage Analysis Reports</div>\n"
+      "%sCoverage Analysis Reports</div>\n"
       "<div class =\"datetime\">%s</div>\n",
+      FunctionCoverageOnly ? "Function-Level " : "",
       asctime( localtime(&timestamp_m) ) 
     );
 
+    PutFunctionCoverageNote( aFile );
+
     fprintf( aFile, "<ul>\n" );
 
     PRINT_TEXT_ITEM( "Summary",         "summary.txt" );
@@ -88,6 +88,8 @@ namespace Coverage {
     PRINT_ITEM( "Annotated Assembly",   "annotated" );
     PRINT_ITEM( "Symbol Summary",       "symbolSummary" );
     PRINT_ITEM( "Size Report",          "sizes" );
+    if (SampledCoverage)
+      PRINT_ITEM( "Hot Spots",          "hotSpots" );
 
     PRINT_TEXT_ITEM( "Explanations Not Found", "ExplanationsNotFound.txt" );
 
@@ -150,13 +152,17 @@ namespace Coverage {
 
     fprintf(
       aFile,
-      "Annotated Report</div>\n"
+      "%sAnnotated Report</div>\n"
       "<div class =\"datetime\">%s</div>\n"
-      "<body>\n"
-      "<pre class=\"code\">\n",
+      "<body>\n",
+      FunctionCoverageOnly ? "Function-Level " : "",
       asctime( localtime(&timestamp_m) ) 
     );
 
+    PutFunctionCoverageNote( aFile );
+
+    fprintf( aFile, "<pre class=\"code\">\n" );
+
     return aFile;
   }
 
@@ -165,6 +171,17 @@ namespace Coverage {
     bool              hasBranches
   )
   {
+    static const TableColumn_t columns[] = {
+      { "Symbol",         false, false },
+      { "Line",           false, false },
+      { "File",           false, true  },
+      { "Size <br>Bytes", true,  false },
+      { "Reason",         false, false },
+      { "Taken",          false, true  },
+      { "Not Taken",      false, true  },
+      { "Classification", false, true  },
+      { "Explanation",    false, false }
+    };
     FILE *aFile;
 
     // Open the file
@@ -187,27 +204,18 @@ namespace Coverage {
 
       fprintf(
         aFile,
-        "Branch Report</div>\n"
+        "%sBranch Report</div>\n"
         "<div class =\"datetime\">%s</div>\n"
-        "<body>\n"
-        "<table class=\"covoar table-autosort:0 table-autofilter table-stripeclass:covoar-tr-odd"
-           TABLE_HEADER_CLASS "\">\n"
-        "<thead>\n"
-        "<tr>\n"
-        "<th class=\"table-sortable:default\" align=\"left\">Symbol</th>\n"
-        "<th class=\"table-sortable:default\" align=\"left\">Line</th>\n"
-        "<th class=\"table-filterable table-sortable:default\" align=\"left\">File</th>\n"
-        "<th class=\"table-sortable:numeric\" align=\"left\">Size <br>Bytes</th>\n"
-        "<th class=\"table-sortable:default\" align=\"left\">Reason</th>\n"
-        "<th class=\"table-filterable table-sortable:default\" align=\"left\">Taken</th>\n"
-	"<th class=\"table-filterable table-sortable:default\" align=\"left\">Not Taken</th>\n"
-        "<th class=\"table-filterable table-sortable:default\" align=\"left\">Classification</th>\n"
-        "<th class=\"table-sortable:default\" align=\"left\">Explanation</th>\n"
-        "</tr>\n"
-        "</thead>\n"
-        "<tbody>\n",
+        "<body>\n",
+        FunctionCoverageOnly ? "Function-Level " : "",
         asctime( localtime(&timestamp_m) ) 
       );
+
+      PutFunctionCoverageNote( aFile );
+
+      OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+    } else {
+      PutFunctionCoverageNote( aFile );
     }
    
     return aFile;
@@ -217,6 +225,15 @@ namespace Coverage {
     const char* const fileName
   )
   {
+    static const TableColumn_t columns[] = {
+      { "Symbol",                false, false },
+      { "Range",                 false, false },
+      { "File",                  false, true  },
+      { "Size <br>Bytes",        true,  false },
+      { "Size <br>Instructions", true,  false },
+      { "Classification",        false, true  },
+      { "Explanation",           false, false }
+    };
     FILE *aFile;
 
     // Open the file
@@ -238,27 +255,18 @@ namespace Coverage {
 
     fprintf(
       aFile,
-       "Coverage Report</div>\n"
+       "%sCoverage Report</div>\n"
        "<div class =\"datetime\">%s</div>\n"
-       "<body>\n"
-       "<table class=\"covoar table-autosort:0 table-autofilter table-stripeclass:covoar-tr-odd"
-           TABLE_HEADER_CLASS "\">\n"
-      "<thead>\n"
-      "<tr>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Symbol</th>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Range</th>\n"
-      "<th class=\"table-filterable table-sortable:default\" align=\"left\">File</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"left\">Size <br>Bytes</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"left\">Size <br>Instructions</th>\n"
-      "<th class=\"table-filterable table-sortable:default\" align=\"left\">Classification</th>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Explanation</th>\n"
-      "</tr>\n"
-      "</thead>\n"
-      "<tbody>\n",
+       "<body>\n",
+        FunctionCoverageOnly ? "Function-Level " : "",
         asctime( localtime(&timestamp_m) ) 
 
      );
 
+    PutFunctionCoverageNote( aFile );
+
+    OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+
     return aFile;
   }
 
@@ -266,6 +274,9 @@ namespace Coverage {
     const char* const fileName
   )
   {
+    static const TableColumn_t columns[] = {
+      { "Symbol", false, false }
+    };
     FILE *aFile;
 
     // Open the file
@@ -289,19 +300,13 @@ namespace Coverage {
       aFile,
        "No Range Report</div>\n"
        "<div class =\"datetime\">%s</div>\n"
-        "<body>\n"
-      "<table class=\"covoar table-autosort:0 table-autofilter table-stripeclass:covoar-tr-odd"
-           TABLE_HEADER_CLASS "\">\n"
-      "<thead>\n"
-      "<tr>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Symbol</th>\n"
-      "</tr>\n"
-      "</thead>\n"
-      "<tbody>\n",
+        "<body>\n",
         asctime( localtime(&timestamp_m) ) 
 
      );
 
+    OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+
     return aFile;
    }
 
@@ -311,6 +316,12 @@ namespace Coverage {
     const char* const fileName
   )
   {
+    static const TableColumn_t columns[] = {
+      { "Size",   true,  false },
+      { "Symbol", false, false },
+      { "Line",   false, false },
+      { "File",   false, true  }
+    };
     FILE *aFile;
 
     // Open the file
@@ -334,21 +345,12 @@ namespace Coverage {
       aFile,
       "Size Report</div>\n"
        "<div class =\"datetime\">%s</div>\n"
-      "<body>\n"
-      "<table class=\"covoar table-autosort:0 table-autofilter table-stripeclass:covoar-tr-odd"
-           TABLE_HEADER_CLASS "\">\n"
-      "<thead>\n"
-      "<tr>\n"
-      "<th class=\"table-sortable:numeric\" align=\"left\">Size</th>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Symbol</th>\n"
-      "<th class=\"table-sortable:default\" align=\"left\">Line</th>\n"
-      "<th class=\"table-filterable table-sortable:default\" align=\"left\">File</th>\n"
-      "</tr>\n"
-      "</thead>\n"
-      "<tbody>\n",
+      "<body>\n",
         asctime( localtime(&timestamp_m) ) 
 
     );
+    OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+
     return aFile;
   }
 
@@ -356,6 +358,19 @@ namespace Coverage {
     const char* const fileName
   )
   {
+    static const TableColumn_t columns[] = {
+      { "Symbol",                               false, false },
+      { "Total<br>Size<br>Bytes",               true,  false },
+      { "Total<br>Size<br>Instr",               true,  false },
+      { "#<br>Ranges",                          true,  false },
+      { "Uncovered<br>Size<br>Bytes",           true,  false },
+      { "Uncovered<br>Size<br>Instr",           true,  false },
+      { "#<br>Branches",                        true,  false },
+      { "#<br>Always<br>Taken",                 true,  false },
+      { "#<br>Never<br>Taken",                  true,  false },
+      { "Percent<br>Uncovered<br>Instructions", true,  false },
+      { "Percent<br>Uncovered<br>Bytes",        true,  false }
+    };
     FILE *aFile;
 
     // Open the file
@@ -379,28 +394,56 @@ namespace Coverage {
       aFile,
       "Symbol Summary Report</div>\n"
        "<div class =\"datetime\">%s</div>\n"
-      "<body>\n"
-      "<table class=\"covoar table-autosort:0 table-autofilter table-stripeclass:covoar-tr-odd"
-           TABLE_HEADER_CLASS "\">\n"
-      "<thead>\n"
-      "<tr>\n"
-      "<th class=\"table-sortable:default\" align=\"center\">Symbol</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Total<br>Size<br>Bytes</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Total<br>Size<br>Instr</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">#<br>Ranges</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Uncovered<br>Size<br>Bytes</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Uncovered<br>Size<br>Instr</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">#<br>Branches</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">#<br>Always<br>Taken</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">#<br>Never<br>Taken</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Percent<br>Uncovered<br>Instructions</th>\n"
-      "<th class=\"table-sortable:numeric\" align=\"center\">Percent<br>Uncovered<br>Bytes</th>\n"
-      "</tr>\n"
-      "</thead>\n"
-      "<tbody>\n",
+      "<body>\n",
+        asctime( localtime(&timestamp_m) ) 
+
+    );
+    OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+
+    return aFile;
+  }
+
+  FILE*  ReportsHtml::OpenHotSpotFile(
+    const char* const fileName
+  )
+  {
+    static const TableColumn_t columns[] = {
+      { "Symbol",                               false, false },
+      { "Samples",                              true,  false },
+      { "Percent<br>Samples",                   true,  false },
+      { "Calls",                                true,  false },
+      { "Hottest<br>Instruction<br>Samples",    true,  false },
+      { "Hottest Instruction",                  false, false }
+    };
+    FILE *aFile;
+
+    // Open the file
+    aFile = OpenFile(fileName);
+
+    // Put header information into the file
+    fprintf(
+      aFile,
+      "<title>Hot Spot Report</title>\n"
+      "<div class=\"heading-title\">"
+    );
+
+    if (projectName)
+      fprintf(
+        aFile,
+        "%s<br>",
+        projectName
+      );
+
+    fprintf(
+      aFile,
+      "Hot Spot Report</div>\n"
+       "<div class =\"datetime\">%s</div>\n"
+      "<body>\n",
         asctime( localtime(&timestamp_m) ) 
 
     );
+    OpenTable( aFile, columns, sizeof( columns ) / sizeof( columns[0] ) );
+
     return aFile;
   }
 
@@ -509,99 +552,57 @@ namespace Coverage {
     uint32_t                     bAddress = 0;
     uint32_t                     lowAddress = 0;
     Coverage::CoverageMapBase*   theCoverageMap = NULL;
-
-    // Mark the background color different for odd and even lines.
-    if ( ( count%2 ) != 0 )
-      fprintf( report, "<tr class=\"covoar-tr-odd\">\n");
-    else
-      fprintf( report, "<tr>\n");
+    char                         text[48];
+    TableRow_t&                  row = AddTableRow( report );
 
     // symbol
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbolPtr->first.c_str()
-    );
+    AddTableCell( row, symbolPtr->first );
 
     // line
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\"><a href =\"annotated.html#range%d\">%s</td>\n",     
-      rangePtr->id,
-      rangePtr->lowSourceLine.c_str()
-    );
+    sprintf( text, "annotated.html#range%d", rangePtr->id );
+    AddTableCell( row, rangePtr->lowSourceLine, text );
 
     // File
     i = rangePtr->lowSourceLine.find(":");
     temp =  rangePtr->lowSourceLine.substr (0, i);
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      temp.c_str()
-    );
+    AddTableCell( row, temp );
   
     // Size in bytes
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      rangePtr->highAddress - rangePtr->lowAddress + 1
-    );
+    AddTableNumber( row, rangePtr->highAddress - rangePtr->lowAddress + 1 );
 
     // Reason Branch was uncovered
     if (rangePtr->reason ==
       Coverage::CoverageRanges::UNCOVERED_REASON_BRANCH_ALWAYS_TAKEN)
-      fprintf( 
-        report,
-        "<td class=\"covoar-td\" align=\"center\">Always Taken</td>\n"
-      );
+      AddTableCell( row, "Always Taken" );
     else if (rangePtr->reason ==
       Coverage::CoverageRanges::UNCOVERED_REASON_BRANCH_NEVER_TAKEN)
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">Never Taken</td>\n"
-      );
+      AddTableCell( row, "Never Taken" );
+    else
+      AddTableCell( row, "" );
 
     // Taken / Not taken counts
     lowAddress = rangePtr->lowAddress;
     bAddress = symbolPtr->second.baseAddress;
     theCoverageMap = symbolPtr->second.unifiedCoverageMap;
-    fprintf(
-      report,
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      theCoverageMap->getWasTaken( lowAddress - bAddress )
-    );
-        fprintf(
-      report,
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      theCoverageMap->getWasNotTaken( lowAddress - bAddress )
-    );
+    sprintf( text, "%d", theCoverageMap->getWasTaken( lowAddress - bAddress ) );
+    AddTableCell( row, text );
+    sprintf( text, "%d", theCoverageMap->getWasNotTaken( lowAddress - bAddress ) );
+    AddTableCell( row, text );
 
     // See if an explanation is available and write the Classification and
     // the Explination Columns.
     explanation = AllExplanations->lookupExplanation( rangePtr->lowSourceLine );
     if ( !explanation ) {
-      // Write Classificationditr->second.baseAddress
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">NONE</td>\n"
-        "<td class=\"covoar-td\" align=\"center\">No Explanation</td>\n"
-      );
+      AddTableCell( row, "NONE" );
+      AddTableCell( row, "No Explanation" );
     } else {
       char explanationFile[48];
       sprintf( explanationFile, "explanation%d.html", rangePtr->id );
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">%s</td>\n"
-        "<td class=\"covoar-td\" align=\"center\">"
-        "<a href=\"%s\">Explanation</a></td>\n",
-        explanation->classification.c_str(),
-        explanationFile
-      );
+      AddTableCell( row, explanation->classification );
+      AddTableCell( row, "Explanation", explanationFile );
       WriteExplationFile( explanationFile, explanation );
     }
 
-    fprintf( report, "</tr>\n");
-
     return true;
   }
 
@@ -633,6 +634,7 @@ namespace Coverage {
   )
   {
     Coverage::Explanation explanation;
+    TableRow_t&           row = AddTableRow( report );
 
     explanation.explanation.push_back(
       "<html><p>\n"
@@ -643,62 +645,26 @@ namespace Coverage {
       "</p></html>\n"
     );
 
-    // Mark the background color different for odd and even lines.
-    if ( ( count%2 ) != 0 ){
-      fprintf( report, "<tr class=\"covoar-tr-odd\">\n");
-      fprintf( noRangeFile,  "<tr class=\"covoar-tr-odd\">\n");
-    } else {
-      fprintf( report, "<tr>\n");
-      fprintf( noRangeFile,  "<tr>\n");
-    }
-
     // symbol
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbol.c_str()
-    );
-    fprintf( 
-      noRangeFile, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbol.c_str()
-    );
+    AddTableCell( row, symbol );
+    AddTableCell( AddTableRow( noRangeFile ), symbol );
 
     // starting line
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">unknown</td>\n"
-     );
+    AddTableCell( row, "unknown" );
      
     // file
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">unknown</td>\n"
-     );
+    AddTableCell( row, "unknown" );
      
-     // Size in bytes
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">unknown</td>\n"
-    );
+    // Size in bytes
+    AddTableCell( row, "unknown" );
 
     // Size in instructions
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">unknown</td>\n"
-    ); 
+    AddTableCell( row, "unknown" );
 
     // See if an explanation is available
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">Unknown</td>\n"
-      "<td class=\"covoar-td\" align=\"center\">"
-      "<a href=\"NotReferenced.html\">No data</a></td>\n"
-    );
+    AddTableCell( row, "Unknown" );
+    AddTableCell( row, "No data", "NotReferenced.html" );
     WriteExplationFile( "NotReferenced.html", &explanation );
-
-    fprintf( report, "</tr>\n");
-    fprintf( noRangeFile, "</tr>\n");
   }
 
   bool ReportsHtml::PutCoverageLine(
@@ -711,80 +677,45 @@ namespace Coverage {
     const Coverage::Explanation*   explanation;
     std::string                    temp;
     int                            i;
-
-    // Mark the background color different for odd and even lines.
-    if ( ( count%2 ) != 0 )
-      fprintf( report, "<tr class=\"covoar-tr-odd\">\n");
-    else
-      fprintf( report, "<tr>\n");
+    char                           link[48];
+    TableRow_t&                    row = AddTableRow( report );
 
     // symbol
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbolPtr->first.c_str()
-    );
+    AddTableCell( row, symbolPtr->first );
 
     // Range
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\"><a href =\"annotated.html#range%d\">%s <br>%s</td>\n",
-      rangePtr->id,    
-      rangePtr->lowSourceLine.c_str(),
-      rangePtr->highSourceLine.c_str()
-     );
+    sprintf( link, "annotated.html#range%d", rangePtr->id );
+    AddTableCell(
+      row,
+      rangePtr->lowSourceLine + "\n" + rangePtr->highSourceLine,
+      link
+    );
 
     // File
     i = rangePtr->lowSourceLine.find(":");
     temp =  rangePtr->lowSourceLine.substr (0, i);
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      temp.c_str()
-    );
+    AddTableCell( row, temp );
        
     // Size in bytes
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      rangePtr->highAddress - rangePtr->lowAddress + 1
-    );
+    AddTableNumber( row, rangePtr->highAddress - rangePtr->lowAddress + 1 );
 
     // Size in instructions
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      rangePtr->instructionCount
-    ); 
+    AddTableNumber( row, rangePtr->instructionCount );
 
     // See if an explanation is available
     explanation = AllExplanations->lookupExplanation( rangePtr->lowSourceLine );
     if ( !explanation ) {
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">NONE</td>\n"
-      );
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">No Explanation</td>\n"
-      );
+      AddTableCell( row, "NONE" );
+      AddTableCell( row, "No Explanation" );
     } else {
       char explanationFile[48];
 
       sprintf( explanationFile, "explanation%d.html", rangePtr->id );
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">%s</td>\n"
-        "<td class=\"covoar-td\" align=\"center\">"
-        "<a href=\"%s\">Explanation</a></td>\n",
-        explanation->classification.c_str(),
-        explanationFile
-      );
+      AddTableCell( row, explanation->classification );
+      AddTableCell( row, "Explanation", explanationFile );
       WriteExplationFile( explanationFile, explanation );
     }
 
-    fprintf( report, "</tr>\n");
-
     return true;
   }
 
@@ -797,45 +728,23 @@ namespace Coverage {
   {
     std::string  temp;
     int          i;
-
-    // Mark the background color different for odd and even lines.
-    if ( ( count%2 ) != 0 )
-      fprintf( report, "<tr class=\"covoar-tr-odd\">\n");
-    else
-      fprintf( report, "<tr>\n");
+    char         link[48];
+    TableRow_t&  row = AddTableRow( report );
 
     // size
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      range->highAddress - range->lowAddress + 1
-    );
+    AddTableNumber( row, range->highAddress - range->lowAddress + 1 );
 
     // symbol
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbol->first.c_str()
-    );
+    AddTableCell( row, symbol->first );
 
     // line
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\"><a href =\"annotated.html#range%d\">%s</td>\n",     
-      range->id,
-      range->lowSourceLine.c_str()
-    );
+    sprintf( link, "annotated.html#range%d", range->id );
+    AddTableCell( row, range->lowSourceLine, link );
 
     // File
     i = range->lowSourceLine.find(":");
     temp =  range->lowSourceLine.substr (0, i);
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      temp.c_str()
-    );
-    
-    fprintf( report, "</tr>\n");
+    AddTableCell( row, temp );
 
     return true;
   }
@@ -846,108 +755,327 @@ namespace Coverage {
     Coverage::DesiredSymbols::symbolSet_t::iterator symbol
   )
   {
- 
-    // Mark the background color different for odd and even lines.
-    if ( ( count%2 ) != 0 )
-      fprintf( report, "<tr class=\"covoar-tr-odd\">\n");
-    else
-      fprintf( report, "<tr>\n");
+    TableRow_t& row = AddTableRow( report );
 
     // symbol
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%s</td>\n",     
-      symbol->first.c_str()
-    );
+    AddTableCell( row, symbol->first );
 
     // Total Size in Bytes
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      symbol->second.stats.sizeInBytes
-    );
+    AddTableNumber( row, symbol->second.stats.sizeInBytes );
 
     // Total Size in Instructions 
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      symbol->second.stats.sizeInInstructions
-    );
+    AddTableNumber( row, symbol->second.stats.sizeInInstructions );
 
     // Total Uncovered Ranges
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",     
-      symbol->second.stats.uncoveredRanges
-    );
+    AddTableNumber( row, symbol->second.stats.uncoveredRanges );
 
     // Uncovered Size in Bytes
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      symbol->second.stats.uncoveredBytes
-    );
+    AddTableNumber( row, symbol->second.stats.uncoveredBytes );
 
     // Uncovered Size in Instructions 
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-       symbol->second.stats.uncoveredInstructions
-    );
+    AddTableNumber( row, symbol->second.stats.uncoveredInstructions );
 
     // Total number of branches
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",     
-      symbol->second.stats.branchesNotExecuted +  symbol->second.stats.branchesExecuted
+    AddTableNumber(
+      row,
+      symbol->second.stats.branchesNotExecuted +
+        symbol->second.stats.branchesExecuted
     );
 
     // Total Always Taken
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      symbol->second.stats.branchesAlwaysTaken
-    );
+    AddTableNumber( row, symbol->second.stats.branchesAlwaysTaken );
 
     // Total Never Taken
-    fprintf( 
-      report, 
-      "<td class=\"covoar-td\" align=\"center\">%d</td>\n",
-      symbol->second.stats.branchesNeverTaken
-     );
+    AddTableNumber( row, symbol->second.stats.branchesNeverTaken );
 
     // % Uncovered Instructions
     if ( symbol->second.stats.sizeInInstructions == 0 )
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">100.00</td>\n"
-      );
+      AddTableNumber( row, 100.0, 2 );
     else     
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">%.2f</td>\n",
+      AddTableNumber(
+        row,
         (symbol->second.stats.uncoveredInstructions*100.0)/
-         symbol->second.stats.sizeInInstructions
+         symbol->second.stats.sizeInInstructions,
+        2
       );
 
     // % Uncovered Bytes
     if ( symbol->second.stats.sizeInBytes == 0 )
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">100.00</td>\n"
-      );
+      AddTableNumber( row, 100.0, 2 );
     else     
-      fprintf( 
-        report, 
-        "<td class=\"covoar-td\" align=\"center\">%.2f</td>\n",
+      AddTableNumber(
+        row,
         (symbol->second.stats.uncoveredBytes*100.0)/
-         symbol->second.stats.sizeInBytes
+         symbol->second.stats.sizeInBytes,
+        2
+      );
+
+    return true;
+  }
+
+  bool  ReportsHtml::PutHotSpotLine(
+    FILE*                                           report,
+    unsigned int                                    count,
+    Coverage::DesiredSymbols::symbolSet_t::iterator symbol,
+    const ObjdumpProcessor::objdumpLine_t*          hottest,
+    uint32_t                                        hottestSamples
+  )
+  {
+    TableRow_t& row = AddTableRow( report );
+
+    // symbol
+    AddTableCell( row, symbol->first );
+
+    // Samples
+    AddTableNumber( row, symbol->second.stats.samples );
+
+    // % Samples
+    if ( SymbolsToAnalyze->stats.samples == 0 )
+      AddTableNumber( row, 0.0, 2 );
+    else
+      AddTableNumber(
+        row,
+        (symbol->second.stats.samples*100.0)/
+         SymbolsToAnalyze->stats.samples,
+        2
       );
 
-    fprintf( report, "</tr>\n");
+    // Calls
+    AddTableNumber( row, symbol->second.stats.calls );
+
+    // Hottest instruction
+    AddTableNumber( row, hottestSamples );
+    AddTableCell( row, hottest ? hottest->line : "" );
+
     return true;
   }
 
+  void ReportsHtml::OpenTable(
+    FILE*                aFile,
+    const TableColumn_t* columns,
+    unsigned int         columnCount
+  )
+  {
+    Table_t& table = tables_m[ aFile ];
+
+    table.columns = columns;
+    table.columnCount = columnCount;
+    table.rows.clear();
+  }
+
+  ReportsHtml::TableRow_t& ReportsHtml::AddTableRow(
+    FILE* aFile
+  )
+  {
+    Table_t& table = tables_m[ aFile ];
+
+    table.rows.push_back( TableRow_t() );
+    return table.rows.back();
+  }
+
+  void ReportsHtml::AddTableCell(
+    TableRow_t&        row,
+    const std::string& text,
+    const char*        link
+  )
+  {
+    TableCell_t cell;
+
+    cell.text = text;
+    if ( link )
+      cell.link = link;
+    cell.value = 0.0;
+    cell.isNumber = false;
+    row.push_back( cell );
+  }
+
+  void ReportsHtml::AddTableNumber(
+    TableRow_t& row,
+    double      value,
+    int         precision
+  )
+  {
+    TableCell_t cell;
+    char        text[64];
+
+    snprintf( text, sizeof( text ), "%.*f", precision, value );
+    cell.text = text;
+    cell.value = value;
+    cell.isNumber = true;
+    row.push_back( cell );
+  }
+
+  /*!
+   *  This type defines the sort key of a table cell.
+   */
+  typedef struct {
+    double       value;
+    bool         isNumber;
+    const char*  text;
+    unsigned int row;
+  } TableSortKey_t;
+
+  /*!
+   *  This method orders the cells of a numeric column. Cells that are not
+   *  numbers, for example "unknown", are first.
+   */
+  static bool TableNumericCompare(
+    const TableSortKey_t& lhs,
+    const TableSortKey_t& rhs
+  )
+  {
+    if ( lhs.isNumber != rhs.isNumber )
+      return !lhs.isNumber;
+    if ( lhs.isNumber ) {
+      if ( lhs.value != rhs.value )
+        return lhs.value < rhs.value;
+    } else {
+      int r = strcmp( lhs.text, rhs.text );
+      if ( r != 0 )
+        return r < 0;
+    }
+    return lhs.row < rhs.row;
+  }
+
+  /*!
+   *  This method orders the cells of a text column.
+   */
+  static bool TableTextCompare(
+    const TableSortKey_t& lhs,
+    const TableSortKey_t& rhs
+  )
+  {
+    int r = strcmp( lhs.text, rhs.text );
+    if ( r != 0 )
+      return r < 0;
+    return lhs.row < rhs.row;
+  }
+
+  /*!
+   *  This method writes a JSON string. The '<' and '>' characters are
+   *  escaped so the string cannot close the script element holding it.
+   */
+  static void WriteJsonString(
+    FILE*              aFile,
+    const std::string& text
+  )
+  {
+    fputc( '"', aFile );
+    for ( std::string::const_iterator it = text.begin();
+          it != text.end();
+          it++ ) {
+      unsigned char c = *it;
+      switch ( c ) {
+        case '"':  fputs( "\\\"", aFile ); break;
+        case '\\': fputs( "\\\\", aFile ); break;
+        case '\n': fputs( "\\n", aFile );  break;
+        case '\t': fputs( "\\t", aFile );  break;
+        case '<':
+        case '>':  fprintf( aFile, "\\u%04x", c ); break;
+        default:
+          if ( c < 0x20 )
+            fprintf( aFile, "\\u%04x", c );
+          else
+            fputc( c, aFile );
+          break;
+      }
+    }
+    fputc( '"', aFile );
+  }
+
+  void ReportsHtml::CloseTable(
+    FILE* aFile
+  )
+  {
+    std::map<FILE*, Table_t>::iterator it = tables_m.find( aFile );
+    std::vector<TableSortKey_t>        keys;
+    unsigned int                       column;
+    unsigned int                       row;
+
+    if ( it == tables_m.end() )
+      return;
+
+    Table_t& table = it->second;
+
+    fprintf(
+      aFile,
+      "<div class=\"table-virtual\">\n"
+      "<script type=\"application/json\">\n"
+      "{\"columns\":["
+    );
+
+    for ( column = 0; column < table.columnCount; column++ ) {
+      const TableColumn_t& col = table.columns[ column ];
+      fprintf( aFile, "%s{\"title\":", column ? "," : "" );
+      WriteJsonString( aFile, col.title );
+      fprintf(
+        aFile,
+        ",\"type\":\"%s\",\"filter\":%s}",
+        col.numeric ? "numeric" : "string",
+        col.filterable ? "true" : "false"
+      );
+    }
+
+    fprintf( aFile, "],\n\"rows\":[" );
+
+    for ( row = 0; row < table.rows.size(); row++ ) {
+      const TableRow_t& cells = table.rows[ row ];
+      fprintf( aFile, "%s\n[", row ? "," : "" );
+      for ( column = 0; column < cells.size(); column++ ) {
+        const TableCell_t& cell = cells[ column ];
+        if ( column )
+          fputc( ',', aFile );
+        if ( cell.isNumber )
+          fputs( cell.text.c_str(), aFile );
+        else if ( cell.link.empty() )
+          WriteJsonString( aFile, cell.text );
+        else {
+          fputc( '[', aFile );
+          WriteJsonString( aFile, cell.text );
+          fputc( ',', aFile );
+          WriteJsonString( aFile, cell.link );
+          fputc( ']', aFile );
+        }
+      }
+      fputc( ']', aFile );
+    }
+
+    // The rows in ascending order for each column. The browser walks the
+    // order backwards for a descending sort so it never sorts the rows.
+    fprintf( aFile, "],\n\"order\":[" );
+
+    keys.resize( table.rows.size() );
+    for ( column = 0; column < table.columnCount; column++ ) {
+      static const TableCell_t empty = { "", "", 0.0, false };
+      for ( row = 0; row < table.rows.size(); row++ ) {
+        const TableRow_t&  cells = table.rows[ row ];
+        const TableCell_t& cell =
+          column < cells.size() ? cells[ column ] : empty;
+        keys[ row ].value = cell.value;
+        keys[ row ].isNumber = cell.isNumber;
+        keys[ row ].text = cell.text.c_str();
+        keys[ row ].row = row;
+      }
+      if ( table.columns[ column ].numeric )
+        std::sort( keys.begin(), keys.end(), TableNumericCompare );
+      else
+        std::sort( keys.begin(), keys.end(), TableTextCompare );
+      fprintf( aFile, "%s\n[", column ? "," : "" );
+      for ( row = 0; row < keys.size(); row++ )
+        fprintf( aFile, "%s%u", row ? "," : "", keys[ row ].row );
+      fputc( ']', aFile );
+    }
+
+    fprintf(
+      aFile,
+      "]}\n"
+      "</script>\n"
+      "</div>\n"
+    );
+
+    tables_m.erase( it );
+  }
+
   void ReportsHtml::CloseAnnotatedFile(
     FILE*  aFile
   )
@@ -967,14 +1095,8 @@ namespace Coverage {
     bool   hasBranches
   )
   {
-    if ( hasBranches ) {
-      fprintf(
-        aFile,
-        TABLE_FOOTER
-        "</tbody>\n"
-        "</table>\n" 
-      );
-    }
+    if ( hasBranches )
+      CloseTable( aFile );
     fprintf(
       aFile,
       "</pre>\n" 
@@ -989,11 +1111,9 @@ namespace Coverage {
     FILE*  aFile
   )
   {
+    CloseTable( aFile );
     fprintf(
       aFile,
-      TABLE_FOOTER
-      "</tbody>\n"
-      "</table>\n" 
       "</pre>\n" 
       "</body>\n"
       "</html>"
@@ -1006,11 +1126,9 @@ namespace Coverage {
     FILE*  aFile
   )
   {
+    CloseTable( aFile );
     fprintf(
       aFile,
-      TABLE_FOOTER
-      "</tbody>\n"
-      "</table>\n" 
       "</pre>\n" 
       "</body>\n"
       "</html>"
@@ -1024,11 +1142,9 @@ namespace Coverage {
     FILE*  aFile
   )
   {
+    CloseTable( aFile );
     fprintf(
       aFile,
-      TABLE_FOOTER
-      "</tbody>\n"
-      "</table>\n" 
       "</pre>\n" 
       "</body>\n"
       "</html>"
@@ -1041,11 +1157,9 @@ namespace Coverage {
     FILE*  aFile
   )
   {
+    CloseTable( aFile );
     fprintf(
       aFile,
-      TABLE_FOOTER
-       "</tbody>\n"
-      "</table>\n" 
       "</pre>\n" 
       "</body>\n"
       "</html>"
@@ -1054,4 +1168,19 @@ namespace Coverage {
      CloseFile( aFile );
   }
 
+  void ReportsHtml::CloseHotSpotFile(
+    FILE*  aFile
+  )
+  {
+    CloseTable( aFile );
+    fprintf(
+      aFile,
+      "</pre>\n" 
+      "</body>\n"
+      "</html>"
+    );
+
+    CloseFile( aFile );
+  }
+
 }
@@ -10,6 +10,9 @@
 #define __REPORTSHTML_H__
 
 #include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
 #include "ReportsBase.h"
 #include "Explanations.h"
 
@@ -74,6 +77,119 @@ class ReportsHtml: public ReportsBase {
      */
     AnnotatedLineState_t lastState_m;
 
+    /*!
+     *  This type defines a column of a report table.
+     */
+    typedef struct {
+      /*!
+       *  This member is the HTML title of the column.
+       */
+      const char* title;
+
+      /*!
+       *  This member is true if the column is sorted by number.
+       */
+      bool numeric;
+
+      /*!
+       *  This member is true if the column can be filtered by value.
+       */
+      bool filterable;
+    } TableColumn_t;
+
+    /*!
+     *  This type defines a cell of a report table. The cell's text is
+     *  shown as a link if the link is not empty.
+     */
+    typedef struct {
+      std::string text;
+      std::string link;
+      double      value;
+      bool        isNumber;
+    } TableCell_t;
+
+    /*!
+     *  This type defines a row of a report table.
+     */
+    typedef std::vector<TableCell_t> TableRow_t;
+
+    /*!
+     *  This type defines a report table. The rows are held until the
+     *  table is closed and then written as a JSON payload that table.js
+     *  renders.
+     */
+    typedef struct {
+      const TableColumn_t*    columns;
+      unsigned int            columnCount;
+      std::vector<TableRow_t> rows;
+    } Table_t;
+
+    /*!
+     *  This member variable contains the open tables of the report files.
+     */
+    std::map<FILE*, Table_t> tables_m;
+
+    /*!
+     *  This method starts the table of a report file.
+     *
+     *  @param[in] aFile identifies the report file
+     *  @param[in] columns identifies the columns of the table
+     *  @param[in] columnCount identifies the number of columns
+     */
+    void OpenTable(
+      FILE*                aFile,
+      const TableColumn_t* columns,
+      unsigned int         columnCount
+    );
+
+    /*!
+     *  This method adds a row to the table of a report file.
+     *
+     *  @param[in] aFile identifies the report file
+     *
+     *  @return Returns the row to add the cells to.
+     */
+    TableRow_t& AddTableRow(
+      FILE* aFile
+    );
+
+    /*!
+     *  This method adds a text cell to a table row.
+     *
+     *  @param[in] row identifies the row
+     *  @param[in] text identifies the text of the cell
+     *  @param[in] link identifies the link of the cell or NULL
+     */
+    void AddTableCell(
+      TableRow_t&        row,
+      const std::string& text,
+      const char*        link = NULL
+    );
+
+    /*!
+     *  This method adds a number cell to a table row.
+     *
+     *  @param[in] row identifies the row
+     *  @param[in] value identifies the number
+     *  @param[in] precision identifies the number of decimal places
+     */
+    void AddTableNumber(
+      TableRow_t& row,
+      double      value,
+      int         precision = 0
+    );
+
+    /*!
+     *  This method writes the table of a report file as a JSON payload
+     *  of the columns, the rows and the order of the rows sorted by each
+     *  column.
+     *
+     *  @param[in] aFile identifies the report file
+     */
+    void CloseTable(
+      FILE* aFile
+    );
+
     /* Inherit documentation from base class. */ 
     virtual FILE* OpenAnnotatedFile(
       const char* const fileName
@@ -105,6 +221,11 @@ class ReportsHtml: public ReportsBase {
       const char* const fileName
     );
 
+    /* Inherit documentation from base class. */ 
+    virtual FILE* OpenHotSpotFile(
+      const char* const fileName
+    );
+
     /* Inherit documentation from base class. */ 
     virtual void CloseAnnotatedFile(
       FILE*  aFile
@@ -136,6 +257,11 @@ class ReportsHtml: public ReportsBase {
       FILE*  aFile
     );
 
+    /* Inherit documentation from base class. */ 
+    virtual void CloseHotSpotFile(
+      FILE*  aFile
+    );
+
     /* Inherit documentation from base class. */ 
     virtual void PutAnnotatedLine( 
       FILE*                aFile, 
@@ -198,6 +324,15 @@ class ReportsHtml: public ReportsBase {
       Coverage::DesiredSymbols::symbolSet_t::iterator symbol
     );
 
+    /* Inherit documentation from base class. */ 
+    virtual bool PutHotSpotLine(
+      FILE*                                           report,
+      unsigned int                                    number,
+      Coverage::DesiredSymbols::symbolSet_t::iterator symbol,
+      const ObjdumpProcessor::objdumpLine_t*          hottest,
+      uint32_t                                        hottestSamples
+    );
+
     /* Inherit documentation from base class. */ 
     virtual FILE* OpenFile(
       const char* const fileName
@@ -0,0 +1,284 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <iostream>
+#include <list>
+
+#include "ReportsLcov.h"
+#include "app_common.h"
+#include "CoverageMapBase.h"
+#include "DesiredSymbols.h"
+#include "ExecutableInfo.h"
+#include "ObjdumpProcessor.h"
+
+#include "rld.h"
+#include "rld-files.h"
+
+namespace Coverage {
+
+/*!
+ *  This type defines a branch instruction of a source line.
+ */
+typedef struct {
+  bool     executed;
+  uint32_t taken;
+  uint32_t notTaken;
+} lcovBranch_t;
+
+/*!
+ *  This type defines the coverage of a source line. The count is the
+ *  highest execution count of the line's instructions.
+ */
+typedef struct {
+  uint32_t                count;
+  std::list<lcovBranch_t> branches;
+} lcovLine_t;
+
+typedef std::map<uint32_t, lcovLine_t>   lcovLines_t;
+typedef std::map<uint32_t, lcovLines_t>  lcovFiles_t;
+
+ReportsLcov::ReportsLcov( time_t timestamp ):
+  ReportsFile( timestamp )
+{
+  reportExtension_m = ".info";
+}
+
+ReportsLcov::~ReportsLcov()
+{
+  lines_t::iterator litr;
+
+  for (litr = lines_m.begin(); litr != lines_m.end(); litr++)
+    delete litr->second;
+}
+
+void ReportsLcov::WriteTraceFile(
+  const char* const fileName
+)
+{
+  Coverage::DesiredSymbols::symbolSet_t::iterator ditr;
+  FILE*                                           aFile;
+  std::string                                     testName;
+  const char*                                     c;
+
+  aFile = OpenFile( fileName );
+  if ( !aFile )
+    return;
+
+  // The test name can only have letters, digits and underscores.
+  if (projectName) {
+    for (c = projectName; *c != '\0'; c++)
+      testName += isalnum( (unsigned char) *c ) ? *c : '_';
+  }
+
+  fprintf( aFile, "TN:%s\n", testName.c_str() );
+
+  for (ditr = SymbolsToAnalyze->set.begin();
+       ditr != SymbolsToAnalyze->set.end();
+       ditr++) {
+    PutSymbolRecords( aFile, ditr );
+  }
+
+  CloseFile( aFile );
+}
+
+const rld::dwarf::lines* ReportsLcov::getLines(
+  ExecutableInfo* const theExecutable
+)
+{
+  std::string       fileName;
+  lines_t::iterator litr;
+
+  if (theExecutable->hasDynamicLibrary())
+    fileName = theExecutable->getLibraryName();
+  else
+    fileName = theExecutable->getFileName();
+
+  litr = lines_m.find( fileName );
+  if (litr != lines_m.end())
+    return litr->second;
+
+  rld::dwarf::lines* theLines = new rld::dwarf::lines;
+
+  try {
+    rld::files::object exe( fileName );
+
+    exe.open();
+    exe.begin();
+    theLines->load( exe.elf() );
+    exe.end();
+    exe.close();
+  } catch ( rld::error& re ) {
+    fprintf(
+      stderr,
+      "WARNING: ReportsLcov::getLines - %s: %s: %s\n",
+      fileName.c_str(),
+      re.where.c_str(),
+      re.what.c_str()
+    );
+    delete theLines;
+    theLines = NULL;
+  }
+
+  if (theLines && (theLines->size() == 0)) {
+    fprintf(
+      stderr,
+      "WARNING: ReportsLcov::getLines - %s has no DWARF line information\n",
+      fileName.c_str()
+    );
+    delete theLines;
+    theLines = NULL;
+  }
+
+  lines_m[ fileName ] = theLines;
+
+  return theLines;
+}
+
+void ReportsLcov::PutSymbolRecords(
+  FILE*                                           aFile,
+  Coverage::DesiredSymbols::symbolSet_t::iterator symbol
+)
+{
+  CoverageMapBase*                                     theCoverageMap;
+  const rld::dwarf::lines*                             theLines;
+  const rld::dwarf::line*                              theLine;
+  const rld::dwarf::line*                              entryLine;
+  std::list<ObjdumpProcessor::objdumpLine_t>::iterator itr;
+  lcovFiles_t                                          files;
+  lcovFiles_t::iterator                                fitr;
+  lcovLines_t::iterator                                litr;
+  std::list<lcovBranch_t>::iterator                    bitr;
+  lcovBranch_t                                         branch;
+  uint32_t                                             bAddress;
+  uint32_t                                             loadAddress;
+  uint32_t                                             offset;
+  uint32_t                                             count;
+  uint32_t                                             block;
+  uint32_t                                             found;
+  uint32_t                                             hit;
+
+  theCoverageMap = symbol->second.unifiedCoverageMap;
+  if (!theCoverageMap || !symbol->second.sourceFile)
+    return;
+
+  theLines = getLines( symbol->second.sourceFile );
+  if (!theLines)
+    return;
+
+  bAddress = symbol->second.baseAddress;
+  loadAddress = symbol->second.sourceFile->getLoadAddress();
+
+  // Gather the lines of the symbol's instructions by source file. The
+  // line addresses of an executable or a shared library are relative to
+  // its load address. Relocatable modules have no line tables.
+  for (itr = symbol->second.instructions.begin();
+       itr != symbol->second.instructions.end();
+       itr++) {
+    if (!itr->isInstruction)
+      continue;
+
+    theLine = theLines->find( itr->address - loadAddress );
+    if (!theLine)
+      continue;
+
+    offset = itr->address - bAddress;
+    count = theCoverageMap->getWasExecuted( offset );
+
+    lcovLine_t& line = files[ theLine->file ][ theLine->number ];
+    if (count > line.count)
+      line.count = count;
+
+    if (BranchInfoAvailable && theCoverageMap->isBranch( offset )) {
+      branch.executed = theCoverageMap->wasExecuted( offset );
+      branch.taken = theCoverageMap->getWasTaken( offset );
+      branch.notTaken = theCoverageMap->getWasNotTaken( offset );
+      line.branches.push_back( branch );
+    }
+  }
+
+  entryLine = theLines->find( bAddress - loadAddress );
+
+  for (fitr = files.begin(); fitr != files.end(); fitr++) {
+    fprintf(
+      aFile,
+      "SF:%s\n",
+      theLines->file_name( fitr->first ).c_str()
+    );
+
+    // The function is in the file holding its entry point.
+    if (entryLine && (entryLine->file == fitr->first)) {
+      count = theCoverageMap->getWasExecuted( 0 );
+      fprintf(
+        aFile,
+        "FN:%u,%s\n"
+        "FNDA:%u,%s\n"
+        "FNF:1\n"
+        "FNH:%d\n",
+        entryLine->number,
+        symbol->first.c_str(),
+        count,
+        symbol->first.c_str(),
+        count ? 1 : 0
+      );
+    }
+
+    // Function-level coverage has no line or branch information.
+    if (FunctionCoverageOnly) {
+      fprintf( aFile, "end_of_record\n" );
+      continue;
+    }
+
+    found = 0;
+    hit = 0;
+    for (litr = fitr->second.begin(); litr != fitr->second.end(); litr++) {
+      block = 0;
+      for (bitr = litr->second.branches.begin();
+           bitr != litr->second.branches.end();
+           bitr++, block++) {
+        if (bitr->executed) {
+          fprintf(
+            aFile,
+            "BRDA:%u,%u,0,%u\n"
+            "BRDA:%u,%u,1,%u\n",
+            litr->first, block, bitr->taken,
+            litr->first, block, bitr->notTaken
+          );
+          hit += (bitr->taken ? 1 : 0) + (bitr->notTaken ? 1 : 0);
+        } else {
+          fprintf(
+            aFile,
+            "BRDA:%u,%u,0,-\n"
+            "BRDA:%u,%u,1,-\n",
+            litr->first, block,
+            litr->first, block
+          );
+        }
+        found += 2;
+      }
+    }
+
+    if (found)
+      fprintf( aFile, "BRF:%u\nBRH:%u\n", found, hit );
+
+    found = 0;
+    hit = 0;
+    for (litr = fitr->second.begin(); litr != fitr->second.end(); litr++) {
+      fprintf( aFile, "DA:%u,%u\n", litr->first, litr->second.count );
+      found++;
+      if (litr->second.count)
+        hit++;
+    }
+
+    fprintf(
+      aFile,
+      "LF:%u\n"
+      "LH:%u\n"
+      "end_of_record\n",
+      found,
+      hit
+    );
+  }
+}
+
+}
@@ -0,0 +1,81 @@
+/*! @file ReportsLcov.h
+ *  @brief Reports in lcov Tracefile Format Specification
+ *
+ *  This file contains the specification of the lcov tracefile writer.
+ *  The tracefile lets the coverage results be used by the lcov tools
+ *  such as genhtml.
+ */
+
+#ifndef __REPORTSLCOV_H__
+#define __REPORTSLCOV_H__
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include "ReportsBase.h"
+
+#include "rld-dwarf.h"
+
+namespace Coverage {
+
+/*!
+ *   This class writes an lcov tracefile of the coverage of each symbol.
+ *   The source lines of the instructions are found in the DWARF line
+ *   tables of the executables so no external tools are run.  The
+ *   records of each symbol are written as the symbol is processed so
+ *   only the lines of one symbol are held.  A source file can have
+ *   records from more than one symbol and the lcov tools merge them.
+ *   The line addresses of a relocatable module are not relocated so
+ *   its symbols have no records.
+ */
+class ReportsLcov: public ReportsFile {
+
+  public:
+    ReportsLcov( time_t timestamp );
+    virtual ~ReportsLcov();
+
+   /*!
+    *  This method produces an lcov tracefile with the function, line and
+    *  branch records of each symbol.
+    *
+    *  @param[in] fileName identifies the tracefile name
+    */
+   void WriteTraceFile(
+     const char* const fileName
+   );
+
+  private:
+
+    /*!
+     *  This method returns the DWARF line tables of an executable. The
+     *  tables are loaded the first time they are needed and NULL is
+     *  returned if they cannot be loaded.
+     *
+     *  @param[in] theExecutable identifies the executable
+     */
+    const rld::dwarf::lines* getLines(
+      ExecutableInfo* const theExecutable
+    );
+
+    /*!
+     *  This method writes the records of a symbol.
+     *
+     *  @param[in] aFile identifies the tracefile
+     *  @param[in] symbol is a pointer to the symbol information
+     */
+    void PutSymbolRecords(
+      FILE*                                           aFile,
+      Coverage::DesiredSymbols::symbolSet_t::iterator symbol
+    );
+
+    /*!
+     *  This member variable contains the line tables of each executable
+     *  by file name.
+     */
+    typedef std::map<std::string, rld::dwarf::lines*> lines_t;
+    lines_t lines_m;
+};
+
+}
+
+#endif
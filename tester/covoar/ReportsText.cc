@@ -272,4 +272,50 @@ bool  ReportsText::PutSymbolSummaryLine(
   return true;
 }
 
+bool  ReportsText::PutHotSpotLine(
+  FILE*                                           report,
+  unsigned int                                    number,
+  Coverage::DesiredSymbols::symbolSet_t::iterator symbol,
+  const ObjdumpProcessor::objdumpLine_t*          hottest,
+  uint32_t                                        hottestSamples
+)
+{
+  float samples;
+
+  if ( SymbolsToAnalyze->stats.samples == 0 )
+    samples = 0;
+  else
+    samples = (symbol->second.stats.samples*100.0)/
+              SymbolsToAnalyze->stats.samples;
+
+  fprintf(
+    report,
+    "============================================\n"
+    "Symbol                            : %s\n"
+    "Samples                           : %d\n"
+    "Percentage of Samples             : %.2f\n"
+    "Calls                             : %d\n",
+    symbol->first.c_str(),
+    symbol->second.stats.samples,
+    samples,
+    symbol->second.stats.calls
+  );
+
+  if ( hottest ) {
+    std::string line = hottest->line;
+
+    line.erase( line.find_last_not_of( " \t\r\n" ) + 1 );
+    fprintf(
+      report,
+      "Hottest Instruction Samples       : %d\n"
+      "%s\n",
+      hottestSamples,
+      line.c_str()
+    );
+  }
+
+  fprintf(report, "============================================\n");
+  return true;
+}
+
 }
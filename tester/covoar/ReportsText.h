@@ -117,6 +117,15 @@ class ReportsText: public ReportsBase {
       unsigned int                                    number,
       Coverage::DesiredSymbols::symbolSet_t::iterator symbol
     );
+
+   /* Inherit documentation from base class. */ 
+    virtual bool PutHotSpotLine(
+      FILE*                                           report,
+      unsigned int                                    number,
+      Coverage::DesiredSymbols::symbolSet_t::iterator symbol,
+      const ObjdumpProcessor::objdumpLine_t*          hottest,
+      uint32_t                                        hottestSamples
+    );
 };
 
 }
@@ -62,6 +62,9 @@ Coverage::DesiredSymbols*   SymbolsToAnalyze    = NULL;
 bool                        Verbose             = false;
 const char*                 outputDirectory     = ".";
 bool                        BranchInfoAvailable = false;
+bool                        FunctionCoverageOnly = false;
+bool                        SampledCoverage     = false;
+bool                        LcovTraceFile       = false;
 Target::TargetBase*         TargetInfo          = NULL;
 const char*                 dynamicLibrary      = NULL;
 const char*                 projectName         = NULL;
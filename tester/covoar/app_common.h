@@ -13,6 +13,9 @@ extern Coverage::DesiredSymbols*    SymbolsToAnalyze;
 extern bool                         Verbose;
 extern const char*                  outputDirectory;
 extern bool                         BranchInfoAvailable;
+extern bool                         FunctionCoverageOnly;
+extern bool                         SampledCoverage;
+extern bool                         LcovTraceFile;
 extern Target::TargetBase*          TargetInfo;
 extern const char*                  dynamicLibrary;
 extern const char*                  projectName;
@@ -10,7 +10,9 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <iostream>
 #include <list>
+#include <sstream>
 
 #include "app_common.h"
 #include "CoverageFactory.h"
@@ -66,22 +68,79 @@ void usage()
             << " -v                  - verbose output" << std::endl
             << " -T TARGET           - architecture target name" << std::endl
             << " -f FORMAT           - simulator format " << std::endl
-            << "(RTEMS, QEMU, TSIM or Skyeye)" << std::endl
+            << "(RTEMS, RTLD, QEMU, TSIM, Skyeye, drcov or gmon)" << std::endl
             << " -E EXPLANATIONS     - file of explanations" << std::endl
             << " -s SYMBOLS_FILE     - symbols of interest" << std::endl
             << " -S SYMBOL_SET_FILE  - path to symbol_sets.cfg" << std::endl
             << " -1 EXECUTABLE       - executable to get symbols from"
             << std::endl
+            << " -L LIBRARY          - dynamic library loaded by the executable"
+            << std::endl
+            << " -M MODULE_MANIFEST  - file of modules and load addresses"
+            << std::endl
             << " -e EXE_EXTENSION    - suffix for executables" << std::endl
             << " -c COVERAGEFILE_EXT - coverage file suffix" << std::endl
             << " -g GCNOS_LIST       - list of *.gcno files" << std::endl
             << " -p PROJECT_NAME     - name of the project" << std::endl
             << " -O Output_Directory - output directory default=." << std::endl
+            << " -l                  - write an lcov tracefile, coverage.info"
+            << std::endl
             << " -d debug            - disable cleaning of tempfiles."
             << std::endl
+            << " -A                  - accumulate, read EXECUTABLE [COVERAGE]"
+            << std::endl
+            << "                       lines from stdin as they are available"
+            << std::endl
+            << "                       and report when stdin is closed"
+            << std::endl
             << std::endl;
 }
 
+/*
+ *  Prepare an executable for analysis.
+ */
+static void
+prepareExecutable(
+  Coverage::ExecutableInfo* const executableInfo,
+  const char* const               moduleManifest,
+  rld::process::tempfile&         objdumpFile,
+  rld::process::tempfile&         err
+)
+{
+  if ( Verbose )
+    std::cout << "Extracting information from " + executableInfo->getFileName()
+              << std::endl;
+ /*
+  * If a dynamic library was specified, determine the load address.
+  */
+  if ( dynamicLibrary )
+    executableInfo->setLoadAddress(
+      objdumpProcessor->determineLoadAddress( executableInfo )
+    );
+ /*
+  * Load the objdump for the symbols in this executable.
+  */
+  objdumpProcessor->load( executableInfo, objdumpFile, err );
+
+ /*
+  * If a module manifest was specified, load the objdump for the
+  * symbols in each module at the module's load address.
+  */
+  if ( moduleManifest ) {
+    Coverage::ExecutableInfo::modules_t::iterator mitr;
+
+    executableInfo->loadModuleManifest( moduleManifest );
+    for ( mitr = executableInfo->getModules().begin();
+          mitr != executableInfo->getModules().end();
+          mitr++ ) {
+      if ( Verbose )
+        std::cout << "Extracting information from module "
+                  << (*mitr)->getLibraryName() << std::endl;
+      objdumpProcessor->load( *mitr, objdumpFile, err );
+    }
+  }
+}
+
 static void
 fatal_signal( int signum )
 {
@@ -134,21 +193,24 @@ int main(
     int                                            i;
     int                                            opt;
     const char*                                    singleExecutable = NULL;
+    const char*                                    moduleManifest = NULL;
     std::string                                    option;
     rld::process::tempfile                         objdumpFile( ".dmp" );
     rld::process::tempfile                         err( ".err" );
     rld::process::tempfile                         syms( ".syms" );
     bool                                           debug = false;
+    bool                                           accumulate = false;
 
    /*
     * Process command line options.
     */
     progname = argv[0];
 
-    while ( (opt = getopt( argc, argv, "C:1:L:e:c:g:E:f:s:S:T:O:p:v:d" )) != -1 ) {
+    while ( (opt = getopt( argc, argv, "C:1:L:M:e:c:g:E:f:s:S:T:O:p:v:dlA" )) != -1 ) {
       switch( opt ) {
         case '1': singleExecutable      = optarg; break;
         case 'L': dynamicLibrary        = optarg; break;
+        case 'M': moduleManifest        = optarg; break;
         case 'e': executableExtension   = optarg; break;
         case 'c': coverageFileExtension = optarg; break;
         case 'g': gcnosFileName         = optarg; break;
@@ -161,6 +223,8 @@ int main(
         case 'v': Verbose               = true;   break;
         case 'p': projectName           = optarg; break;
         case 'd': debug                 = true;   break;
+        case 'l': LcovTraceFile         = true;   break;
+        case 'A': accumulate            = true;   break;
         default: /* '?' */
           usage();
           exit( -1 );
@@ -322,7 +386,11 @@ int main(
    /*
     * Ensure that there is at least one executable to process.
     */
-    if ( executablesToAnalyze.empty() ) {
+    if ( accumulate && singleExecutable ) {
+      throw rld::error( "accumulate cannot be used with a single executable",
+                         "covoar cmd line arguments" );
+    }
+    if ( executablesToAnalyze.empty() && !accumulate ) {
       throw rld::error( "no executables to analyse",
                          "covoar cmd line arguments" );
     }
@@ -399,12 +467,21 @@ int main(
    /*
     * Create coverage map reader.
     */
+    coverageFormat = Coverage::CoverageFormatToEnum( format );
     coverageReader = Coverage::CreateCoverageReader( coverageFormat );
     if ( !coverageReader ) {
       throw rld::error( "Unable to create coverage file reader",
                         "CreateCoverageReader" );
     }
 
+   /*
+    * The RTLD format only records the functions entered and the gmon
+    * format is a sampled histogram.
+    */
+    FunctionCoverageOnly =
+      ( coverageFormat == Coverage::COVERAGE_FORMAT_RTLD );
+    SampledCoverage = ( coverageFormat == Coverage::COVERAGE_FORMAT_GMON );
+
    /*
     * Create the objdump processor.
     */
@@ -416,20 +493,7 @@ int main(
     for ( eitr = executablesToAnalyze.begin();
           eitr != executablesToAnalyze.end();
           eitr++ ) {
-      if ( Verbose )
-        std::cout << "Extracting information from " + (*eitr)->getFileName()
-                  << std::endl;
-     /*
-      * If a dynamic library was specified, determine the load address.
-      */
-      if ( dynamicLibrary )
-        (*eitr)->setLoadAddress(
-          objdumpProcessor->determineLoadAddress( *eitr )
-        );
-     /*
-      * Load the objdump for the symbols in this executable.
-      */
-      objdumpProcessor->load( *eitr, objdumpFile, err );
+      prepareExecutable( *eitr, moduleManifest, objdumpFile, err );
     }
 
    /*
@@ -461,6 +525,75 @@ int main(
         eitr++;
     }
 
+   /*
+    * In accumulate mode the desired symbols and the analysis of each
+    * executable stay resident while the executables are read from the
+    * standard input. Each line is an executable and optionally its
+    * coverage file. The coverage is processed as each executable is read
+    * so it overlaps with the tests being run and the reports are
+    * generated when the input is closed.
+    */
+    if ( accumulate ) {
+      std::string line;
+
+      while ( std::getline( std::cin, line ) ) {
+        std::istringstream iss( line );
+        std::string        executableName;
+
+        if ( !(iss >> executableName) || (executableName[0] == '#') )
+          continue;
+
+        if ( !(iss >> coverageFileName) ) {
+          size_t extensionLength = strlen( executableExtension );
+          if ( (executableName.length() < extensionLength) ||
+               (executableName.compare(
+                  executableName.length() - extensionLength,
+                  extensionLength,
+                  executableExtension ) != 0) ) {
+            std::cout << "warning: executable does not end in "
+                      << executableExtension << ": "
+                      << executableName << std::endl;
+            continue;
+          }
+          coverageFileName = executableName;
+          coverageFileName.replace(
+            coverageFileName.length() - executableExtensionLength,
+            executableExtensionLength,
+            coverageFileExtension
+          );
+        }
+
+        if ( !FileIsReadable( executableName.c_str() ) ) {
+          std::cout << "warning: executable is not readable: "
+                    << executableName << std::endl;
+          continue;
+        }
+        if ( !FileIsReadable( coverageFileName.c_str() ) ) {
+          std::cout << "warning: coverage file is not readable: "
+                    << coverageFileName << std::endl;
+          continue;
+        }
+
+        executableInfo =
+          new Coverage::ExecutableInfo( executableName.c_str() );
+        executablesToAnalyze.push_back( executableInfo );
+        coverageFileNames.push_back( coverageFileName );
+
+        prepareExecutable( executableInfo, moduleManifest, objdumpFile, err );
+
+        if ( Verbose )
+          std::cout << "Processing coverage file " << coverageFileName
+                    << " for executable " << executableName << std::endl;
+        coverageReader->processFile( coverageFileName.c_str(), executableInfo );
+        executableInfo->mergeCoverage();
+      }
+
+      if ( executablesToAnalyze.empty() ) {
+        throw rld::error( "no executables to analyse",
+                           "covoar accumulate input" );
+      }
+    }
+
    /*
     * Do necessary preprocessing of uncovered ranges and branches
     */
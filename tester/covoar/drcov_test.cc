@@ -0,0 +1,208 @@
+/*! @file drcov_test.cc
+ *  @brief Check the drcov coverage reader
+ *
+ *  This file contains a host check that reads the drcov fixtures in the
+ *  drcov directory and checks the addresses the reader marks as executed.
+ *
+ *  The executable is ticker.exe with the symbols sym_a at 0x1000 and
+ *  sym_b at 0x1010. It loads the module libm.so with the symbol sym_m
+ *  at 0x3000. Each symbol is 16 bytes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "app_common.h"
+#include "CoverageMapBase.h"
+#include "CoverageReaderDrcov.h"
+#include "ExecutableInfo.h"
+#include "SymbolTable.h"
+
+/*
+ *  The number of failed checks.
+ */
+static int failures = 0;
+
+/*
+ *  The directory of the fixtures.
+ */
+static std::string fixtures;
+
+/*
+ *  Add a symbol and its coverage map to an executable or module.
+ */
+static void addSymbol(
+  Coverage::ExecutableInfo* const info,
+  const char* const               symbol,
+  uint32_t                        start
+)
+{
+  info->getSymbolTable()->addSymbol( symbol, start, 16 );
+  info->createCoverageMap( info->getFileName(), symbol, start, start + 15 );
+}
+
+/*
+ *  Create the executable and its module.
+ */
+static Coverage::ExecutableInfo* createExecutable( void )
+{
+  Coverage::ExecutableInfo* executable;
+  Coverage::ExecutableInfo* module;
+
+  executable = new Coverage::ExecutableInfo( "ticker.exe" );
+  addSymbol( executable, "sym_a", 0x1000 );
+  addSymbol( executable, "sym_b", 0x1010 );
+
+  module = new Coverage::ExecutableInfo( "ticker.exe", "libm.so" );
+  addSymbol( module, "sym_m", 0x3000 );
+  executable->addModule( module );
+
+  return executable;
+}
+
+/*
+ *  Read a fixture into a new executable.
+ */
+static Coverage::ExecutableInfo* readFixture( const char* const name )
+{
+  Coverage::CoverageReaderDrcov reader;
+  Coverage::ExecutableInfo*     executable = createExecutable();
+  std::string                   file = fixtures + "/" + name;
+
+  reader.processFile( file.c_str(), executable );
+  return executable;
+}
+
+/*
+ *  Check the addresses from low to high are or are not marked as executed.
+ */
+static void checkMarked(
+  const char* const         fixture,
+  Coverage::ExecutableInfo* executable,
+  uint32_t                  low,
+  uint32_t                  high,
+  bool                      executed
+)
+{
+  Coverage::CoverageMapBase* aCoverageMap;
+  uint32_t                   address;
+
+  for (address = low; address <= high; address++) {
+    aCoverageMap = executable->getCoverageMap( address );
+    if (!aCoverageMap) {
+      fprintf( stderr, "FAIL: %s: 0x%08x has no coverage map\n",
+               fixture, address );
+      failures++;
+      continue;
+    }
+    if (aCoverageMap->wasExecuted( address ) != executed) {
+      fprintf( stderr, "FAIL: %s: 0x%08x is %s\n",
+               fixture, address, executed ? "not executed" : "executed" );
+      failures++;
+    }
+  }
+}
+
+/*
+ *  Check a fixture with an invalid module table makes the reader fail.
+ */
+static void checkFails( const char* const fixture )
+{
+  pid_t pid;
+  int   status;
+
+  fflush( stdout );
+  fflush( stderr );
+
+  pid = fork();
+  if (pid < 0) {
+    perror( "fork" );
+    exit( 1 );
+  }
+
+  if (pid == 0) {
+    freopen( "/dev/null", "w", stderr );
+    delete readFixture( fixture );
+    _exit( 0 );
+  }
+
+  if (waitpid( pid, &status, 0 ) != pid) {
+    perror( "waitpid" );
+    exit( 1 );
+  }
+
+  if (WIFEXITED( status ) && (WEXITSTATUS( status ) == 0)) {
+    fprintf( stderr, "FAIL: %s: read without an error\n", fixture );
+    failures++;
+  }
+}
+
+int main( int argc, char** argv )
+{
+  Coverage::ExecutableInfo* executable;
+
+  if (argc != 2) {
+    fprintf( stderr, "usage: %s fixtures-directory\n", argv[0] );
+    return 2;
+  }
+
+  fixtures = argv[1];
+
+  //
+  // A table with a columns line using start for the base. The block of
+  // module 1 is beyond the count of 1 and is skipped.
+  //
+  executable = readFixture( "columns.log" );
+  checkMarked( "columns.log", executable, 0x1000, 0x1003, true );
+  checkMarked( "columns.log", executable, 0x1004, 0x101f, false );
+  delete executable;
+
+  //
+  // A legacy table without a columns line.
+  //
+  executable = readFixture( "legacy.log" );
+  checkMarked( "legacy.log", executable, 0x1000, 0x1003, false );
+  checkMarked( "legacy.log", executable, 0x1004, 0x1005, true );
+  checkMarked( "legacy.log", executable, 0x1006, 0x101f, false );
+  delete executable;
+
+  //
+  // Three modules. The libc.so module is not analyzed so its block at
+  // 0x1008 is skipped. The libm.so module is matched by the library name.
+  //
+  executable = readFixture( "multi.log" );
+  checkMarked( "multi.log", executable, 0x1000, 0x1001, true );
+  checkMarked( "multi.log", executable, 0x1002, 0x101f, false );
+  checkMarked( "multi.log", executable, 0x3000, 0x3003, false );
+  checkMarked( "multi.log", executable, 0x3004, 0x3007, true );
+  checkMarked( "multi.log", executable, 0x3008, 0x300f, false );
+  delete executable;
+
+  //
+  // A module table entry with an id beyond the count is an error.
+  //
+  checkFails( "badid.log" );
+
+  //
+  // A block at the end of sym_a crosses into sym_b.
+  //
+  executable = readFixture( "cross.log" );
+  checkMarked( "cross.log", executable, 0x1000, 0x100b, false );
+  checkMarked( "cross.log", executable, 0x100c, 0x1013, true );
+  checkMarked( "cross.log", executable, 0x1014, 0x101f, false );
+  delete executable;
+
+  if (failures) {
+    fprintf( stderr, "drcov test: %d failures\n", failures );
+    return 1;
+  }
+
+  printf( "drcov test: pass\n" );
+  return 0;
+}
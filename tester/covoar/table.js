@@ -1000,3 +1000,290 @@ var Table = (function(){
 
 	return table;
 })();
+
+/**
+ * VirtualTable
+ * Renders the report tables covoar writes as a JSON payload. The payload has
+ * the columns, the rows and the rows in ascending order for each column so
+ * sorting is a walk over an order and never compares rows in the browser.
+ * Only the rows in view plus a few either side are in the document, the rows
+ * above and below are spacers so large reports open and scroll quickly.
+ *
+ * The payload is a script element of type application/json in a div with
+ * the class table-virtual:
+ *
+ *   {"columns":[{"title":"Size","type":"numeric","filter":false}, ...],
+ *    "rows":[[cell, ...], ...],
+ *    "order":[[row, ...], ...]}
+ *
+ * A cell is a number, a string or a [text, link] pair. A new line in the
+ * text is a line break.
+ */
+var VirtualTable = (function(){
+	var vt = {};
+
+	// The number of rows rendered above and below the visible rows.
+	vt.Overscan = 20;
+	// The row height used until a row has been rendered and measured.
+	vt.DefaultRowHeight = 24;
+
+	vt.ScrollClassName = "table-virtual-scroll";
+	vt.CountClassName = "table-virtual-count";
+	vt.SortableClassName = "table-sortable";
+	vt.SortedAscendingClassName = "table-sorted-asc";
+	vt.SortedDescendingClassName = "table-sorted-desc";
+	vt.FilteredClassName = "table-filtered";
+	vt.StripeClassName = "covoar-tr-odd";
+
+	var hasClass = function(o,name) {
+		return new RegExp("(^|\\s)"+name+"(\\s|$)").test(o.className);
+	};
+
+	var cellText = function(v) {
+		if (v instanceof Array) { return String(v[0]); }
+		return String(v);
+	};
+
+	var setCell = function(td,v) {
+		var parent = td;
+		var lines = cellText(v).split("\n");
+		var i;
+		td.className = "covoar-td";
+		td.align = "center";
+		if (v instanceof Array) {
+			parent = document.createElement("a");
+			parent.href = v[1];
+			td.appendChild(parent);
+		}
+		for (i=0; i<lines.length; i++) {
+			if (i>0) { parent.appendChild(document.createElement("br")); }
+			parent.appendChild(document.createTextNode(lines[i]));
+		}
+	};
+
+	var spacer = function(t,height) {
+		var tr = document.createElement("tr");
+		var td = document.createElement("td");
+		td.colSpan = t.data.columns.length;
+		td.style.height = height+"px";
+		td.style.padding = "0";
+		td.style.border = "0";
+		tr.appendChild(td);
+		return tr;
+	};
+
+	/**
+	 * Set the classes of the column headers from the sort and the filters.
+	 */
+	var setHeaders = function(t) {
+		var c, cls;
+		for (c=0; c<t.headers.length; c++) {
+			cls = vt.SortableClassName;
+			if (c==t.sortColumn) {
+				cls += " "+(t.descending ? vt.SortedDescendingClassName : vt.SortedAscendingClassName);
+			}
+			if (t.filters[c]!=null) {
+				cls += " "+vt.FilteredClassName;
+			}
+			t.headers[c].className = cls;
+		}
+	};
+
+	/**
+	 * Build the view, the rows that pass the filters in the sort order.
+	 */
+	vt.update = function(t) {
+		var order = t.data.order[t.sortColumn];
+		var rows = t.data.rows;
+		var filtered = [];
+		var view = [];
+		var c, i, r, n, keep;
+		for (c=0; c<t.filters.length; c++) {
+			if (t.filters[c]!=null) { filtered.push(c); }
+		}
+		n = order.length;
+		for (i=0; i<n; i++) {
+			r = order[t.descending ? n-1-i : i];
+			keep = true;
+			for (c=0; keep && c<filtered.length; c++) {
+				keep = cellText(rows[r][filtered[c]])==t.filters[filtered[c]];
+			}
+			if (keep) { view.push(r); }
+		}
+		t.view = view;
+		t.count.innerHTML = view.length+" of "+rows.length+" rows";
+		setHeaders(t);
+		t.scroller.scrollTop = 0;
+		vt.render(t);
+	};
+
+	/**
+	 * Render the rows in view.
+	 */
+	vt.render = function(t) {
+		var rh = t.rowHeight || vt.DefaultRowHeight;
+		var top = t.scroller.scrollTop;
+		var height = t.scroller.clientHeight || 600;
+		var first = Math.max(0, Math.floor(top/rh)-vt.Overscan);
+		var last = Math.min(t.view.length, Math.ceil((top+height)/rh)+vt.Overscan);
+		var tbody = document.createElement("tbody");
+		var rendered = [];
+		var i, c, tr, td, row, total;
+		tbody.appendChild(spacer(t, first*rh));
+		for (i=first; i<last; i++) {
+			row = t.data.rows[t.view[i]];
+			tr = document.createElement("tr");
+			if (i%2!=0) { tr.className = vt.StripeClassName; }
+			for (c=0; c<t.data.columns.length; c++) {
+				td = document.createElement("td");
+				if (c<row.length) { setCell(td, row[c]); }
+				tr.appendChild(td);
+			}
+			tbody.appendChild(tr);
+			rendered.push(tr);
+		}
+		tbody.appendChild(spacer(t, (t.view.length-last)*rh));
+		t.table.replaceChild(tbody, t.tbody);
+		t.tbody = tbody;
+		// Measure the rows once and render again with the real height.
+		if (!t.rowHeight && rendered.length>0) {
+			total = 0;
+			for (i=0; i<rendered.length; i++) { total += rendered[i].offsetHeight; }
+			if (total>0) {
+				t.rowHeight = total/rendered.length;
+				vt.render(t);
+			}
+		}
+	};
+
+	/**
+	 * Sort by a column. Sorting the sorted column again reverses the order.
+	 */
+	vt.sort = function(t,column) {
+		if (column==t.sortColumn) {
+			t.descending = !t.descending;
+		}
+		else {
+			t.sortColumn = column;
+			t.descending = false;
+		}
+		vt.update(t);
+	};
+
+	/**
+	 * Filter a column by a value, null removes the filter.
+	 */
+	vt.filter = function(t,column,value) {
+		t.filters[column] = value;
+		vt.update(t);
+	};
+
+	var filterSelect = function(t,column) {
+		var select = document.createElement("select");
+		var order = t.data.order[column];
+		var rows = t.data.rows;
+		var option, i, text, last = null;
+		select.className = "table-autofilter";
+		select.options[0] = new Option("All", "");
+		// The order has equal values together so the values are unique.
+		for (i=0; i<order.length; i++) {
+			text = cellText(rows[order[i]][column]);
+			if (text!==last) {
+				option = new Option(text, text);
+				select.options[select.options.length] = option;
+				last = text;
+			}
+		}
+		select.onclick = function(e) {
+			if (e) { e.stopPropagation(); } else { window.event.cancelBubble = true; }
+		};
+		select.onchange = function() {
+			var value = select.options[select.selectedIndex].value;
+			vt.filter(t, column, select.selectedIndex==0 ? null : value);
+		};
+		return select;
+	};
+
+	/**
+	 * Create the table from the payload in the container.
+	 */
+	vt.create = function(container) {
+		var scripts = container.getElementsByTagName("script");
+		var t, thead, tr, th, c, col, pending = false;
+		if (scripts.length==0) { return null; }
+		t = {
+			data:JSON.parse(scripts[0].text || scripts[0].textContent),
+			sortColumn:0,
+			descending:false,
+			filters:[],
+			headers:[],
+			view:[],
+			rowHeight:0
+		};
+		t.count = document.createElement("div");
+		t.count.className = vt.CountClassName;
+		t.scroller = document.createElement("div");
+		t.scroller.className = vt.ScrollClassName;
+		t.table = document.createElement("table");
+		t.table.className = "covoar";
+		thead = document.createElement("thead");
+		tr = document.createElement("tr");
+		for (c=0; c<t.data.columns.length; c++) {
+			col = t.data.columns[c];
+			th = document.createElement("th");
+			th.align = "left";
+			th.innerHTML = col.title;
+			th.onclick = (function(column) {
+				return function() { vt.sort(t, column); };
+			})(c);
+			if (col.filter) {
+				th.appendChild(document.createElement("br"));
+				th.appendChild(filterSelect(t, c));
+			}
+			t.filters.push(null);
+			t.headers.push(th);
+			tr.appendChild(th);
+		}
+		thead.appendChild(tr);
+		t.table.appendChild(thead);
+		t.tbody = document.createElement("tbody");
+		t.table.appendChild(t.tbody);
+		t.scroller.appendChild(t.table);
+		t.scroller.onscroll = function() {
+			if (pending) { return; }
+			pending = true;
+			var draw = function() { pending = false; vt.render(t); };
+			if (window.requestAnimationFrame) { window.requestAnimationFrame(draw); }
+			else { setTimeout(draw, 16); }
+		};
+		container.removeChild(scripts[0]);
+		container.appendChild(t.count);
+		container.appendChild(t.scroller);
+		vt.update(t);
+		return t;
+	};
+
+	/**
+	 * Create the tables in the document.
+	 */
+	vt.auto = function() {
+		var divs = document.getElementsByTagName("div");
+		var containers = [];
+		var i;
+		for (i=0; i<divs.length; i++) {
+			if (hasClass(divs[i], "table-virtual")) { containers.push(divs[i]); }
+		}
+		for (i=0; i<containers.length; i++) {
+			vt.create(containers[i]);
+		}
+	};
+
+	if (window.addEventListener) {
+		window.addEventListener( "load", vt.auto, false );
+	}
+	else if (window.attachEvent) {
+		window.attachEvent( "onload", vt.auto );
+	}
+
+	return vt;
+})();
@@ -40,6 +40,12 @@ from . import options
 
 import shutil
 import os
+import threading
+
+try:
+    import queue
+except ImportError:
+    import Queue as queue
 
 class summary:
     def __init__(self, p_summary_dir):
@@ -285,27 +291,81 @@ class covoar(object):
         self.explanations_txt = macros.expand(config_map['explanations'][2])
         self.coverage_extension = config_map['coverage_extension'][2]
         self.project_name = config_map['project_name'][2]
+        self.set_name = None
+        self.inputs = None
+        self.closed = True
+        self.thread = None
+        self.exit_code = None
 
-    def run(self, set_name, symbol_file):
+    def _command(self, set_name, symbol_file):
         covoar_result_dir = path.join(self.base_result_dir, set_name)
         if (not path.exists(covoar_result_dir)):
             path.mkdir(covoar_result_dir)
         if (not path.exists(symbol_file)):
             raise error.general('symbol set file: coverage/%s.symcfg was not created for covoar, skipping %s' % (symbol_file, set_name))
-        command = ('covoar -S ' + symbol_file
-                  + ' -O ' + covoar_result_dir + ' -f' + self.simulator_format
-                  + ' -T' + self.target_arch + ' -E' + self.explanations_txt
-                  + ' -c' + self.coverage_extension
-                  + ' -e' + self.executable_extension
-                  + ' -p' + self.project_name + ' ' + self.executables)
+        return ('covoar -S ' + symbol_file
+                + ' -O ' + covoar_result_dir + ' -f' + self.simulator_format
+                + ' -T' + self.target_arch + ' -E' + self.explanations_txt
+                + ' -c' + self.coverage_extension
+                + ' -e' + self.executable_extension
+                + ' -p' + self.project_name)
+
+    def run(self, set_name, symbol_file):
+        command = self._command(set_name, symbol_file) + ' ' + self.executables
         log.notice('Running covoar for %s' % (set_name))
         executor = execute.execute(verbose = True, output = self.output_handler)
         exit_code = executor.shell(command, cwd=os.getcwd())
-        if (exit_code[0] != 0):
-            raise error.general('covoar failure exit code: %d' % (exit_code[0]))
+        self._check_exit_code(set_name, exit_code[0])
+
+    def start(self, set_name, symbol_file):
+        '''
+        Start covoar in accumulate mode. Executables are passed to covoar as
+        their tests finish and the reports are generated by finish().
+        '''
+        command = self._command(set_name, symbol_file) + ' -A'
+        log.notice('Starting covoar for %s' % (set_name))
+        self.set_name = set_name
+        self.inputs = queue.Queue()
+        self.closed = False
+        executor = execute.execute(verbose = True,
+                                   output = self.output_handler,
+                                   input = self.input_handler)
+        self.thread = threading.Thread(target = self._runner,
+                                       name = 'covoar[%s]' % (set_name),
+                                       args = (executor, command))
+        self.thread.daemon = True
+        self.thread.start()
+
+    def add(self, executable):
+        if not self.closed:
+            self.inputs.put(executable + os.linesep)
+
+    def close(self):
+        '''
+        Close covoar's input so it generates the reports.
+        '''
+        if not self.closed:
+            self.inputs.put(None)
+            self.closed = True
+
+    def finish(self):
+        self.close()
+        self.thread.join()
+        self._check_exit_code(self.set_name, self.exit_code)
+
+    def _runner(self, executor, command):
+        exit_code = executor.shell(command, cwd=os.getcwd())
+        self.exit_code = exit_code[0]
+
+    def _check_exit_code(self, set_name, exit_code):
+        if (exit_code != 0):
+            raise error.general('covoar failure exit code: %d' % (exit_code))
         log.notice('Coverage run for %s finished successfully.' % (set_name))
         log.notice('-----------------------------------------------')
 
+    def input_handler(self):
+        return self.inputs.get()
+
     def output_handler(self, text):
         log.notice('%s' % (text))
 
@@ -333,6 +393,7 @@ class coverage_run(object):
         self.symbol_config = symbols_configuration()
         self.no_clean = int(self.macros['_no_clean'])
         self.report_format = self.config_map['report_format'][2]
+        self.covoars = []
 
     def prepare_environment(self):
         symbol_set_files = []
@@ -353,17 +414,43 @@ class coverage_run(object):
                 log.notice('Invalid symbol set %s in symbol_sets.cfg. skipping covoar run.' % (sset.name))
         log.notice('Coverage environment prepared')
 
+    def start(self):
+        '''
+        Start a covoar for each symbol set that accumulates the coverage of
+        the executables as their tests finish.
+        '''
+        for sset in self.symbol_config.symbol_sets:
+            symbol_set_file = (path.join(self.traces_dir,
+                                         sset.name + '.symcfg'))
+            covoar_obj = covoar(self.test_dir, self.symbol_config_path,
+                                self.traces_dir, [],
+                                self.config_map, self.macros)
+            covoar_obj.start(sset.name, symbol_set_file)
+            self.covoars.append(covoar_obj)
+
+    def add(self, executable):
+        for covoar_obj in self.covoars:
+            covoar_obj.add(executable)
+
     def run(self):
         try:
             if self.executables is None:
                 raise error.general('no test executables provided.')
-            for sset in self.symbol_config.symbol_sets:
-                symbol_set_file = (path.join(self.traces_dir,
-                                             sset.name + '.symcfg'))
-                covoar_obj = covoar(self.test_dir, self.symbol_config_path,
-                                    self.traces_dir, self.executables,
-                                    self.config_map, self.macros)
-                covoar_obj.run(sset.name, symbol_set_file)
+            if len(self.covoars) > 0:
+                covoars = self.covoars
+                self.covoars = []
+                for covoar_obj in covoars:
+                    covoar_obj.close()
+                for covoar_obj in covoars:
+                    covoar_obj.finish()
+            else:
+                for sset in self.symbol_config.symbol_sets:
+                    symbol_set_file = (path.join(self.traces_dir,
+                                                 sset.name + '.symcfg'))
+                    covoar_obj = covoar(self.test_dir, self.symbol_config_path,
+                                        self.traces_dir, self.executables,
+                                        self.config_map, self.macros)
+                    covoar_obj.run(sset.name, symbol_set_file)
             self._generate_reports();
             self._summarize();
         finally:
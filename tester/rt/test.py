@@ -312,6 +312,7 @@ def run(command_path = None):
         if coverage_enabled:
             coverage = coverage_get_obj(opts, path_to_builddir[1])
             coverage.prepare_environment();
+            coverage.start()
         report_mode = opts.find_arg('--report-mode')
         if report_mode:
             if report_mode[1] != 'failures' and \
@@ -353,6 +354,8 @@ def run(command_path = None):
                         _job_trace(tst, 'dead',
                                    total, exe, tests, reporting)
                     finished += [tst]
+                    if coverage_enabled:
+                        coverage.add(tst.executable)
                     tst.reraise()
                 del dead
                 if len(tests) >= jobs or exe >= total: